@@ -0,0 +1,637 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// A model of the KSZ8851SNL Ethernet controller as seen over its SPI bus, with
+// frames passed to and from a TAP device on the host. Only what the Sonata
+// driver uses is modelled: the register file, the receive and transmit
+// queues with their interrupts, MAC address filtering and checksum offload.
+// The link is always up and frames are sent as soon as they are enqueued.
+
+#include "ksz8851dpi.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/if_tun.h>
+#include <net/if.h>
+#endif
+
+// Registers used by the driver, by byte address.
+#define REG_MARL 0x10
+#define REG_MARM 0x12
+#define REG_MARH 0x14
+#define REG_TXCR 0x70
+#define REG_RXCR1 0x74
+#define REG_RXCR2 0x76
+#define REG_TXMIR 0x78
+#define REG_RXFHSR 0x7c
+#define REG_RXFHBCR 0x7e
+#define REG_TXQCR 0x80
+#define REG_RXQCR 0x82
+#define REG_RXDTTR 0x8c
+#define REG_IER 0x90
+#define REG_ISR 0x92
+#define REG_RXFCTR 0x9c
+#define REG_CIDER 0xc0
+#define REG_P1MBSR 0xe6
+#define REG_P1SR 0xf8
+
+#define TXCR_TCGIP (1 << 5)
+#define TXCR_TCGTCP (1 << 6)
+#define TXCR_TCGUDP (1 << 7)
+#define TXCR_TCGICMP (1 << 8)
+
+#define RXCR1_RXE (1 << 0)
+#define RXCR1_RXAE (1 << 4)
+#define RXCR1_RXME (1 << 6)
+#define RXCR1_RXBE (1 << 7)
+#define RXCR1_RXIPFCC (1 << 12)
+#define RXCR1_RXTCPFCC (1 << 13)
+#define RXCR1_RXUDPFCC (1 << 14)
+#define RXCR2_RXICMPFCC (1 << 1)
+
+#define TXQCR_METFE (1 << 0)
+
+#define RXQCR_RRXEF (1 << 0)
+#define RXQCR_SDA (1 << 3)
+#define RXQCR_ADRFE (1 << 4)
+#define RXQCR_RXFCTE (1 << 5)
+#define RXQCR_RXDTTE (1 << 7)
+
+#define RXFHSR_UCAST (1 << 5)
+#define RXFHSR_MCAST (1 << 6)
+#define RXFHSR_BCAST (1 << 7)
+#define RXFHSR_UDP_ERR (1 << 10)
+#define RXFHSR_TCP_ERR (1 << 11)
+#define RXFHSR_IP_ERR (1 << 12)
+#define RXFHSR_ICMP_ERR (1 << 13)
+#define RXFHSR_RXFV (1 << 15)
+
+#define ISR_RXIS (1 << 13)
+#define ISR_TXIS (1 << 14)
+
+// Queue memory of the chip, and the longest frame handled including its CRC.
+#define TX_MEM_SIZE 6144
+#define RX_MEM_SIZE 12288
+#define MAX_FRAME_LEN 1536
+#define MIN_FRAME_LEN 60
+#define RX_QUEUE_FRAMES 64
+
+// The TAP device is read once every this many clock cycles.
+#define TAP_POLL_CYCLES 256
+
+enum spi_state {
+  SPI_CMD,       // Expecting the first command byte.
+  SPI_REG_ADDR,  // Expecting the second byte of a register command.
+  SPI_REG_DATA,  // Register data.
+  SPI_RXQ,       // Reading the receive queue.
+  SPI_TXQ,       // Writing the transmit queue.
+  SPI_IGNORE,    // Anything after the end of a register access.
+};
+
+struct rx_frame {
+  uint16_t status;
+  uint16_t len;
+  uint8_t data[MAX_FRAME_LEN];
+};
+
+// This keeps the state of the modelled chip.
+struct ksz8851dpi_ctx {
+  char name[64];
+  int tap;
+  int clk_freq;
+
+  uint8_t regs[256];
+
+  enum spi_state state;
+  bool reg_write;
+  uint8_t reg_addr;
+  int lanes[4];
+  int num_lanes;
+  int data_count;
+  uint8_t data[4];
+
+  struct rx_frame rx_queue[RX_QUEUE_FRAMES];
+  int rx_head;
+  int rx_count;
+  int rx_mem;
+  // Bytes of the head frame read since StartDmaAccess was set.
+  uint32_t rx_pos;
+  bool rx_timer_running;
+  uint64_t rx_timer_start;
+
+  // The frame written to the transmit queue, with its control word and byte
+  // count first.
+  uint8_t tx_buf[4 + MAX_FRAME_LEN + 3];
+  uint32_t tx_pos;
+
+  uint64_t cycles;
+};
+
+static uint16_t reg_get(struct ksz8851dpi_ctx *ctx, uint8_t addr) {
+  return ctx->regs[addr & ~1] | (ctx->regs[addr | 1] << 8);
+}
+
+static void reg_put(struct ksz8851dpi_ctx *ctx, uint8_t addr, uint16_t val) {
+  ctx->regs[addr & ~1] = val & 0xff;
+  ctx->regs[addr | 1] = val >> 8;
+}
+
+static int tap_open(const char *name) {
+#ifdef __linux__
+  int fd = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+  if (fd < 0) {
+    return -1;
+  }
+
+  struct ifreq ifr;
+  memset(&ifr, 0, sizeof(ifr));
+  ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+  strncpy(ifr.ifr_name, name, IFNAMSIZ - 1);
+  if (ioctl(fd, TUNSETIFF, &ifr) < 0) {
+    int err = errno;
+    close(fd);
+    errno = err;
+    return -1;
+  }
+  return fd;
+#else
+  errno = ENOTSUP;
+  return -1;
+#endif
+}
+
+static uint32_t csum_add(uint32_t sum, const uint8_t *data, size_t len) {
+  for (size_t i = 0; i + 1 < len; i += 2) {
+    sum += (data[i] << 8) | data[i + 1];
+  }
+  if (len & 1) {
+    sum += data[len - 1] << 8;
+  }
+  return sum;
+}
+
+static uint16_t csum_fold(uint32_t sum) {
+  while (sum >> 16) {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+  return ~sum & 0xffff;
+}
+
+static uint32_t csum_pseudo(const uint8_t *ip, uint8_t proto, uint16_t len) {
+  return csum_add(0, ip + 12, 8) + proto + len;
+}
+
+static uint32_t crc32(const uint8_t *data, size_t len) {
+  uint32_t crc = 0xffffffff;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int b = 0; b < 8; b++) {
+      crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+    }
+  }
+  return ~crc;
+}
+
+// Finds the IPv4 header and the protocol data of an unfragmented IPv4 frame.
+// Returns false for other frames, and for fragments with `l4` set to NULL.
+static bool ipv4_parse(uint8_t *frame, size_t len, uint8_t **ip, uint8_t **l4, uint16_t *l4_len) {
+  if (len < 14 + 20 || frame[12] != 0x08 || frame[13] != 0x00) {
+    return false;
+  }
+
+  *ip = frame + 14;
+  size_t ihl = ((*ip)[0] & 0xf) * 4;
+  size_t total = ((*ip)[2] << 8) | (*ip)[3];
+  if (((*ip)[0] >> 4) != 4 || ihl < 20 || total < ihl || 14 + total > len) {
+    return false;
+  }
+
+  bool fragment = ((*ip)[6] & 0x20) || ((((*ip)[6] & 0x1f) << 8) | (*ip)[7]);
+  *l4 = fragment ? NULL : *ip + ihl;
+  *l4_len = total - ihl;
+  return true;
+}
+
+// Fills in the checksums the transmit control register asks for.
+static void tx_checksum(struct ksz8851dpi_ctx *ctx, uint8_t *frame, size_t len) {
+  uint16_t txcr = reg_get(ctx, REG_TXCR);
+  uint8_t *ip, *l4;
+  uint16_t l4_len;
+  if (!ipv4_parse(frame, len, &ip, &l4, &l4_len)) {
+    return;
+  }
+
+  if (txcr & TXCR_TCGIP) {
+    size_t ihl = (ip[0] & 0xf) * 4;
+    ip[10] = ip[11] = 0;
+    uint16_t sum = csum_fold(csum_add(0, ip, ihl));
+    ip[10] = sum >> 8;
+    ip[11] = sum & 0xff;
+  }
+  if (l4 == NULL) {
+    return;
+  }
+
+  uint8_t proto = ip[9];
+  int offset = -1;
+  uint32_t sum = 0;
+  if (proto == 6 && (txcr & TXCR_TCGTCP) && l4_len >= 20) {
+    offset = 16;
+    sum = csum_pseudo(ip, proto, l4_len);
+  } else if (proto == 17 && (txcr & TXCR_TCGUDP) && l4_len >= 8) {
+    offset = 6;
+    sum = csum_pseudo(ip, proto, l4_len);
+  } else if (proto == 1 && (txcr & TXCR_TCGICMP) && l4_len >= 4) {
+    offset = 2;
+  }
+  if (offset < 0) {
+    return;
+  }
+
+  l4[offset] = l4[offset + 1] = 0;
+  uint16_t l4_sum = csum_fold(csum_add(sum, l4, l4_len));
+  if (proto == 17 && l4_sum == 0) {
+    l4_sum = 0xffff;
+  }
+  l4[offset] = l4_sum >> 8;
+  l4[offset + 1] = l4_sum & 0xff;
+}
+
+// Returns the error bits of the frame status for the checksums the receive
+// control registers ask to be checked.
+static uint16_t rx_checksum(struct ksz8851dpi_ctx *ctx, uint8_t *frame, size_t len) {
+  uint16_t rxcr1 = reg_get(ctx, REG_RXCR1);
+  uint16_t rxcr2 = reg_get(ctx, REG_RXCR2);
+  uint8_t *ip, *l4;
+  uint16_t l4_len;
+  if (!ipv4_parse(frame, len, &ip, &l4, &l4_len)) {
+    return 0;
+  }
+
+  uint16_t errors = 0;
+  if ((rxcr1 & RXCR1_RXIPFCC) && csum_fold(csum_add(0, ip, (ip[0] & 0xf) * 4)) != 0) {
+    errors |= RXFHSR_IP_ERR;
+  }
+  if (l4 == NULL) {
+    return errors;
+  }
+
+  uint8_t proto = ip[9];
+  if (proto == 6 && (rxcr1 & RXCR1_RXTCPFCC)) {
+    if (csum_fold(csum_add(csum_pseudo(ip, proto, l4_len), l4, l4_len)) != 0) {
+      errors |= RXFHSR_TCP_ERR;
+    }
+  } else if (proto == 17 && (rxcr1 & RXCR1_RXUDPFCC) && l4_len >= 8 && (l4[6] | l4[7]) != 0) {
+    if (csum_fold(csum_add(csum_pseudo(ip, proto, l4_len), l4, l4_len)) != 0) {
+      errors |= RXFHSR_UDP_ERR;
+    }
+  } else if (proto == 1 && (rxcr2 & RXCR2_RXICMPFCC)) {
+    if (csum_fold(csum_add(0, l4, l4_len)) != 0) {
+      errors |= RXFHSR_ICMP_ERR;
+    }
+  }
+  return errors;
+}
+
+static int rx_frame_mem(const struct rx_frame *frame) { return (4 + frame->len + 3) & ~3; }
+
+// Whether the data of the head frame, padded to a whole word, has been read
+// since StartDmaAccess was set.
+static bool rx_head_read(struct ksz8851dpi_ctx *ctx) {
+  return ctx->rx_count > 0 && ctx->rx_pos >= 4 + rx_frame_mem(&ctx->rx_queue[ctx->rx_head]);
+}
+
+static void rx_dequeue(struct ksz8851dpi_ctx *ctx) {
+  if (ctx->rx_count == 0) {
+    return;
+  }
+  ctx->rx_mem -= rx_frame_mem(&ctx->rx_queue[ctx->rx_head]);
+  ctx->rx_head = (ctx->rx_head + 1) % RX_QUEUE_FRAMES;
+  ctx->rx_count--;
+  ctx->rx_pos = 0;
+}
+
+// Queues a frame from the host if the receive filter passes it.
+static void rx_frame(struct ksz8851dpi_ctx *ctx, const uint8_t *data, size_t len) {
+  uint16_t rxcr1 = reg_get(ctx, REG_RXCR1);
+  if (!(rxcr1 & RXCR1_RXE) || len < 14 || len + 4 > MAX_FRAME_LEN) {
+    return;
+  }
+
+  uint16_t status = RXFHSR_RXFV;
+  static const uint8_t broadcast[6] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+  uint8_t mac[6] = {
+      ctx->regs[REG_MARH + 1], ctx->regs[REG_MARH], ctx->regs[REG_MARM + 1],
+      ctx->regs[REG_MARM],     ctx->regs[REG_MARL + 1], ctx->regs[REG_MARL],
+  };
+  if (memcmp(data, broadcast, 6) == 0) {
+    if (!(rxcr1 & (RXCR1_RXBE | RXCR1_RXAE))) return;
+    status |= RXFHSR_BCAST;
+  } else if (data[0] & 1) {
+    if (!(rxcr1 & (RXCR1_RXME | RXCR1_RXAE))) return;
+    status |= RXFHSR_MCAST;
+  } else {
+    if (memcmp(data, mac, 6) != 0 && !(rxcr1 & RXCR1_RXAE)) return;
+    status |= RXFHSR_UCAST;
+  }
+
+  struct rx_frame *frame = &ctx->rx_queue[(ctx->rx_head + ctx->rx_count) % RX_QUEUE_FRAMES];
+  size_t padded = len < MIN_FRAME_LEN ? MIN_FRAME_LEN : len;
+  memset(frame->data, 0, padded);
+  memcpy(frame->data, data, len);
+  uint32_t crc = crc32(frame->data, padded);
+  for (int i = 0; i < 4; i++) {
+    frame->data[padded + i] = crc >> (8 * i);
+  }
+  frame->len = padded + 4;
+  frame->status = status | rx_checksum(ctx, frame->data, padded);
+
+  ctx->rx_count++;
+  ctx->rx_mem += rx_frame_mem(frame);
+
+  uint16_t rxqcr = reg_get(ctx, REG_RXQCR);
+  if ((rxqcr & RXQCR_RXFCTE) && ctx->rx_count >= (reg_get(ctx, REG_RXFCTR) & 0xff)) {
+    reg_put(ctx, REG_ISR, reg_get(ctx, REG_ISR) | ISR_RXIS);
+  }
+  if ((rxqcr & RXQCR_RXDTTE) && !ctx->rx_timer_running) {
+    ctx->rx_timer_running = true;
+    ctx->rx_timer_start = ctx->cycles;
+  }
+}
+
+static void rx_poll(struct ksz8851dpi_ctx *ctx) {
+  uint8_t buf[MAX_FRAME_LEN];
+  while (ctx->tap >= 0 && ctx->rx_count < RX_QUEUE_FRAMES && ctx->rx_mem + 4 + MAX_FRAME_LEN <= RX_MEM_SIZE) {
+    ssize_t len = read(ctx->tap, buf, sizeof(buf));
+    if (len <= 0) {
+      break;
+    }
+    rx_frame(ctx, buf, len);
+  }
+}
+
+// Sends the frame in the transmit buffer.
+static void tx_frame(struct ksz8851dpi_ctx *ctx) {
+  uint32_t len = (ctx->tx_buf[2] | (ctx->tx_buf[3] << 8)) & 0x7ff;
+  if (len == 0 || len + 4 > ctx->tx_pos) {
+    fprintf(stderr, "KSZ8851: Enqueued frame of %u bytes with %u written\n", len, ctx->tx_pos);
+    return;
+  }
+
+  uint8_t *frame = ctx->tx_buf + 4;
+  tx_checksum(ctx, frame, len);
+  if (ctx->tap >= 0 && write(ctx->tap, frame, len) != (ssize_t)len) {
+    fprintf(stderr, "KSZ8851: Write to TAP device failed: %s\n", strerror(errno));
+  }
+  reg_put(ctx, REG_ISR, reg_get(ctx, REG_ISR) | ISR_TXIS);
+}
+
+static uint16_t reg_read(struct ksz8851dpi_ctx *ctx, uint8_t addr) {
+  const struct rx_frame *head = ctx->rx_count ? &ctx->rx_queue[ctx->rx_head] : NULL;
+
+  switch (addr & ~1) {
+    case REG_RXFHSR:
+      return head ? head->status : 0;
+    case REG_RXFHBCR:
+      return head ? head->len : 0;
+    case REG_RXFCTR:
+      return ((ctx->rx_count > 0xff ? 0xff : ctx->rx_count) << 8) | (reg_get(ctx, REG_RXFCTR) & 0xff);
+    case REG_TXMIR:
+      return TX_MEM_SIZE;
+    default:
+      return reg_get(ctx, addr);
+  }
+}
+
+static void reg_write(struct ksz8851dpi_ctx *ctx, uint8_t addr, uint16_t val) {
+  uint16_t old = reg_get(ctx, addr);
+
+  switch (addr & ~1) {
+    case REG_ISR:
+      reg_put(ctx, addr, old & ~val);
+      break;
+    case REG_TXQCR:
+      if (val & TXQCR_METFE) {
+        tx_frame(ctx);
+      }
+      reg_put(ctx, addr, val & ~TXQCR_METFE);
+      break;
+    case REG_RXQCR:
+      // A frame leaves the queue either when it has been read out completely
+      // with auto-dequeue on and StartDmaAccess is cleared, or when it is
+      // released with RRXEF. A partly read frame stays at the head.
+      if ((old & RXQCR_SDA) && !(val & RXQCR_SDA) && (val & RXQCR_ADRFE) && rx_head_read(ctx)) {
+        rx_dequeue(ctx);
+      } else if (val & RXQCR_RRXEF) {
+        rx_dequeue(ctx);
+      }
+      if (!(old & RXQCR_SDA) && (val & RXQCR_SDA)) {
+        ctx->rx_pos = 0;
+      }
+      reg_put(ctx, addr, val & ~RXQCR_RRXEF);
+      break;
+    case REG_TXMIR:
+    case REG_RXFHSR:
+    case REG_RXFHBCR:
+    case REG_CIDER:
+    case REG_P1MBSR:
+    case REG_P1SR:
+      break;
+    case REG_RXFCTR:
+      reg_put(ctx, addr, (old & 0xff00) | (val & 0xff));
+      break;
+    default:
+      reg_put(ctx, addr, val);
+      break;
+  }
+}
+
+// Returns the next byte of the receive queue data: a dummy word, the status
+// and byte count of the head frame, then the frame padded to a whole word.
+static uint8_t rxq_read(struct ksz8851dpi_ctx *ctx) {
+  if (ctx->rx_count == 0 || !(reg_get(ctx, REG_RXQCR) & RXQCR_SDA)) {
+    return 0;
+  }
+
+  const struct rx_frame *head = &ctx->rx_queue[ctx->rx_head];
+  uint32_t pos = ctx->rx_pos++;
+  if (pos < 4) {
+    return 0;
+  } else if (pos < 6) {
+    return head->status >> (8 * (pos - 4));
+  } else if (pos < 8) {
+    return head->len >> (8 * (pos - 6));
+  } else if (pos - 8 < head->len) {
+    return head->data[pos - 8];
+  }
+  return 0;
+}
+
+void *ksz8851dpi_create(const char *name, const char *tap_name, int clk_freq) {
+  struct ksz8851dpi_ctx *ctx = (struct ksz8851dpi_ctx *)calloc(1, sizeof(struct ksz8851dpi_ctx));
+  assert(ctx);
+
+  strncpy(ctx->name, name, sizeof(ctx->name) - 1);
+  ctx->clk_freq = clk_freq;
+
+  reg_put(ctx, REG_CIDER, 0x8872);
+  // Link up, auto-negotiation complete, at 100 Mbit/s full duplex.
+  reg_put(ctx, REG_P1MBSR, 0x7869 | (1 << 2) | (1 << 5));
+  reg_put(ctx, REG_P1SR, (1 << 10) | (1 << 9) | (1 << 5));
+
+  ctx->tap = tap_open(tap_name);
+  if (ctx->tap < 0) {
+    printf(
+        "\n"
+        "KSZ8851: Unable to open TAP device %s for %s: %s\n"
+        "Frames sent by the software are dropped. Create the device with, e.g.\n"
+        "$ sudo ip tuntap add dev %s mode tap user $USER\n",
+        tap_name, name, strerror(errno), tap_name);
+  } else {
+    printf("\nKSZ8851: Connected %s to TAP device %s\n", name, tap_name);
+  }
+
+  return (void *)ctx;
+}
+
+void ksz8851dpi_close(void *ctx_void) {
+  struct ksz8851dpi_ctx *ctx = (struct ksz8851dpi_ctx *)ctx_void;
+  if (!ctx) {
+    return;
+  }
+
+  if (ctx->tap >= 0) {
+    close(ctx->tap);
+  }
+  free(ctx);
+}
+
+void ksz8851dpi_select(void *ctx_void) {
+  struct ksz8851dpi_ctx *ctx = (struct ksz8851dpi_ctx *)ctx_void;
+  ctx->state = SPI_CMD;
+}
+
+void ksz8851dpi_deselect(void *ctx_void) {
+  struct ksz8851dpi_ctx *ctx = (struct ksz8851dpi_ctx *)ctx_void;
+  ctx->state = SPI_CMD;
+}
+
+int ksz8851dpi_transfer(void *ctx_void, int copi) {
+  struct ksz8851dpi_ctx *ctx = (struct ksz8851dpi_ctx *)ctx_void;
+  uint8_t byte = copi;
+
+  switch (ctx->state) {
+    case SPI_CMD:
+      switch (byte >> 6) {
+        case 0:
+        case 1:
+          ctx->reg_write = (byte >> 6) == 1;
+          ctx->num_lanes = 0;
+          for (int lane = 0; lane < 4; lane++) {
+            if (byte & (1 << (2 + lane))) {
+              ctx->lanes[ctx->num_lanes++] = lane;
+            }
+          }
+          ctx->reg_addr = (byte & 0x3) << 6;
+          ctx->state = SPI_REG_ADDR;
+          return 0;
+        case 2:
+          ctx->state = SPI_RXQ;
+          return rxq_read(ctx);
+        default:
+          ctx->state = SPI_TXQ;
+          ctx->tx_pos = 0;
+          return 0;
+      }
+
+    case SPI_REG_ADDR:
+      ctx->reg_addr |= (byte >> 4) << 2;
+      ctx->data_count = 0;
+      ctx->state = ctx->num_lanes ? SPI_REG_DATA : SPI_IGNORE;
+      if (!ctx->reg_write) {
+        for (int i = 0; i < ctx->num_lanes; i++) {
+          uint8_t addr = ctx->reg_addr + ctx->lanes[i];
+          ctx->data[i] = reg_read(ctx, addr) >> (8 * (addr & 1));
+        }
+        return ctx->num_lanes ? ctx->data[0] : 0;
+      }
+      return 0;
+
+    case SPI_REG_DATA:
+      if (ctx->reg_write) {
+        ctx->data[ctx->data_count++] = byte;
+        if (ctx->data_count == ctx->num_lanes) {
+          // Apply the bytes written to each half of the word together.
+          for (int half = 0; half < 2; half++) {
+            uint8_t addr = ctx->reg_addr + 2 * half;
+            uint16_t val = reg_get(ctx, addr);
+            bool written = false;
+            for (int i = 0; i < ctx->num_lanes; i++) {
+              if (ctx->lanes[i] / 2 == half) {
+                int shift = 8 * (ctx->lanes[i] & 1);
+                val = (val & ~(0xff << shift)) | (ctx->data[i] << shift);
+                written = true;
+              }
+            }
+            if (written) {
+              reg_write(ctx, addr, val);
+            }
+          }
+          ctx->state = SPI_IGNORE;
+        }
+        return 0;
+      }
+      if (++ctx->data_count < ctx->num_lanes) {
+        return ctx->data[ctx->data_count];
+      }
+      ctx->state = SPI_IGNORE;
+      return 0;
+
+    case SPI_RXQ:
+      return rxq_read(ctx);
+
+    case SPI_TXQ:
+      if (ctx->tx_pos < sizeof(ctx->tx_buf)) {
+        ctx->tx_buf[ctx->tx_pos++] = byte;
+      }
+      return 0;
+
+    default:
+      return 0;
+  }
+}
+
+int ksz8851dpi_tick(void *ctx_void) {
+  struct ksz8851dpi_ctx *ctx = (struct ksz8851dpi_ctx *)ctx_void;
+  if (!ctx) {
+    return 0;
+  }
+
+  ctx->cycles++;
+  if (ctx->cycles % TAP_POLL_CYCLES == 0) {
+    rx_poll(ctx);
+  }
+
+  if (ctx->rx_timer_running) {
+    uint64_t timeout = (uint64_t)reg_get(ctx, REG_RXDTTR) * ctx->clk_freq / 1000000;
+    if (ctx->rx_count == 0) {
+      ctx->rx_timer_running = false;
+    } else if (ctx->cycles - ctx->rx_timer_start >= timeout) {
+      reg_put(ctx, REG_ISR, reg_get(ctx, REG_ISR) | ISR_RXIS);
+      ctx->rx_timer_running = false;
+    }
+  }
+
+  return (reg_get(ctx, REG_ISR) & reg_get(ctx, REG_IER)) != 0;
+}
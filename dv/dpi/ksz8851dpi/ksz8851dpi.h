@@ -0,0 +1,22 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SONATA_DV_DPI_KSZ8851DPI_KSZ8851DPI_H_
+#define SONATA_DV_DPI_KSZ8851DPI_KSZ8851DPI_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void *ksz8851dpi_create(const char *name, const char *tap_name, int clk_freq);
+void ksz8851dpi_close(void *ctx_void);
+void ksz8851dpi_select(void *ctx_void);
+void ksz8851dpi_deselect(void *ctx_void);
+int ksz8851dpi_transfer(void *ctx_void, int copi);
+int ksz8851dpi_tick(void *ctx_void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+#endif  // SONATA_DV_DPI_KSZ8851DPI_KSZ8851DPI_H_
@@ -0,0 +1,96 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// KSZ8851 Ethernet controller on an SPI bus in mode 0, with frames passed to
+// and from a TAP device on the host. The device is named by the
+// `KSZ8851DPI_TAP_<name>` plusarg.
+module ksz8851dpi #(
+  parameter string  NAME = "eth0",
+  parameter integer FREQ = 'x
+)(
+  input  logic clk_i,
+  input  logic rst_ni,
+
+  input  logic sck_i,
+  input  logic cs_ni,
+  input  logic copi_i,
+  output logic cipo_o,
+  output logic irq_no
+);
+  localparam string DEFAULT_TAP = "sonata0";
+
+  import "DPI-C" function
+    chandle ksz8851dpi_create(input string name, input string tap_name, input int clk_freq);
+
+  import "DPI-C" function
+    void ksz8851dpi_close(input chandle ctx);
+
+  import "DPI-C" function
+    void ksz8851dpi_select(input chandle ctx);
+
+  import "DPI-C" function
+    void ksz8851dpi_deselect(input chandle ctx);
+
+  import "DPI-C" function
+    int ksz8851dpi_transfer(input chandle ctx, input int copi);
+
+  import "DPI-C" function
+    int ksz8851dpi_tick(input chandle ctx);
+
+  chandle ctx;
+  string tap_name = DEFAULT_TAP;
+
+  initial begin
+    $value$plusargs({"KSZ8851DPI_TAP_", NAME, "=%s"}, tap_name);
+    ctx = ksz8851dpi_create(NAME, tap_name, FREQ);
+  end
+
+  final begin
+    ksz8851dpi_close(ctx);
+    ctx = null;
+  end
+
+  // The SPI clock may stop between bytes, so the bus is sampled on each clock
+  // and bits are taken on the rising edges of SCK. The host samples CIPO on
+  // the next rising edge, so it changes a clock after each one.
+  logic       sck_q, cs_nq;
+  logic [2:0] bit_count;
+  logic [6:0] rx_bits;
+  logic [7:0] tx_byte;
+
+  assign cipo_o = tx_byte[7];
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      sck_q     <= 1'b0;
+      cs_nq     <= 1'b1;
+      bit_count <= '0;
+      rx_bits   <= '0;
+      tx_byte   <= '0;
+      irq_no    <= 1'b1;
+    end else begin
+      sck_q  <= sck_i;
+      cs_nq  <= cs_ni;
+      irq_no <= !ksz8851dpi_tick(ctx);
+
+      if (cs_nq && !cs_ni) begin
+        ksz8851dpi_select(ctx);
+        bit_count <= '0;
+        tx_byte   <= '0;
+      end else if (!cs_nq && cs_ni) begin
+        ksz8851dpi_deselect(ctx);
+      end else if (!cs_ni && !sck_q && sck_i) begin
+        bit_count <= bit_count + 1'b1;
+        if (bit_count == 3'd7) begin
+          automatic int copi_byte = {rx_bits, copi_i};
+          tx_byte <= 8'(ksz8851dpi_transfer(ctx, copi_byte));
+        end else begin
+          rx_bits <= {rx_bits[5:0], copi_i};
+          tx_byte <= {tx_byte[6:0], 1'b0};
+        end
+      end
+    end
+  end
+
+endmodule
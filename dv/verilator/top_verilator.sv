@@ -27,9 +27,13 @@ module top_verilator (input logic clk_i, rst_ni);
   wire sda0 = sda0_oe ? sda0_o : 1'b1;
   wire sda1 = sda1_oe ? sda1_o : 1'b1;
 
+  // SPI bus of the Ethernet controller, which is on its first chip select line.
+  logic       spi_eth_sck, spi_eth_copi, spi_eth_cipo, spi_eth_irq_n;
+  logic [3:0] spi_eth_cs_n;
+
   wire unused_ = ^{scl0_o, scl0_oe, sda0_o, sda0_oe,
                    scl1_o, scl1_oe, sda1_o, sda1_oe,
-                   uart_aux_tx};
+                   uart_aux_tx, spi_eth_cs_n[3:1]};
 
   // Simplified clocking scheme for simulations.
   wire clk_usb   = clk_i;
@@ -109,31 +113,38 @@ module top_verilator (input logic clk_i, rst_ni);
     .spi_flash_rx_i (0),
     .spi_flash_tx_o ( ),
     .spi_flash_sck_o( ),
+    .spi_flash_cs_no( ),
 
     .spi_lcd_rx_i (0),
     .spi_lcd_tx_o ( ),
     .spi_lcd_sck_o( ),
+    .spi_lcd_cs_no( ),
 
-    .spi_eth_rx_i  (0),
-    .spi_eth_tx_o  ( ),
-    .spi_eth_sck_o ( ),
-    .spi_eth_irq_ni(1'b1),
+    .spi_eth_rx_i  (spi_eth_cipo),
+    .spi_eth_tx_o  (spi_eth_copi),
+    .spi_eth_sck_o (spi_eth_sck),
+    .spi_eth_cs_no (spi_eth_cs_n),
+    .spi_eth_irq_ni(spi_eth_irq_n),
 
     .spi_rp0_rx_i (0),
     .spi_rp0_tx_o ( ),
     .spi_rp0_sck_o( ),
+    .spi_rp0_cs_no( ),
 
     .spi_rp1_rx_i (0),
     .spi_rp1_tx_o ( ),
     .spi_rp1_sck_o( ),
+    .spi_rp1_cs_no( ),
 
     .spi_ard_rx_i (0),
     .spi_ard_tx_o ( ),
     .spi_ard_sck_o( ),
+    .spi_ard_cs_no( ),
 
     .spi_mkr_rx_i (0),
     .spi_mkr_tx_o ( ),
     .spi_mkr_sck_o( ),
+    .spi_mkr_cs_no( ),
 
     .cheri_en_i (EnableCHERI),
     // CHERI output
@@ -203,6 +214,19 @@ module top_verilator (input logic clk_i, rst_ni);
     .rx_i  (uart_sys_tx)
   );
 
+  // Ethernet controller, bridged to a TAP device on the host.
+  ksz8851dpi #(
+    .FREQ ( ClockFrequency )
+  ) u_ksz8851dpi (
+    .clk_i,
+    .rst_ni,
+    .sck_i (spi_eth_sck    ),
+    .cs_ni (spi_eth_cs_n[0]),
+    .copi_i(spi_eth_copi   ),
+    .cipo_o(spi_eth_cipo   ),
+    .irq_no(spi_eth_irq_n  )
+  );
+
   // USB DPI; simulated USB host.
   usbdpi u_usbdpi (
     .clk_i           (clk_usb),
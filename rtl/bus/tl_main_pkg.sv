@@ -17,6 +17,7 @@ package tl_main_pkg;
   localparam logic [31:0] ADDR_SPACE_RGBLED_CTRL = 32'h 80009000;
   localparam logic [31:0] ADDR_SPACE_HW_REV      = 32'h 8000a000;
   localparam logic [31:0] ADDR_SPACE_XADC        = 32'h 8000b000;
+  localparam logic [31:0] ADDR_SPACE_DMA         = 32'h 80002000;
   localparam logic [31:0] ADDR_SPACE_TIMER       = 32'h 80040000;
   localparam logic [31:0] ADDR_SPACE_UART0       = 32'h 80100000;
   localparam logic [31:0] ADDR_SPACE_UART1       = 32'h 80101000;
@@ -46,6 +47,7 @@ package tl_main_pkg;
   localparam logic [31:0] ADDR_MASK_RGBLED_CTRL = 32'h 00000fff;
   localparam logic [31:0] ADDR_MASK_HW_REV      = 32'h 00000fff;
   localparam logic [31:0] ADDR_MASK_XADC        = 32'h 00000fff;
+  localparam logic [31:0] ADDR_MASK_DMA         = 32'h 00000fff;
   localparam logic [31:0] ADDR_MASK_TIMER       = 32'h 0000ffff;
   localparam logic [31:0] ADDR_MASK_UART0       = 32'h 00000fff;
   localparam logic [31:0] ADDR_MASK_UART1       = 32'h 00000fff;
@@ -64,8 +66,8 @@ package tl_main_pkg;
   localparam logic [31:0] ADDR_MASK_USBDEV      = 32'h 00000fff;
   localparam logic [31:0] ADDR_MASK_RV_PLIC     = 32'h 03ffffff;
 
-  localparam int N_HOST   = 2;
-  localparam int N_DEVICE = 28;
+  localparam int N_HOST   = 3;
+  localparam int N_DEVICE = 29;
 
   typedef enum int {
     TlSram = 0,
@@ -79,28 +81,30 @@ package tl_main_pkg;
     TlRgbledCtrl = 8,
     TlHwRev = 9,
     TlXadc = 10,
-    TlTimer = 11,
-    TlUart0 = 12,
-    TlUart1 = 13,
-    TlUart2 = 14,
-    TlUart3 = 15,
-    TlUart4 = 16,
-    TlI2C0 = 17,
-    TlI2C1 = 18,
-    TlSpiFlash = 19,
-    TlSpiLcd = 20,
-    TlSpiEth = 21,
-    TlSpiRp0 = 22,
-    TlSpiRp1 = 23,
-    TlSpiArd = 24,
-    TlSpiMkr = 25,
-    TlUsbdev = 26,
-    TlRvPlic = 27
+    TlDma = 11,
+    TlTimer = 12,
+    TlUart0 = 13,
+    TlUart1 = 14,
+    TlUart2 = 15,
+    TlUart3 = 16,
+    TlUart4 = 17,
+    TlI2C0 = 18,
+    TlI2C1 = 19,
+    TlSpiFlash = 20,
+    TlSpiLcd = 21,
+    TlSpiEth = 22,
+    TlSpiRp0 = 23,
+    TlSpiRp1 = 24,
+    TlSpiArd = 25,
+    TlSpiMkr = 26,
+    TlUsbdev = 27,
+    TlRvPlic = 28
   } tl_device_e;
 
   typedef enum int {
     TlIbexLsu = 0,
-    TlDbgHost = 1
+    TlDbgHost = 1,
+    TlDmaHost = 2
   } tl_host_e;
 
 endpackage
@@ -7,10 +7,11 @@
 //
 // Interconnect
 // ibex_lsu
-//   -> s1n_30
-//     -> sm1_31
+//   -> s1n_32
+//     -> sm1_33
 //       -> sram
-//     -> hyperram
+//     -> sm1_34
+//       -> hyperram
 //     -> rev_tag
 //     -> gpio
 //     -> pwm
@@ -20,6 +21,7 @@
 //     -> rgbled_ctrl
 //     -> hw_rev
 //     -> xadc
+//     -> dma
 //     -> timer
 //     -> uart0
 //     -> uart1
@@ -28,19 +30,46 @@
 //     -> uart4
 //     -> i2c0
 //     -> i2c1
-//     -> spi_flash
-//     -> spi_lcd
-//     -> spi_eth
-//     -> spi_rp0
-//     -> spi_rp1
-//     -> spi_ard
-//     -> spi_mkr
-//     -> asf_32
+//     -> sm1_35
+//       -> spi_flash
+//     -> sm1_36
+//       -> spi_lcd
+//     -> sm1_37
+//       -> spi_eth
+//     -> sm1_38
+//       -> spi_rp0
+//     -> sm1_39
+//       -> spi_rp1
+//     -> sm1_40
+//       -> spi_ard
+//     -> sm1_41
+//       -> spi_mkr
+//     -> asf_42
 //       -> usbdev
 //     -> rv_plic
 // dbg_host
-//   -> sm1_31
+//   -> sm1_33
 //     -> sram
+// dma_host
+//   -> s1n_43
+//     -> sm1_33
+//       -> sram
+//     -> sm1_34
+//       -> hyperram
+//     -> sm1_35
+//       -> spi_flash
+//     -> sm1_36
+//       -> spi_lcd
+//     -> sm1_37
+//       -> spi_eth
+//     -> sm1_38
+//       -> spi_rp0
+//     -> sm1_39
+//       -> spi_rp1
+//     -> sm1_40
+//       -> spi_ard
+//     -> sm1_41
+//       -> spi_mkr
 
 module xbar_main (
   input clk_sys_i,
@@ -53,6 +82,8 @@ module xbar_main (
   output tlul_pkg::tl_d2h_t tl_ibex_lsu_o,
   input  tlul_pkg::tl_h2d_t tl_dbg_host_i,
   output tlul_pkg::tl_d2h_t tl_dbg_host_o,
+  input  tlul_pkg::tl_h2d_t tl_dma_host_i,
+  output tlul_pkg::tl_d2h_t tl_dma_host_o,
 
   // Device interfaces
   output tlul_pkg::tl_h2d_t tl_sram_o,
@@ -77,6 +108,8 @@ module xbar_main (
   input  tlul_pkg::tl_d2h_t tl_hw_rev_i,
   output tlul_pkg::tl_h2d_t tl_xadc_o,
   input  tlul_pkg::tl_d2h_t tl_xadc_i,
+  output tlul_pkg::tl_h2d_t tl_dma_o,
+  input  tlul_pkg::tl_d2h_t tl_dma_i,
   output tlul_pkg::tl_h2d_t tl_timer_o,
   input  tlul_pkg::tl_d2h_t tl_timer_i,
   output tlul_pkg::tl_h2d_t tl_uart0_o,
@@ -123,240 +156,408 @@ module xbar_main (
   logic unused_scanmode;
   assign unused_scanmode = ^scanmode_i;
 
-  tl_h2d_t tl_s1n_30_us_h2d ;
-  tl_d2h_t tl_s1n_30_us_d2h ;
+  tl_h2d_t tl_s1n_32_us_h2d ;
+  tl_d2h_t tl_s1n_32_us_d2h ;
 
 
-  tl_h2d_t tl_s1n_30_ds_h2d [28];
-  tl_d2h_t tl_s1n_30_ds_d2h [28];
+  tl_h2d_t tl_s1n_32_ds_h2d [29];
+  tl_d2h_t tl_s1n_32_ds_d2h [29];
 
   // Create steering signal
-  logic [4:0] dev_sel_s1n_30;
+  logic [4:0] dev_sel_s1n_32;
+
+
+  tl_h2d_t tl_sm1_33_us_h2d [3];
+  tl_d2h_t tl_sm1_33_us_d2h [3];
+
+  tl_h2d_t tl_sm1_33_ds_h2d ;
+  tl_d2h_t tl_sm1_33_ds_d2h ;
+
+
+  tl_h2d_t tl_sm1_34_us_h2d [2];
+  tl_d2h_t tl_sm1_34_us_d2h [2];
+
+  tl_h2d_t tl_sm1_34_ds_h2d ;
+  tl_d2h_t tl_sm1_34_ds_d2h ;
+
+
+  tl_h2d_t tl_sm1_35_us_h2d [2];
+  tl_d2h_t tl_sm1_35_us_d2h [2];
+
+  tl_h2d_t tl_sm1_35_ds_h2d ;
+  tl_d2h_t tl_sm1_35_ds_d2h ;
+
+
+  tl_h2d_t tl_sm1_36_us_h2d [2];
+  tl_d2h_t tl_sm1_36_us_d2h [2];
+
+  tl_h2d_t tl_sm1_36_ds_h2d ;
+  tl_d2h_t tl_sm1_36_ds_d2h ;
+
+
+  tl_h2d_t tl_sm1_37_us_h2d [2];
+  tl_d2h_t tl_sm1_37_us_d2h [2];
+
+  tl_h2d_t tl_sm1_37_ds_h2d ;
+  tl_d2h_t tl_sm1_37_ds_d2h ;
+
+
+  tl_h2d_t tl_sm1_38_us_h2d [2];
+  tl_d2h_t tl_sm1_38_us_d2h [2];
+
+  tl_h2d_t tl_sm1_38_ds_h2d ;
+  tl_d2h_t tl_sm1_38_ds_d2h ;
+
+
+  tl_h2d_t tl_sm1_39_us_h2d [2];
+  tl_d2h_t tl_sm1_39_us_d2h [2];
+
+  tl_h2d_t tl_sm1_39_ds_h2d ;
+  tl_d2h_t tl_sm1_39_ds_d2h ;
+
+
+  tl_h2d_t tl_sm1_40_us_h2d [2];
+  tl_d2h_t tl_sm1_40_us_d2h [2];
+
+  tl_h2d_t tl_sm1_40_ds_h2d ;
+  tl_d2h_t tl_sm1_40_ds_d2h ;
+
+
+  tl_h2d_t tl_sm1_41_us_h2d [2];
+  tl_d2h_t tl_sm1_41_us_d2h [2];
+
+  tl_h2d_t tl_sm1_41_ds_h2d ;
+  tl_d2h_t tl_sm1_41_ds_d2h ;
+
+  tl_h2d_t tl_asf_42_us_h2d ;
+  tl_d2h_t tl_asf_42_us_d2h ;
+  tl_h2d_t tl_asf_42_ds_h2d ;
+  tl_d2h_t tl_asf_42_ds_d2h ;
+
+  tl_h2d_t tl_s1n_43_us_h2d ;
+  tl_d2h_t tl_s1n_43_us_d2h ;
+
+
+  tl_h2d_t tl_s1n_43_ds_h2d [9];
+  tl_d2h_t tl_s1n_43_ds_d2h [9];
+
+  // Create steering signal
+  logic [3:0] dev_sel_s1n_43;
+
+
+
+  assign tl_sm1_33_us_h2d[0] = tl_s1n_32_ds_h2d[0];
+  assign tl_s1n_32_ds_d2h[0] = tl_sm1_33_us_d2h[0];
 
+  assign tl_sm1_34_us_h2d[0] = tl_s1n_32_ds_h2d[1];
+  assign tl_s1n_32_ds_d2h[1] = tl_sm1_34_us_d2h[0];
 
-  tl_h2d_t tl_sm1_31_us_h2d [2];
-  tl_d2h_t tl_sm1_31_us_d2h [2];
+  assign tl_rev_tag_o = tl_s1n_32_ds_h2d[2];
+  assign tl_s1n_32_ds_d2h[2] = tl_rev_tag_i;
 
-  tl_h2d_t tl_sm1_31_ds_h2d ;
-  tl_d2h_t tl_sm1_31_ds_d2h ;
+  assign tl_gpio_o = tl_s1n_32_ds_h2d[3];
+  assign tl_s1n_32_ds_d2h[3] = tl_gpio_i;
 
-  tl_h2d_t tl_asf_32_us_h2d ;
-  tl_d2h_t tl_asf_32_us_d2h ;
-  tl_h2d_t tl_asf_32_ds_h2d ;
-  tl_d2h_t tl_asf_32_ds_d2h ;
+  assign tl_pwm_o = tl_s1n_32_ds_h2d[4];
+  assign tl_s1n_32_ds_d2h[4] = tl_pwm_i;
 
+  assign tl_rpi_gpio_o = tl_s1n_32_ds_h2d[5];
+  assign tl_s1n_32_ds_d2h[5] = tl_rpi_gpio_i;
 
+  assign tl_ard_gpio_o = tl_s1n_32_ds_h2d[6];
+  assign tl_s1n_32_ds_d2h[6] = tl_ard_gpio_i;
 
-  assign tl_sm1_31_us_h2d[0] = tl_s1n_30_ds_h2d[0];
-  assign tl_s1n_30_ds_d2h[0] = tl_sm1_31_us_d2h[0];
+  assign tl_pmod_gpio_o = tl_s1n_32_ds_h2d[7];
+  assign tl_s1n_32_ds_d2h[7] = tl_pmod_gpio_i;
 
-  assign tl_hyperram_o = tl_s1n_30_ds_h2d[1];
-  assign tl_s1n_30_ds_d2h[1] = tl_hyperram_i;
+  assign tl_rgbled_ctrl_o = tl_s1n_32_ds_h2d[8];
+  assign tl_s1n_32_ds_d2h[8] = tl_rgbled_ctrl_i;
 
-  assign tl_rev_tag_o = tl_s1n_30_ds_h2d[2];
-  assign tl_s1n_30_ds_d2h[2] = tl_rev_tag_i;
+  assign tl_hw_rev_o = tl_s1n_32_ds_h2d[9];
+  assign tl_s1n_32_ds_d2h[9] = tl_hw_rev_i;
 
-  assign tl_gpio_o = tl_s1n_30_ds_h2d[3];
-  assign tl_s1n_30_ds_d2h[3] = tl_gpio_i;
+  assign tl_xadc_o = tl_s1n_32_ds_h2d[10];
+  assign tl_s1n_32_ds_d2h[10] = tl_xadc_i;
 
-  assign tl_pwm_o = tl_s1n_30_ds_h2d[4];
-  assign tl_s1n_30_ds_d2h[4] = tl_pwm_i;
+  assign tl_dma_o = tl_s1n_32_ds_h2d[11];
+  assign tl_s1n_32_ds_d2h[11] = tl_dma_i;
 
-  assign tl_rpi_gpio_o = tl_s1n_30_ds_h2d[5];
-  assign tl_s1n_30_ds_d2h[5] = tl_rpi_gpio_i;
+  assign tl_timer_o = tl_s1n_32_ds_h2d[12];
+  assign tl_s1n_32_ds_d2h[12] = tl_timer_i;
 
-  assign tl_ard_gpio_o = tl_s1n_30_ds_h2d[6];
-  assign tl_s1n_30_ds_d2h[6] = tl_ard_gpio_i;
+  assign tl_uart0_o = tl_s1n_32_ds_h2d[13];
+  assign tl_s1n_32_ds_d2h[13] = tl_uart0_i;
 
-  assign tl_pmod_gpio_o = tl_s1n_30_ds_h2d[7];
-  assign tl_s1n_30_ds_d2h[7] = tl_pmod_gpio_i;
+  assign tl_uart1_o = tl_s1n_32_ds_h2d[14];
+  assign tl_s1n_32_ds_d2h[14] = tl_uart1_i;
 
-  assign tl_rgbled_ctrl_o = tl_s1n_30_ds_h2d[8];
-  assign tl_s1n_30_ds_d2h[8] = tl_rgbled_ctrl_i;
+  assign tl_uart2_o = tl_s1n_32_ds_h2d[15];
+  assign tl_s1n_32_ds_d2h[15] = tl_uart2_i;
 
-  assign tl_hw_rev_o = tl_s1n_30_ds_h2d[9];
-  assign tl_s1n_30_ds_d2h[9] = tl_hw_rev_i;
+  assign tl_uart3_o = tl_s1n_32_ds_h2d[16];
+  assign tl_s1n_32_ds_d2h[16] = tl_uart3_i;
 
-  assign tl_xadc_o = tl_s1n_30_ds_h2d[10];
-  assign tl_s1n_30_ds_d2h[10] = tl_xadc_i;
+  assign tl_uart4_o = tl_s1n_32_ds_h2d[17];
+  assign tl_s1n_32_ds_d2h[17] = tl_uart4_i;
 
-  assign tl_timer_o = tl_s1n_30_ds_h2d[11];
-  assign tl_s1n_30_ds_d2h[11] = tl_timer_i;
+  assign tl_i2c0_o = tl_s1n_32_ds_h2d[18];
+  assign tl_s1n_32_ds_d2h[18] = tl_i2c0_i;
 
-  assign tl_uart0_o = tl_s1n_30_ds_h2d[12];
-  assign tl_s1n_30_ds_d2h[12] = tl_uart0_i;
+  assign tl_i2c1_o = tl_s1n_32_ds_h2d[19];
+  assign tl_s1n_32_ds_d2h[19] = tl_i2c1_i;
 
-  assign tl_uart1_o = tl_s1n_30_ds_h2d[13];
-  assign tl_s1n_30_ds_d2h[13] = tl_uart1_i;
+  assign tl_sm1_35_us_h2d[0] = tl_s1n_32_ds_h2d[20];
+  assign tl_s1n_32_ds_d2h[20] = tl_sm1_35_us_d2h[0];
 
-  assign tl_uart2_o = tl_s1n_30_ds_h2d[14];
-  assign tl_s1n_30_ds_d2h[14] = tl_uart2_i;
+  assign tl_sm1_36_us_h2d[0] = tl_s1n_32_ds_h2d[21];
+  assign tl_s1n_32_ds_d2h[21] = tl_sm1_36_us_d2h[0];
 
-  assign tl_uart3_o = tl_s1n_30_ds_h2d[15];
-  assign tl_s1n_30_ds_d2h[15] = tl_uart3_i;
+  assign tl_sm1_37_us_h2d[0] = tl_s1n_32_ds_h2d[22];
+  assign tl_s1n_32_ds_d2h[22] = tl_sm1_37_us_d2h[0];
 
-  assign tl_uart4_o = tl_s1n_30_ds_h2d[16];
-  assign tl_s1n_30_ds_d2h[16] = tl_uart4_i;
+  assign tl_sm1_38_us_h2d[0] = tl_s1n_32_ds_h2d[23];
+  assign tl_s1n_32_ds_d2h[23] = tl_sm1_38_us_d2h[0];
 
-  assign tl_i2c0_o = tl_s1n_30_ds_h2d[17];
-  assign tl_s1n_30_ds_d2h[17] = tl_i2c0_i;
+  assign tl_sm1_39_us_h2d[0] = tl_s1n_32_ds_h2d[24];
+  assign tl_s1n_32_ds_d2h[24] = tl_sm1_39_us_d2h[0];
 
-  assign tl_i2c1_o = tl_s1n_30_ds_h2d[18];
-  assign tl_s1n_30_ds_d2h[18] = tl_i2c1_i;
+  assign tl_sm1_40_us_h2d[0] = tl_s1n_32_ds_h2d[25];
+  assign tl_s1n_32_ds_d2h[25] = tl_sm1_40_us_d2h[0];
 
-  assign tl_spi_flash_o = tl_s1n_30_ds_h2d[19];
-  assign tl_s1n_30_ds_d2h[19] = tl_spi_flash_i;
+  assign tl_sm1_41_us_h2d[0] = tl_s1n_32_ds_h2d[26];
+  assign tl_s1n_32_ds_d2h[26] = tl_sm1_41_us_d2h[0];
 
-  assign tl_spi_lcd_o = tl_s1n_30_ds_h2d[20];
-  assign tl_s1n_30_ds_d2h[20] = tl_spi_lcd_i;
+  assign tl_asf_42_us_h2d = tl_s1n_32_ds_h2d[27];
+  assign tl_s1n_32_ds_d2h[27] = tl_asf_42_us_d2h;
 
-  assign tl_spi_eth_o = tl_s1n_30_ds_h2d[21];
-  assign tl_s1n_30_ds_d2h[21] = tl_spi_eth_i;
+  assign tl_rv_plic_o = tl_s1n_32_ds_h2d[28];
+  assign tl_s1n_32_ds_d2h[28] = tl_rv_plic_i;
 
-  assign tl_spi_rp0_o = tl_s1n_30_ds_h2d[22];
-  assign tl_s1n_30_ds_d2h[22] = tl_spi_rp0_i;
+  assign tl_sm1_33_us_h2d[1] = tl_dbg_host_i;
+  assign tl_dbg_host_o = tl_sm1_33_us_d2h[1];
 
-  assign tl_spi_rp1_o = tl_s1n_30_ds_h2d[23];
-  assign tl_s1n_30_ds_d2h[23] = tl_spi_rp1_i;
+  assign tl_sm1_33_us_h2d[2] = tl_s1n_43_ds_h2d[0];
+  assign tl_s1n_43_ds_d2h[0] = tl_sm1_33_us_d2h[2];
 
-  assign tl_spi_ard_o = tl_s1n_30_ds_h2d[24];
-  assign tl_s1n_30_ds_d2h[24] = tl_spi_ard_i;
+  assign tl_sm1_34_us_h2d[1] = tl_s1n_43_ds_h2d[1];
+  assign tl_s1n_43_ds_d2h[1] = tl_sm1_34_us_d2h[1];
 
-  assign tl_spi_mkr_o = tl_s1n_30_ds_h2d[25];
-  assign tl_s1n_30_ds_d2h[25] = tl_spi_mkr_i;
+  assign tl_sm1_35_us_h2d[1] = tl_s1n_43_ds_h2d[2];
+  assign tl_s1n_43_ds_d2h[2] = tl_sm1_35_us_d2h[1];
 
-  assign tl_asf_32_us_h2d = tl_s1n_30_ds_h2d[26];
-  assign tl_s1n_30_ds_d2h[26] = tl_asf_32_us_d2h;
+  assign tl_sm1_36_us_h2d[1] = tl_s1n_43_ds_h2d[3];
+  assign tl_s1n_43_ds_d2h[3] = tl_sm1_36_us_d2h[1];
 
-  assign tl_rv_plic_o = tl_s1n_30_ds_h2d[27];
-  assign tl_s1n_30_ds_d2h[27] = tl_rv_plic_i;
+  assign tl_sm1_37_us_h2d[1] = tl_s1n_43_ds_h2d[4];
+  assign tl_s1n_43_ds_d2h[4] = tl_sm1_37_us_d2h[1];
 
-  assign tl_sm1_31_us_h2d[1] = tl_dbg_host_i;
-  assign tl_dbg_host_o = tl_sm1_31_us_d2h[1];
+  assign tl_sm1_38_us_h2d[1] = tl_s1n_43_ds_h2d[5];
+  assign tl_s1n_43_ds_d2h[5] = tl_sm1_38_us_d2h[1];
 
-  assign tl_s1n_30_us_h2d = tl_ibex_lsu_i;
-  assign tl_ibex_lsu_o = tl_s1n_30_us_d2h;
+  assign tl_sm1_39_us_h2d[1] = tl_s1n_43_ds_h2d[6];
+  assign tl_s1n_43_ds_d2h[6] = tl_sm1_39_us_d2h[1];
 
-  assign tl_sram_o = tl_sm1_31_ds_h2d;
-  assign tl_sm1_31_ds_d2h = tl_sram_i;
+  assign tl_sm1_40_us_h2d[1] = tl_s1n_43_ds_h2d[7];
+  assign tl_s1n_43_ds_d2h[7] = tl_sm1_40_us_d2h[1];
 
-  assign tl_usbdev_o = tl_asf_32_ds_h2d;
-  assign tl_asf_32_ds_d2h = tl_usbdev_i;
+  assign tl_sm1_41_us_h2d[1] = tl_s1n_43_ds_h2d[8];
+  assign tl_s1n_43_ds_d2h[8] = tl_sm1_41_us_d2h[1];
+
+  assign tl_s1n_32_us_h2d = tl_ibex_lsu_i;
+  assign tl_ibex_lsu_o = tl_s1n_32_us_d2h;
+
+  assign tl_sram_o = tl_sm1_33_ds_h2d;
+  assign tl_sm1_33_ds_d2h = tl_sram_i;
+
+  assign tl_hyperram_o = tl_sm1_34_ds_h2d;
+  assign tl_sm1_34_ds_d2h = tl_hyperram_i;
+
+  assign tl_spi_flash_o = tl_sm1_35_ds_h2d;
+  assign tl_sm1_35_ds_d2h = tl_spi_flash_i;
+
+  assign tl_spi_lcd_o = tl_sm1_36_ds_h2d;
+  assign tl_sm1_36_ds_d2h = tl_spi_lcd_i;
+
+  assign tl_spi_eth_o = tl_sm1_37_ds_h2d;
+  assign tl_sm1_37_ds_d2h = tl_spi_eth_i;
+
+  assign tl_spi_rp0_o = tl_sm1_38_ds_h2d;
+  assign tl_sm1_38_ds_d2h = tl_spi_rp0_i;
+
+  assign tl_spi_rp1_o = tl_sm1_39_ds_h2d;
+  assign tl_sm1_39_ds_d2h = tl_spi_rp1_i;
+
+  assign tl_spi_ard_o = tl_sm1_40_ds_h2d;
+  assign tl_sm1_40_ds_d2h = tl_spi_ard_i;
+
+  assign tl_spi_mkr_o = tl_sm1_41_ds_h2d;
+  assign tl_sm1_41_ds_d2h = tl_spi_mkr_i;
+
+  assign tl_usbdev_o = tl_asf_42_ds_h2d;
+  assign tl_asf_42_ds_d2h = tl_usbdev_i;
+
+  assign tl_s1n_43_us_h2d = tl_dma_host_i;
+  assign tl_dma_host_o = tl_s1n_43_us_d2h;
 
   always_comb begin
     // default steering to generate error response if address is not within the range
-    dev_sel_s1n_30 = 5'd28;
-    if ((tl_s1n_30_us_h2d.a_address &
+    dev_sel_s1n_32 = 5'd29;
+    if ((tl_s1n_32_us_h2d.a_address &
          ~(ADDR_MASK_SRAM)) == ADDR_SPACE_SRAM) begin
-      dev_sel_s1n_30 = 5'd0;
+      dev_sel_s1n_32 = 5'd0;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_HYPERRAM)) == ADDR_SPACE_HYPERRAM) begin
-      dev_sel_s1n_30 = 5'd1;
+      dev_sel_s1n_32 = 5'd1;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_REV_TAG)) == ADDR_SPACE_REV_TAG) begin
-      dev_sel_s1n_30 = 5'd2;
+      dev_sel_s1n_32 = 5'd2;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_GPIO)) == ADDR_SPACE_GPIO) begin
-      dev_sel_s1n_30 = 5'd3;
+      dev_sel_s1n_32 = 5'd3;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_PWM)) == ADDR_SPACE_PWM) begin
-      dev_sel_s1n_30 = 5'd4;
+      dev_sel_s1n_32 = 5'd4;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_RPI_GPIO)) == ADDR_SPACE_RPI_GPIO) begin
-      dev_sel_s1n_30 = 5'd5;
+      dev_sel_s1n_32 = 5'd5;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_ARD_GPIO)) == ADDR_SPACE_ARD_GPIO) begin
-      dev_sel_s1n_30 = 5'd6;
+      dev_sel_s1n_32 = 5'd6;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_PMOD_GPIO)) == ADDR_SPACE_PMOD_GPIO) begin
-      dev_sel_s1n_30 = 5'd7;
+      dev_sel_s1n_32 = 5'd7;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_RGBLED_CTRL)) == ADDR_SPACE_RGBLED_CTRL) begin
-      dev_sel_s1n_30 = 5'd8;
+      dev_sel_s1n_32 = 5'd8;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_HW_REV)) == ADDR_SPACE_HW_REV) begin
-      dev_sel_s1n_30 = 5'd9;
+      dev_sel_s1n_32 = 5'd9;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_XADC)) == ADDR_SPACE_XADC) begin
-      dev_sel_s1n_30 = 5'd10;
+      dev_sel_s1n_32 = 5'd10;
+
+    end else if ((tl_s1n_32_us_h2d.a_address &
+                  ~(ADDR_MASK_DMA)) == ADDR_SPACE_DMA) begin
+      dev_sel_s1n_32 = 5'd11;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_TIMER)) == ADDR_SPACE_TIMER) begin
-      dev_sel_s1n_30 = 5'd11;
+      dev_sel_s1n_32 = 5'd12;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_UART0)) == ADDR_SPACE_UART0) begin
-      dev_sel_s1n_30 = 5'd12;
+      dev_sel_s1n_32 = 5'd13;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_UART1)) == ADDR_SPACE_UART1) begin
-      dev_sel_s1n_30 = 5'd13;
+      dev_sel_s1n_32 = 5'd14;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_UART2)) == ADDR_SPACE_UART2) begin
-      dev_sel_s1n_30 = 5'd14;
+      dev_sel_s1n_32 = 5'd15;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_UART3)) == ADDR_SPACE_UART3) begin
-      dev_sel_s1n_30 = 5'd15;
+      dev_sel_s1n_32 = 5'd16;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_UART4)) == ADDR_SPACE_UART4) begin
-      dev_sel_s1n_30 = 5'd16;
+      dev_sel_s1n_32 = 5'd17;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_I2C0)) == ADDR_SPACE_I2C0) begin
-      dev_sel_s1n_30 = 5'd17;
+      dev_sel_s1n_32 = 5'd18;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_I2C1)) == ADDR_SPACE_I2C1) begin
-      dev_sel_s1n_30 = 5'd18;
+      dev_sel_s1n_32 = 5'd19;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_SPI_FLASH)) == ADDR_SPACE_SPI_FLASH) begin
-      dev_sel_s1n_30 = 5'd19;
+      dev_sel_s1n_32 = 5'd20;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_SPI_LCD)) == ADDR_SPACE_SPI_LCD) begin
-      dev_sel_s1n_30 = 5'd20;
+      dev_sel_s1n_32 = 5'd21;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_SPI_ETH)) == ADDR_SPACE_SPI_ETH) begin
-      dev_sel_s1n_30 = 5'd21;
+      dev_sel_s1n_32 = 5'd22;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_SPI_RP0)) == ADDR_SPACE_SPI_RP0) begin
-      dev_sel_s1n_30 = 5'd22;
+      dev_sel_s1n_32 = 5'd23;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_SPI_RP1)) == ADDR_SPACE_SPI_RP1) begin
-      dev_sel_s1n_30 = 5'd23;
+      dev_sel_s1n_32 = 5'd24;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_SPI_ARD)) == ADDR_SPACE_SPI_ARD) begin
-      dev_sel_s1n_30 = 5'd24;
+      dev_sel_s1n_32 = 5'd25;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_SPI_MKR)) == ADDR_SPACE_SPI_MKR) begin
-      dev_sel_s1n_30 = 5'd25;
+      dev_sel_s1n_32 = 5'd26;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_USBDEV)) == ADDR_SPACE_USBDEV) begin
-      dev_sel_s1n_30 = 5'd26;
+      dev_sel_s1n_32 = 5'd27;
 
-    end else if ((tl_s1n_30_us_h2d.a_address &
+    end else if ((tl_s1n_32_us_h2d.a_address &
                   ~(ADDR_MASK_RV_PLIC)) == ADDR_SPACE_RV_PLIC) begin
-      dev_sel_s1n_30 = 5'd27;
+      dev_sel_s1n_32 = 5'd28;
+end
+  end
+
+  always_comb begin
+    // default steering to generate error response if address is not within the range
+    dev_sel_s1n_43 = 4'd9;
+    if ((tl_s1n_43_us_h2d.a_address &
+         ~(ADDR_MASK_SRAM)) == ADDR_SPACE_SRAM) begin
+      dev_sel_s1n_43 = 4'd0;
+
+    end else if ((tl_s1n_43_us_h2d.a_address &
+                  ~(ADDR_MASK_HYPERRAM)) == ADDR_SPACE_HYPERRAM) begin
+      dev_sel_s1n_43 = 4'd1;
+
+    end else if ((tl_s1n_43_us_h2d.a_address &
+                  ~(ADDR_MASK_SPI_FLASH)) == ADDR_SPACE_SPI_FLASH) begin
+      dev_sel_s1n_43 = 4'd2;
+
+    end else if ((tl_s1n_43_us_h2d.a_address &
+                  ~(ADDR_MASK_SPI_LCD)) == ADDR_SPACE_SPI_LCD) begin
+      dev_sel_s1n_43 = 4'd3;
+
+    end else if ((tl_s1n_43_us_h2d.a_address &
+                  ~(ADDR_MASK_SPI_ETH)) == ADDR_SPACE_SPI_ETH) begin
+      dev_sel_s1n_43 = 4'd4;
+
+    end else if ((tl_s1n_43_us_h2d.a_address &
+                  ~(ADDR_MASK_SPI_RP0)) == ADDR_SPACE_SPI_RP0) begin
+      dev_sel_s1n_43 = 4'd5;
+
+    end else if ((tl_s1n_43_us_h2d.a_address &
+                  ~(ADDR_MASK_SPI_RP1)) == ADDR_SPACE_SPI_RP1) begin
+      dev_sel_s1n_43 = 4'd6;
+
+    end else if ((tl_s1n_43_us_h2d.a_address &
+                  ~(ADDR_MASK_SPI_ARD)) == ADDR_SPACE_SPI_ARD) begin
+      dev_sel_s1n_43 = 4'd7;
+
+    end else if ((tl_s1n_43_us_h2d.a_address &
+                  ~(ADDR_MASK_SPI_MKR)) == ADDR_SPACE_SPI_MKR) begin
+      dev_sel_s1n_43 = 4'd8;
 end
   end
 
@@ -365,17 +566,31 @@ end
   tlul_socket_1n #(
     .HReqDepth (4'h0),
     .HRspDepth (4'h0),
-    .DReqDepth (112'h0),
-    .DRspDepth (112'h0),
-    .N         (28)
-  ) u_s1n_30 (
+    .DReqDepth (116'h0),
+    .DRspDepth (116'h0),
+    .N         (29)
+  ) u_s1n_32 (
     .clk_i        (clk_sys_i),
     .rst_ni       (rst_sys_ni),
-    .tl_h_i       (tl_s1n_30_us_h2d),
-    .tl_h_o       (tl_s1n_30_us_d2h),
-    .tl_d_o       (tl_s1n_30_ds_h2d),
-    .tl_d_i       (tl_s1n_30_ds_d2h),
-    .dev_select_i (dev_sel_s1n_30)
+    .tl_h_i       (tl_s1n_32_us_h2d),
+    .tl_h_o       (tl_s1n_32_us_d2h),
+    .tl_d_o       (tl_s1n_32_ds_h2d),
+    .tl_d_i       (tl_s1n_32_ds_d2h),
+    .dev_select_i (dev_sel_s1n_32)
+  );
+  tlul_socket_m1 #(
+    .HReqDepth (12'h0),
+    .HRspDepth (12'h0),
+    .DReqDepth (4'h0),
+    .DRspDepth (4'h0),
+    .M         (3)
+  ) u_sm1_33 (
+    .clk_i        (clk_sys_i),
+    .rst_ni       (rst_sys_ni),
+    .tl_h_i       (tl_sm1_33_us_h2d),
+    .tl_h_o       (tl_sm1_33_us_d2h),
+    .tl_d_o       (tl_sm1_33_ds_h2d),
+    .tl_d_i       (tl_sm1_33_ds_d2h)
   );
   tlul_socket_m1 #(
     .HReqDepth (8'h0),
@@ -383,26 +598,139 @@ end
     .DReqDepth (4'h0),
     .DRspDepth (4'h0),
     .M         (2)
-  ) u_sm1_31 (
+  ) u_sm1_34 (
     .clk_i        (clk_sys_i),
     .rst_ni       (rst_sys_ni),
-    .tl_h_i       (tl_sm1_31_us_h2d),
-    .tl_h_o       (tl_sm1_31_us_d2h),
-    .tl_d_o       (tl_sm1_31_ds_h2d),
-    .tl_d_i       (tl_sm1_31_ds_d2h)
+    .tl_h_i       (tl_sm1_34_us_h2d),
+    .tl_h_o       (tl_sm1_34_us_d2h),
+    .tl_d_o       (tl_sm1_34_ds_h2d),
+    .tl_d_i       (tl_sm1_34_ds_d2h)
+  );
+  tlul_socket_m1 #(
+    .HReqDepth (8'h0),
+    .HRspDepth (8'h0),
+    .DReqDepth (4'h0),
+    .DRspDepth (4'h0),
+    .M         (2)
+  ) u_sm1_35 (
+    .clk_i        (clk_sys_i),
+    .rst_ni       (rst_sys_ni),
+    .tl_h_i       (tl_sm1_35_us_h2d),
+    .tl_h_o       (tl_sm1_35_us_d2h),
+    .tl_d_o       (tl_sm1_35_ds_h2d),
+    .tl_d_i       (tl_sm1_35_ds_d2h)
+  );
+  tlul_socket_m1 #(
+    .HReqDepth (8'h0),
+    .HRspDepth (8'h0),
+    .DReqDepth (4'h0),
+    .DRspDepth (4'h0),
+    .M         (2)
+  ) u_sm1_36 (
+    .clk_i        (clk_sys_i),
+    .rst_ni       (rst_sys_ni),
+    .tl_h_i       (tl_sm1_36_us_h2d),
+    .tl_h_o       (tl_sm1_36_us_d2h),
+    .tl_d_o       (tl_sm1_36_ds_h2d),
+    .tl_d_i       (tl_sm1_36_ds_d2h)
+  );
+  tlul_socket_m1 #(
+    .HReqDepth (8'h0),
+    .HRspDepth (8'h0),
+    .DReqDepth (4'h0),
+    .DRspDepth (4'h0),
+    .M         (2)
+  ) u_sm1_37 (
+    .clk_i        (clk_sys_i),
+    .rst_ni       (rst_sys_ni),
+    .tl_h_i       (tl_sm1_37_us_h2d),
+    .tl_h_o       (tl_sm1_37_us_d2h),
+    .tl_d_o       (tl_sm1_37_ds_h2d),
+    .tl_d_i       (tl_sm1_37_ds_d2h)
+  );
+  tlul_socket_m1 #(
+    .HReqDepth (8'h0),
+    .HRspDepth (8'h0),
+    .DReqDepth (4'h0),
+    .DRspDepth (4'h0),
+    .M         (2)
+  ) u_sm1_38 (
+    .clk_i        (clk_sys_i),
+    .rst_ni       (rst_sys_ni),
+    .tl_h_i       (tl_sm1_38_us_h2d),
+    .tl_h_o       (tl_sm1_38_us_d2h),
+    .tl_d_o       (tl_sm1_38_ds_h2d),
+    .tl_d_i       (tl_sm1_38_ds_d2h)
+  );
+  tlul_socket_m1 #(
+    .HReqDepth (8'h0),
+    .HRspDepth (8'h0),
+    .DReqDepth (4'h0),
+    .DRspDepth (4'h0),
+    .M         (2)
+  ) u_sm1_39 (
+    .clk_i        (clk_sys_i),
+    .rst_ni       (rst_sys_ni),
+    .tl_h_i       (tl_sm1_39_us_h2d),
+    .tl_h_o       (tl_sm1_39_us_d2h),
+    .tl_d_o       (tl_sm1_39_ds_h2d),
+    .tl_d_i       (tl_sm1_39_ds_d2h)
+  );
+  tlul_socket_m1 #(
+    .HReqDepth (8'h0),
+    .HRspDepth (8'h0),
+    .DReqDepth (4'h0),
+    .DRspDepth (4'h0),
+    .M         (2)
+  ) u_sm1_40 (
+    .clk_i        (clk_sys_i),
+    .rst_ni       (rst_sys_ni),
+    .tl_h_i       (tl_sm1_40_us_h2d),
+    .tl_h_o       (tl_sm1_40_us_d2h),
+    .tl_d_o       (tl_sm1_40_ds_h2d),
+    .tl_d_i       (tl_sm1_40_ds_d2h)
+  );
+  tlul_socket_m1 #(
+    .HReqDepth (8'h0),
+    .HRspDepth (8'h0),
+    .DReqDepth (4'h0),
+    .DRspDepth (4'h0),
+    .M         (2)
+  ) u_sm1_41 (
+    .clk_i        (clk_sys_i),
+    .rst_ni       (rst_sys_ni),
+    .tl_h_i       (tl_sm1_41_us_h2d),
+    .tl_h_o       (tl_sm1_41_us_d2h),
+    .tl_d_o       (tl_sm1_41_ds_h2d),
+    .tl_d_i       (tl_sm1_41_ds_d2h)
   );
   tlul_fifo_async #(
     .ReqDepth        (1),
     .RspDepth        (1)
-  ) u_asf_32 (
+  ) u_asf_42 (
     .clk_h_i      (clk_sys_i),
     .rst_h_ni     (rst_sys_ni),
     .clk_d_i      (clk_usb_i),
     .rst_d_ni     (rst_usb_ni),
-    .tl_h_i       (tl_asf_32_us_h2d),
-    .tl_h_o       (tl_asf_32_us_d2h),
-    .tl_d_o       (tl_asf_32_ds_h2d),
-    .tl_d_i       (tl_asf_32_ds_d2h)
+    .tl_h_i       (tl_asf_42_us_h2d),
+    .tl_h_o       (tl_asf_42_us_d2h),
+    .tl_d_o       (tl_asf_42_ds_h2d),
+    .tl_d_i       (tl_asf_42_ds_d2h)
+  );
+  tlul_socket_1n #(
+    .HReqDepth (4'h0),
+    .HRspDepth (4'h0),
+    .DReqDepth (36'h0),
+    .DRspDepth (36'h0),
+    .N         (9)
+  ) u_s1n_43 (
+    .clk_i        (clk_sys_i),
+    .rst_ni       (rst_sys_ni),
+    .tl_h_i       (tl_s1n_43_us_h2d),
+    .tl_h_o       (tl_s1n_43_us_d2h),
+    .tl_d_o       (tl_s1n_43_ds_h2d),
+    .tl_d_i       (tl_s1n_43_ds_d2h),
+    .dev_select_i (dev_sel_s1n_43)
   );
 
 endmodule
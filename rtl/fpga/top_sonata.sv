@@ -240,6 +240,23 @@ module top_sonata (
   logic [15:0] pmod_gp_oe;
   logic [15:0] pmod_gp_o;
 
+  // Chip selects are asserted (low) when either the GPIO output or the SPI block drives them low.
+  logic       mb1_gp, ah_tmpio10_gp, rph_g18_gp, rph_g17_gp, rph_g16_ce2_gp;
+  logic       rph_g8_ce0_gp, rph_g7_ce1_gp, ethmac_cs_gp, appspi_cs_gp, lcd_cs_gp;
+  logic [3:0] spi_flash_cs_n, spi_lcd_cs_n, spi_eth_cs_n, spi_rp0_cs_n;
+  logic [3:0] spi_rp1_cs_n, spi_ard_cs_n, spi_mkr_cs_n;
+
+  assign mb1         = mb1_gp         & spi_mkr_cs_n[0];
+  assign ah_tmpio10  = ah_tmpio10_gp  & spi_ard_cs_n[0];
+  assign rph_g18     = rph_g18_gp     & spi_rp1_cs_n[0];
+  assign rph_g17     = rph_g17_gp     & spi_rp1_cs_n[1];
+  assign rph_g16_ce2 = rph_g16_ce2_gp & spi_rp1_cs_n[2];
+  assign rph_g8_ce0  = rph_g8_ce0_gp  & spi_rp0_cs_n[0];
+  assign rph_g7_ce1  = rph_g7_ce1_gp  & spi_rp0_cs_n[1];
+  assign ethmac_cs   = ethmac_cs_gp   & spi_eth_cs_n[0];
+  assign appspi_cs   = appspi_cs_gp   & spi_flash_cs_n[0];
+  assign lcd_cs      = lcd_cs_gp      & spi_lcd_cs_n[0];
+
   // R-Pi header GPIO
   assign rph_g4  = rp_gp_oe[0]  ? rp_gp_o[0]  : 1'bZ;
   assign rph_g5  = rp_gp_oe[1]  ? rp_gp_o[1]  : 1'bZ;
@@ -348,14 +365,14 @@ module top_sonata (
                     }),
     .gp_o           ({
                       mb0, // mikroBUS Click reset
-                      mb1, // mikroBUS Click chip select
-                      ah_tmpio10, // Arduino shield chip select
-                      rph_g18, rph_g17, rph_g16_ce2, // R-Pi SPI1 chip select
-                      rph_g8_ce0, rph_g7_ce1, // R-Pi SPI0 chip select
-                      ethmac_rst, ethmac_cs, // Ethernet
-                      appspi_cs, // Flash
+                      mb1_gp, // mikroBUS Click chip select
+                      ah_tmpio10_gp, // Arduino shield chip select
+                      rph_g18_gp, rph_g17_gp, rph_g16_ce2_gp, // R-Pi SPI1 chip select
+                      rph_g8_ce0_gp, rph_g7_ce1_gp, // R-Pi SPI0 chip select
+                      ethmac_rst, ethmac_cs_gp, // Ethernet
+                      appspi_cs_gp, // Flash
                       usrLed, // User LEDs (8 bits)
-                      lcd_backlight, lcd_dc, lcd_rst, lcd_cs // LCD screen
+                      lcd_backlight, lcd_dc, lcd_rst, lcd_cs_gp // LCD screen
                     }),
 
     // R-Pi Header GPIO
@@ -425,37 +442,44 @@ module top_sonata (
     .spi_lcd_rx_i   (1'b0),
     .spi_lcd_tx_o   (lcd_copi),
     .spi_lcd_sck_o  (lcd_clk),
+    .spi_lcd_cs_no  (spi_lcd_cs_n),
 
     // SPI for flash memory
     .spi_flash_rx_i (appspi_d1),
     .spi_flash_tx_o (appspi_d0),
     .spi_flash_sck_o(appspi_clk),
+    .spi_flash_cs_no(spi_flash_cs_n),
 
     // SPI for ethernet
     .spi_eth_rx_i   (ethmac_cipo),
     .spi_eth_tx_o   (ethmac_copi),
     .spi_eth_sck_o  (ethmac_sclk),
+    .spi_eth_cs_no  (spi_eth_cs_n),
     .spi_eth_irq_ni (ethmac_intr),
 
     // SPI0 on the R-Pi header
     .spi_rp0_rx_i   (rph_g9_cipo),
     .spi_rp0_tx_o   (rph_g10_copi),
     .spi_rp0_sck_o  (rph_g11_sclk),
+    .spi_rp0_cs_no  (spi_rp0_cs_n), // CE0, CE1
 
     // SPI1 on the R-Pi header
     .spi_rp1_rx_i   (rph_g19_cipo),
     .spi_rp1_tx_o   (rph_g20_copi),
     .spi_rp1_sck_o  (rph_g21_sclk),
+    .spi_rp1_cs_no  (spi_rp1_cs_n), // CE0, CE1, CE2
 
     // SPI on Arduino shield
     .spi_ard_rx_i   (ah_tmpio12), // CIPO
     .spi_ard_tx_o   (ah_tmpio11), // COPI
     .spi_ard_sck_o  (ah_tmpio13), // SCLK
+    .spi_ard_cs_no  (spi_ard_cs_n), // CS
 
     // SPI on mikroBUS Click
     .spi_mkr_rx_i   (mb3), // CIPO
     .spi_mkr_tx_o   (mb4), // COPI
     .spi_mkr_sck_o  (mb2), // SCLK
+    .spi_mkr_cs_no  (spi_mkr_cs_n), // CS
 
     // CHERI signals
     .cheri_en_i     (enable_cheri),
@@ -0,0 +1,374 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * dma - Copies data a word at a time between two addresses through its own TL-UL host port,
+ * following a chain of descriptors. Each descriptor gives a source, a destination, a byte count and
+ * control bits, and the address of the next descriptor.
+ *
+ * Either address can be left fixed to read or write a FIFO register. Accesses can be paced by one
+ * of the SPI blocks, so that a descriptor only writes its transmit FIFO when there is space for a
+ * word and only reads its receive FIFO once a word has arrived. A descriptor can also wait for the
+ * SPI block to be idle before it starts, so a chain can write SPI START for each operation of a
+ * transfer longer than a single operation allows.
+ *
+ * There is at most one access outstanding on the host port at a time.
+ *
+ * spi_tx_ready_i/spi_rx_ready_i/spi_idle_i - Pacing signals from each SPI block. tx_ready is
+ * asserted when the transmit FIFO has space for four bytes and rx_ready when the receive FIFO holds
+ * at least four.
+ *
+ * A partial last word is written with only its remaining bytes enabled. The SPI word FIFO registers
+ * only permit full word writes, so on the transmit FIFO that write gets a TL-UL error and ends the
+ * transfer with a write error. On the receive side a partial last word never sees rx_ready, as
+ * fewer than four bytes arrive for it. Software must only give SPI paced descriptors whole words.
+ */
+
+module dma import dma_reg_pkg::*; #(
+  parameter int unsigned NumSpi = 7
+) (
+  input clk_i,
+  input rst_ni,
+
+  input  tlul_pkg::tl_h2d_t tl_i,
+  output tlul_pkg::tl_d2h_t tl_o,
+
+  output tlul_pkg::tl_h2d_t host_tl_o,
+  input  tlul_pkg::tl_d2h_t host_tl_i,
+
+  output logic intr_done_o,
+
+  input  logic [NumSpi-1:0] spi_tx_ready_i,
+  input  logic [NumSpi-1:0] spi_rx_ready_i,
+  input  logic [NumSpi-1:0] spi_idle_i
+);
+
+  dma_reg2hw_t reg2hw;
+  dma_hw2reg_t hw2reg;
+
+  dma_reg_top u_reg (
+    .clk_i,
+    .rst_ni,
+    .tl_i,
+    .tl_o,
+    .reg2hw,
+    .hw2reg,
+    .intg_err_o ()
+  );
+
+  // Size of a descriptor in memory, in words.
+  localparam int unsigned DescWords = 5;
+
+  typedef enum logic [2:0] {
+    IDLE,
+    LOAD_DESC,
+    WAIT_START,
+    READ,
+    WRITE,
+    DONE
+  } state_e;
+
+  state_e state_q, state_d;
+
+  // Control bits of the descriptor being run.
+  typedef struct packed {
+    logic       spi_wait_idle;
+    logic       spi_rx;
+    logic       spi_tx;
+    logic [2:0] spi;
+    logic       disable_write;
+    logic       disable_read;
+    logic       write_inc;
+    logic       read_inc;
+  } desc_ctrl_t;
+
+  logic [31:0] src_q, src_d;
+  logic [31:0] dst_q, dst_d;
+  logic [19:0] count_q, count_d;
+  logic [31:0] next_q, next_d;
+  desc_ctrl_t  ctrl_q, ctrl_d;
+  logic [31:0] data_q, data_d;
+  logic [2:0]  desc_word_q, desc_word_d;
+
+  // An access has been granted and its response not yet received.
+  logic outstanding_q, outstanding_d;
+  logic stop_q, stop_d;
+
+  logic read_error_q, read_error_d;
+  logic write_error_q, write_error_d;
+  logic bus_error_q, bus_error_d;
+
+  logic        host_req, host_gnt, host_we, host_valid, host_err;
+  logic [31:0] host_addr, host_rdata;
+  logic [3:0]  host_be;
+
+  logic spi_tx_ready, spi_rx_ready, spi_idle;
+
+  // Selecting a block beyond the last one leaves the descriptor unpaced.
+  assign spi_tx_ready = ctrl_q.spi < NumSpi ? spi_tx_ready_i[ctrl_q.spi] : 1'b1;
+  assign spi_rx_ready = ctrl_q.spi < NumSpi ? spi_rx_ready_i[ctrl_q.spi] : 1'b1;
+  assign spi_idle     = ctrl_q.spi < NumSpi ? spi_idle_i[ctrl_q.spi]     : 1'b1;
+
+  logic start_req, stop_req;
+
+  assign start_req = reg2hw.control.request.qe & reg2hw.control.request.q;
+  assign stop_req  = reg2hw.control.stop.qe & reg2hw.control.stop.q;
+
+  function automatic desc_ctrl_t decode_ctrl(logic [31:0] control);
+    desc_ctrl_t ctrl;
+    ctrl.spi_wait_idle = control[13];
+    ctrl.spi_rx        = control[12];
+    ctrl.spi_tx        = control[11];
+    ctrl.spi           = control[10:8];
+    ctrl.disable_write = control[4];
+    ctrl.disable_read  = control[3];
+    ctrl.write_inc     = control[2];
+    ctrl.read_inc      = control[1];
+    return ctrl;
+  endfunction
+
+  // Byte enables for the next write, covering only the bytes left for the last word.
+  always_comb begin
+    unique case (count_q)
+      20'd1:   host_be = 4'b0001;
+      20'd2:   host_be = 4'b0011;
+      20'd3:   host_be = 4'b0111;
+      default: host_be = 4'b1111;
+    endcase
+  end
+
+  always_comb begin
+    host_req  = 1'b0;
+    host_we   = 1'b0;
+    host_addr = src_q;
+
+    if (!outstanding_q && !stop_q) begin
+      unique case (state_q)
+        LOAD_DESC: begin
+          host_req  = 1'b1;
+          host_addr = next_q + {27'b0, desc_word_q, 2'b0};
+        end
+        READ: begin
+          host_req  = !ctrl_q.spi_rx | spi_rx_ready;
+          host_addr = src_q;
+        end
+        WRITE: begin
+          host_req  = !ctrl_q.spi_tx | spi_tx_ready;
+          host_we   = 1'b1;
+          host_addr = dst_q;
+        end
+        default: ;
+      endcase
+    end
+  end
+
+  always_comb begin
+    state_d       = state_q;
+    src_d         = src_q;
+    dst_d         = dst_q;
+    count_d       = count_q;
+    next_d        = next_q;
+    ctrl_d        = ctrl_q;
+    data_d        = data_q;
+    desc_word_d   = desc_word_q;
+    outstanding_d = outstanding_q;
+    stop_d        = stop_q | (stop_req & state_q != IDLE);
+    read_error_d  = read_error_q;
+    write_error_d = write_error_q;
+    bus_error_d   = bus_error_q;
+
+    if (host_req && host_gnt) begin
+      outstanding_d = 1'b1;
+    end
+
+    unique case (state_q)
+      IDLE: begin
+        if (start_req) begin
+          src_d         = reg2hw.src.q;
+          dst_d         = reg2hw.dst.q;
+          count_d       = reg2hw.count.q;
+          next_d        = reg2hw.next.q;
+          ctrl_d        = '{
+            spi_wait_idle: reg2hw.control.spi_wait_idle.q,
+            spi_rx:        reg2hw.control.spi_rx.q,
+            spi_tx:        reg2hw.control.spi_tx.q,
+            spi:           reg2hw.control.spi.q,
+            disable_write: reg2hw.control.disable_write.q,
+            disable_read:  reg2hw.control.disable_read.q,
+            write_inc:     reg2hw.control.write_inc.q,
+            read_inc:      reg2hw.control.read_inc.q
+          };
+          stop_d        = 1'b0;
+          read_error_d  = 1'b0;
+          write_error_d = 1'b0;
+          bus_error_d   = 1'b0;
+          state_d       = WAIT_START;
+        end
+      end
+      LOAD_DESC: begin
+        if (host_valid) begin
+          outstanding_d = 1'b0;
+          if (host_err) begin
+            bus_error_d = 1'b1;
+            state_d     = DONE;
+          end else begin
+            unique case (desc_word_q)
+              3'd0:    src_d   = host_rdata;
+              3'd1:    dst_d   = host_rdata;
+              3'd2:    count_d = host_rdata[19:0];
+              3'd3:    ctrl_d  = decode_ctrl(host_rdata);
+              default: next_d  = host_rdata;
+            endcase
+            desc_word_d = desc_word_q + 3'd1;
+            if (desc_word_q == 3'(DescWords - 1)) begin
+              state_d = WAIT_START;
+            end
+          end
+        end
+      end
+      WAIT_START: begin
+        if (count_q == '0) begin
+          // Nothing to copy, move straight on to the next descriptor.
+          desc_word_d = '0;
+          state_d     = next_q != '0 ? LOAD_DESC : DONE;
+        end else if (!ctrl_q.spi_wait_idle || spi_idle) begin
+          data_d  = '0;
+          state_d = ctrl_q.disable_read ? WRITE : READ;
+        end
+      end
+      READ: begin
+        if (host_valid) begin
+          outstanding_d = 1'b0;
+          data_d        = host_rdata;
+          if (ctrl_q.read_inc) begin
+            src_d = src_q + 32'd4;
+          end
+          if (host_err) begin
+            read_error_d = 1'b1;
+            bus_error_d  = 1'b1;
+            state_d      = DONE;
+          end else if (!ctrl_q.disable_write) begin
+            state_d = WRITE;
+          end else begin
+            count_d = count_q > 20'd4 ? count_q - 20'd4 : '0;
+            state_d = count_d == '0 ? WAIT_START : READ;
+          end
+        end
+      end
+      WRITE: begin
+        if (host_valid) begin
+          outstanding_d = 1'b0;
+          if (ctrl_q.write_inc) begin
+            dst_d = dst_q + 32'd4;
+          end
+          count_d = count_q > 20'd4 ? count_q - 20'd4 : '0;
+          if (host_err) begin
+            write_error_d = 1'b1;
+            bus_error_d   = 1'b1;
+            state_d       = DONE;
+          end else if (count_d == '0) begin
+            state_d = WAIT_START;
+          end else begin
+            state_d = ctrl_q.disable_read ? WRITE : READ;
+          end
+        end
+      end
+      DONE: begin
+        state_d = IDLE;
+      end
+      default: state_d = IDLE;
+    endcase
+
+    // A stop takes effect once any outstanding access has completed.
+    if (stop_d && !outstanding_d && state_d != IDLE) begin
+      state_d = DONE;
+    end
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      state_q       <= IDLE;
+      src_q         <= '0;
+      dst_q         <= '0;
+      count_q       <= '0;
+      next_q        <= '0;
+      ctrl_q        <= '0;
+      data_q        <= '0;
+      desc_word_q   <= '0;
+      outstanding_q <= 1'b0;
+      stop_q        <= 1'b0;
+      read_error_q  <= 1'b0;
+      write_error_q <= 1'b0;
+      bus_error_q   <= 1'b0;
+    end else begin
+      state_q       <= state_d;
+      src_q         <= src_d;
+      dst_q         <= dst_d;
+      count_q       <= count_d;
+      next_q        <= next_d;
+      ctrl_q        <= ctrl_d;
+      data_q        <= data_d;
+      desc_word_q   <= desc_word_d;
+      outstanding_q <= outstanding_d;
+      stop_q        <= stop_d;
+      read_error_q  <= read_error_d;
+      write_error_q <= write_error_d;
+      bus_error_q   <= bus_error_d;
+    end
+  end
+
+  tlul_adapter_host #(
+    .MAX_REQS(1)
+  ) u_host_adapter (
+    .clk_i,
+    .rst_ni,
+
+    .req_i        (host_req),
+    .gnt_o        (host_gnt),
+    .addr_i       ({host_addr[31:2], 2'b0}),
+    .we_i         (host_we),
+    .wdata_i      (data_q),
+    .wdata_cap_i  (1'b0), // Copies never carry a capability tag.
+    .wdata_intg_i ('0),
+    .be_i         (host_be),
+    .instr_type_i (prim_mubi_pkg::MuBi4False),
+
+    .valid_o      (host_valid),
+    .rdata_o      (host_rdata),
+    .rdata_cap_o  (),
+    .rdata_intg_o (),
+    .err_o        (host_err),
+    .intg_err_o   (),
+
+    .tl_o         (host_tl_o),
+    .tl_i         (host_tl_i)
+  );
+
+  assign hw2reg.status.ready.d       = state_q == IDLE;
+  assign hw2reg.status.bus_error.d   = bus_error_q;
+  assign hw2reg.status.read_error.d  = read_error_q;
+  assign hw2reg.status.write_error.d = write_error_q;
+
+  prim_intr_hw #(.Width(1), .IntrT("Event")) intr_hw_done (
+    .clk_i,
+    .rst_ni,
+    .event_intr_i           (state_q == DONE),
+    .reg2hw_intr_enable_q_i (reg2hw.intr_enable.q),
+    .reg2hw_intr_test_q_i   (reg2hw.intr_test.q),
+    .reg2hw_intr_test_qe_i  (reg2hw.intr_test.qe),
+    .reg2hw_intr_state_q_i  (reg2hw.intr_state.q),
+    .hw2reg_intr_state_de_o (hw2reg.intr_state.de),
+    .hw2reg_intr_state_d_o  (hw2reg.intr_state.d),
+    .intr_o                 (intr_done_o)
+  );
+
+  logic unused_reg2hw;
+
+  // Only the qe of the first CONTROL field is used to spot a write.
+  assign unused_reg2hw = ^{reg2hw.control.spi_wait_idle.qe, reg2hw.control.spi_rx.qe,
+                           reg2hw.control.spi_tx.qe, reg2hw.control.spi.qe,
+                           reg2hw.control.disable_write.qe, reg2hw.control.disable_read.qe,
+                           reg2hw.control.write_inc.qe, reg2hw.control.read_inc.qe};
+
+endmodule
@@ -0,0 +1,168 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Register Package auto-generated by `reggen` containing data structure
+
+package dma_reg_pkg;
+
+  // Address widths within the block
+  parameter int BlockAw = 6;
+
+  ////////////////////////////
+  // Typedefs for registers //
+  ////////////////////////////
+
+  typedef struct packed {
+    logic        q;
+  } dma_reg2hw_intr_state_reg_t;
+
+  typedef struct packed {
+    logic        q;
+  } dma_reg2hw_intr_enable_reg_t;
+
+  typedef struct packed {
+    logic        q;
+    logic        qe;
+  } dma_reg2hw_intr_test_reg_t;
+
+  typedef struct packed {
+    logic [31:0] q;
+  } dma_reg2hw_src_reg_t;
+
+  typedef struct packed {
+    logic [31:0] q;
+  } dma_reg2hw_dst_reg_t;
+
+  typedef struct packed {
+    logic [19:0] q;
+  } dma_reg2hw_count_reg_t;
+
+  typedef struct packed {
+    struct packed {
+      logic        q;
+      logic        qe;
+    } spi_wait_idle;
+    struct packed {
+      logic        q;
+      logic        qe;
+    } spi_rx;
+    struct packed {
+      logic        q;
+      logic        qe;
+    } spi_tx;
+    struct packed {
+      logic [2:0]  q;
+      logic        qe;
+    } spi;
+    struct packed {
+      logic        q;
+      logic        qe;
+    } stop;
+    struct packed {
+      logic        q;
+      logic        qe;
+    } disable_write;
+    struct packed {
+      logic        q;
+      logic        qe;
+    } disable_read;
+    struct packed {
+      logic        q;
+      logic        qe;
+    } write_inc;
+    struct packed {
+      logic        q;
+      logic        qe;
+    } read_inc;
+    struct packed {
+      logic        q;
+      logic        qe;
+    } request;
+  } dma_reg2hw_control_reg_t;
+
+  typedef struct packed {
+    logic [31:0] q;
+  } dma_reg2hw_next_reg_t;
+
+  typedef struct packed {
+    logic        d;
+    logic        de;
+  } dma_hw2reg_intr_state_reg_t;
+
+  typedef struct packed {
+    struct packed {
+      logic        d;
+    } ready;
+    struct packed {
+      logic        d;
+    } bus_error;
+    struct packed {
+      logic        d;
+    } read_error;
+    struct packed {
+      logic        d;
+    } write_error;
+  } dma_hw2reg_status_reg_t;
+
+  // Register -> HW type
+  typedef struct packed {
+    dma_reg2hw_intr_state_reg_t intr_state; // [141:141]
+    dma_reg2hw_intr_enable_reg_t intr_enable; // [140:140]
+    dma_reg2hw_intr_test_reg_t intr_test; // [139:138]
+    dma_reg2hw_src_reg_t src; // [137:106]
+    dma_reg2hw_dst_reg_t dst; // [105:74]
+    dma_reg2hw_count_reg_t count; // [73:54]
+    dma_reg2hw_control_reg_t control; // [53:32]
+    dma_reg2hw_next_reg_t next; // [31:0]
+  } dma_reg2hw_t;
+
+  // HW -> register type
+  typedef struct packed {
+    dma_hw2reg_intr_state_reg_t intr_state; // [5:4]
+    dma_hw2reg_status_reg_t status; // [3:0]
+  } dma_hw2reg_t;
+
+  // Register offsets
+  parameter logic [BlockAw-1:0] DMA_INTR_STATE_OFFSET = 6'h 0;
+  parameter logic [BlockAw-1:0] DMA_INTR_ENABLE_OFFSET = 6'h 4;
+  parameter logic [BlockAw-1:0] DMA_INTR_TEST_OFFSET = 6'h 8;
+  parameter logic [BlockAw-1:0] DMA_SRC_OFFSET = 6'h c;
+  parameter logic [BlockAw-1:0] DMA_DST_OFFSET = 6'h 10;
+  parameter logic [BlockAw-1:0] DMA_COUNT_OFFSET = 6'h 14;
+  parameter logic [BlockAw-1:0] DMA_STATUS_OFFSET = 6'h 18;
+  parameter logic [BlockAw-1:0] DMA_CONTROL_OFFSET = 6'h 1c;
+  parameter logic [BlockAw-1:0] DMA_NEXT_OFFSET = 6'h 20;
+
+  // Reset values for hwext registers and their fields
+  parameter logic [0:0] DMA_INTR_TEST_RESVAL = 1'h 0;
+  parameter logic [0:0] DMA_INTR_TEST_DONE_RESVAL = 1'h 0;
+  parameter logic [5:0] DMA_STATUS_RESVAL = 6'h 0;
+
+  // Register index
+  typedef enum int {
+    DMA_INTR_STATE,
+    DMA_INTR_ENABLE,
+    DMA_INTR_TEST,
+    DMA_SRC,
+    DMA_DST,
+    DMA_COUNT,
+    DMA_STATUS,
+    DMA_CONTROL,
+    DMA_NEXT
+  } dma_id_e;
+
+  // Register width information to check illegal writes
+  parameter logic [3:0] DMA_PERMIT [9] = '{
+    4'b 0001, // index[0] DMA_INTR_STATE
+    4'b 0001, // index[1] DMA_INTR_ENABLE
+    4'b 0001, // index[2] DMA_INTR_TEST
+    4'b 1111, // index[3] DMA_SRC
+    4'b 1111, // index[4] DMA_DST
+    4'b 0111, // index[5] DMA_COUNT
+    4'b 0001, // index[6] DMA_STATUS
+    4'b 0011, // index[7] DMA_CONTROL
+    4'b 1111  // index[8] DMA_NEXT
+  };
+
+endpackage
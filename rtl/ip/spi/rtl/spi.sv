@@ -2,6 +2,8 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
+`include "prim_assert.sv"
+
 module spi import spi_reg_pkg::*; #(
   parameter int unsigned RxFifoDepth = 64,
   parameter int unsigned TxFifoDepth = 64
@@ -18,9 +20,15 @@ module spi import spi_reg_pkg::*; #(
   output logic intr_tx_watermark_o,
   output logic intr_complete_o,
 
+  // Pacing for the DMA engine.
+  output logic dma_tx_ready_o,
+  output logic dma_rx_ready_o,
+  output logic idle_o,
+
   output logic spi_copi_o,
   input  logic spi_cipo_i,
-  output logic spi_clk_o
+  output logic spi_clk_o,
+  output logic [3:0] spi_cs_no
 );
 
   spi_reg2hw_t reg2hw;
@@ -52,16 +60,16 @@ module spi import spi_reg_pkg::*; #(
   localparam int unsigned RxFifoDepthW = prim_util_pkg::vbits(RxFifoDepth+1);
 
   logic [RxFifoDepthW-1:0] rx_fifo_depth;
-  logic [7:0]              rx_fifo_rdata;
+  logic [31:0]             rx_fifo_rdata;
+  logic [2:0]              rx_fifo_pop_count;
   logic                    rx_fifo_wvalid, rx_fifo_wready;
-  logic                    rx_fifo_rready;
-  logic                    rx_fifo_clr;
+  logic                    rx_fifo_clr, rx_fifo_full;
 
-  localparam int unsigned TxFifoDepthW = prim_util_pkg::vbits(RxFifoDepth+1);
+  localparam int unsigned TxFifoDepthW = prim_util_pkg::vbits(TxFifoDepth+1);
 
   logic [TxFifoDepthW-1:0] tx_fifo_depth;
-  logic [7:0]              tx_fifo_wdata;
-  logic                    tx_fifo_wvalid;
+  logic [31:0]             tx_fifo_wdata, tx_fifo_rdata;
+  logic [2:0]              tx_fifo_push_count;
   logic                    tx_fifo_rvalid, tx_fifo_rready;
   logic                    tx_fifo_clr, tx_fifo_full;
 
@@ -73,18 +81,22 @@ module spi import spi_reg_pkg::*; #(
   assign spi_start      = (reg2hw.start.qe & spi_idle);
   assign spi_byte_count = reg2hw.start.q;
 
-  assign tx_fifo_wvalid = reg2hw.tx_fifo.qe;
-  assign tx_fifo_wdata = reg2hw.tx_fifo.q;
+  // TX_FIFO pushes a single byte and TX_FIFO_WORD four. Only one can be written in a cycle.
+  assign tx_fifo_push_count = reg2hw.tx_fifo.qe      ? 3'd1 :
+                              reg2hw.tx_fifo_word.qe ? 3'd4 : 3'd0;
+  assign tx_fifo_wdata      = reg2hw.tx_fifo.qe ? {24'b0, reg2hw.tx_fifo.q} : reg2hw.tx_fifo_word.q;
 
-  assign rx_fifo_rready = reg2hw.rx_fifo.re;
-  assign hw2reg.rx_fifo.d = rx_fifo_rdata;
+  // Likewise reading RX_FIFO pops a single byte and RX_FIFO_WORD up to four.
+  assign rx_fifo_pop_count = reg2hw.rx_fifo.re      ? 3'd1 :
+                             reg2hw.rx_fifo_word.re ? 3'd4 : 3'd0;
+
+  assign hw2reg.rx_fifo.d      = rx_fifo_rdata[7:0];
+  assign hw2reg.rx_fifo_word.d = rx_fifo_rdata;
 
   assign rx_fifo_clr = reg2hw.control.rx_clear.qe & reg2hw.control.rx_clear.q;
   assign tx_fifo_clr = reg2hw.control.tx_clear.qe & reg2hw.control.tx_clear.q;
 
-  prim_fifo_sync #(
-    .Width(8),
-    .Pass (1'b0),
+  spi_fifo #(
     .Depth(RxFifoDepth)
   ) u_rx_fifo (
     .clk_i,
@@ -92,22 +104,17 @@ module spi import spi_reg_pkg::*; #(
 
     .clr_i(rx_fifo_clr),
 
-    .wvalid_i(rx_fifo_wvalid),
-    .wready_o(rx_fifo_wready),
-    .wdata_i (spi_data_out),
+    .push_count_i({2'b0, rx_fifo_wvalid}),
+    .wdata_i     ({24'b0, spi_data_out}),
 
-    .rvalid_o(),
-    .rready_i(rx_fifo_rready),
-    .rdata_o (rx_fifo_rdata),
+    .pop_count_i(rx_fifo_pop_count),
+    .rdata_o    (rx_fifo_rdata),
 
-    .full_o (),
-    .depth_o(rx_fifo_depth),
-    .err_o  ()
+    .full_o (rx_fifo_full),
+    .depth_o(rx_fifo_depth)
   );
 
-  prim_fifo_sync #(
-    .Width(8),
-    .Pass (1'b0),
+  spi_fifo #(
     .Depth(TxFifoDepth)
   ) u_tx_fifo (
     .clk_i,
@@ -115,19 +122,25 @@ module spi import spi_reg_pkg::*; #(
 
     .clr_i(tx_fifo_clr),
 
-    .wvalid_i(tx_fifo_wvalid),
-    .wready_o(),
-    .wdata_i (tx_fifo_wdata),
+    .push_count_i(tx_fifo_push_count),
+    .wdata_i     (tx_fifo_wdata),
 
-    .rvalid_o(tx_fifo_rvalid),
-    .rready_i(tx_fifo_rready),
-    .rdata_o (spi_data_in),
+    .pop_count_i({2'b0, tx_fifo_rready}),
+    .rdata_o    (tx_fifo_rdata),
 
     .full_o (tx_fifo_full),
-    .depth_o(tx_fifo_depth),
-    .err_o  ()
+    .depth_o(tx_fifo_depth)
   );
 
+  logic unused_tx_fifo_rdata;
+
+  // The SPI core takes one byte at a time from the transmit FIFO.
+  assign unused_tx_fifo_rdata = ^tx_fifo_rdata[31:8];
+
+  assign spi_data_in    = tx_fifo_rdata[7:0];
+  assign tx_fifo_rvalid = tx_fifo_depth != '0;
+  assign rx_fifo_wready = ~rx_fifo_full;
+
   assign spi_data_in_valid = reg2hw.control.tx_enable.q ? tx_fifo_rvalid    : 1'b1;
   assign tx_fifo_rready    = reg2hw.control.tx_enable.q ? spi_data_in_ready : 1'b0;
 
@@ -140,6 +153,14 @@ module spi import spi_reg_pkg::*; #(
   assign hw2reg.status.rx_fifo_empty.d = rx_fifo_depth == '0;
   assign hw2reg.status.idle.d          = spi_idle;
 
+  assign hw2reg.info.rx_fifo_depth.d = 8'(RxFifoDepth);
+  assign hw2reg.info.tx_fifo_depth.d = 8'(TxFifoDepth);
+
+  // The DMA engine moves a word at a time through the word FIFO registers.
+  assign dma_tx_ready_o = tx_fifo_depth <= TxFifoDepthW'(TxFifoDepth - 4);
+  assign dma_rx_ready_o = rx_fifo_depth >= RxFifoDepthW'(4);
+  assign idle_o         = spi_idle;
+
   spi_core u_spi_core (
     .clk_i,
     .rst_ni,
@@ -166,11 +187,136 @@ module spi import spi_reg_pkg::*; #(
     .spi_clk_o
   );
 
-  assign hw2reg.intr_state = '0;
+  // Selected chip selects are asserted from the cycle after an operation starts, alongside the
+  // first data bit, until it completes, and throughout while HOLD is set.
+  logic [3:0] spi_cs_nq;
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      spi_cs_nq <= '1;
+    end else begin
+      spi_cs_nq <= ~(reg2hw.cs.select.q & {4{reg2hw.cs.hold.q | spi_start | ~spi_idle}});
+    end
+  end
+
+  assign spi_cs_no = spi_cs_nq;
+
+  // Wide enough for the fixed watermark levels whatever the FIFO depths.
+  logic [8:0] rx_watermark_level;
+  logic [8:0] tx_watermark_level;
+
+  // Decode the watermark encodings described in the CONTROL register. Receive levels beyond the
+  // FIFO depth could never be reached, so they are limited to it.
+  always_comb begin
+    unique case (reg2hw.control.rx_watermark.q)
+      4'd0:    rx_watermark_level = 9'd1;
+      4'd1:    rx_watermark_level = 9'd2;
+      4'd2:    rx_watermark_level = 9'd4;
+      4'd3:    rx_watermark_level = 9'd8;
+      4'd4:    rx_watermark_level = 9'd16;
+      4'd5:    rx_watermark_level = 9'd32;
+      4'd7:    rx_watermark_level = 9'(RxFifoDepth / 2);
+      default: rx_watermark_level = 9'(RxFifoDepth - 8);
+    endcase
+    if (rx_watermark_level > 9'(RxFifoDepth)) begin
+      rx_watermark_level = 9'(RxFifoDepth);
+    end
+
+    unique case (reg2hw.control.tx_watermark.q)
+      4'd0:    tx_watermark_level = 9'd1;
+      4'd1:    tx_watermark_level = 9'd2;
+      4'd2:    tx_watermark_level = 9'd4;
+      4'd3:    tx_watermark_level = 9'd8;
+      4'd5:    tx_watermark_level = 9'd32;
+      4'd6:    tx_watermark_level = 9'(TxFifoDepth / 2);
+      default: tx_watermark_level = 9'd16;
+    endcase
+  end
+
+  logic spi_idle_q;
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      spi_idle_q <= 1'b1;
+    end else begin
+      spi_idle_q <= spi_idle;
+    end
+  end
+
+  logic event_rx_full, event_rx_watermark, event_tx_empty, event_tx_watermark, event_complete;
+
+  assign event_rx_full      = rx_fifo_full;
+  assign event_rx_watermark = 9'(rx_fifo_depth) >= rx_watermark_level;
+  assign event_tx_empty     = tx_fifo_depth == '0;
+  assign event_tx_watermark = 9'(tx_fifo_depth) <= tx_watermark_level;
+  assign event_complete     = spi_idle & ~spi_idle_q;
+
+  prim_intr_hw #(.Width(1), .IntrT("Status")) intr_hw_rx_full (
+    .clk_i,
+    .rst_ni,
+    .event_intr_i           (event_rx_full),
+    .reg2hw_intr_enable_q_i (reg2hw.intr_enable.rx_full.q),
+    .reg2hw_intr_test_q_i   (reg2hw.intr_test.rx_full.q),
+    .reg2hw_intr_test_qe_i  (reg2hw.intr_test.rx_full.qe),
+    .reg2hw_intr_state_q_i  (reg2hw.intr_state.rx_full.q),
+    .hw2reg_intr_state_de_o (hw2reg.intr_state.rx_full.de),
+    .hw2reg_intr_state_d_o  (hw2reg.intr_state.rx_full.d),
+    .intr_o                 (intr_rx_full_o)
+  );
+
+  prim_intr_hw #(.Width(1), .IntrT("Status")) intr_hw_rx_watermark (
+    .clk_i,
+    .rst_ni,
+    .event_intr_i           (event_rx_watermark),
+    .reg2hw_intr_enable_q_i (reg2hw.intr_enable.rx_watermark.q),
+    .reg2hw_intr_test_q_i   (reg2hw.intr_test.rx_watermark.q),
+    .reg2hw_intr_test_qe_i  (reg2hw.intr_test.rx_watermark.qe),
+    .reg2hw_intr_state_q_i  (reg2hw.intr_state.rx_watermark.q),
+    .hw2reg_intr_state_de_o (hw2reg.intr_state.rx_watermark.de),
+    .hw2reg_intr_state_d_o  (hw2reg.intr_state.rx_watermark.d),
+    .intr_o                 (intr_rx_watermark_o)
+  );
+
+  prim_intr_hw #(.Width(1), .IntrT("Status")) intr_hw_tx_empty (
+    .clk_i,
+    .rst_ni,
+    .event_intr_i           (event_tx_empty),
+    .reg2hw_intr_enable_q_i (reg2hw.intr_enable.tx_empty.q),
+    .reg2hw_intr_test_q_i   (reg2hw.intr_test.tx_empty.q),
+    .reg2hw_intr_test_qe_i  (reg2hw.intr_test.tx_empty.qe),
+    .reg2hw_intr_state_q_i  (reg2hw.intr_state.tx_empty.q),
+    .hw2reg_intr_state_de_o (hw2reg.intr_state.tx_empty.de),
+    .hw2reg_intr_state_d_o  (hw2reg.intr_state.tx_empty.d),
+    .intr_o                 (intr_tx_empty_o)
+  );
+
+  prim_intr_hw #(.Width(1), .IntrT("Status")) intr_hw_tx_watermark (
+    .clk_i,
+    .rst_ni,
+    .event_intr_i           (event_tx_watermark),
+    .reg2hw_intr_enable_q_i (reg2hw.intr_enable.tx_watermark.q),
+    .reg2hw_intr_test_q_i   (reg2hw.intr_test.tx_watermark.q),
+    .reg2hw_intr_test_qe_i  (reg2hw.intr_test.tx_watermark.qe),
+    .reg2hw_intr_state_q_i  (reg2hw.intr_state.tx_watermark.q),
+    .hw2reg_intr_state_de_o (hw2reg.intr_state.tx_watermark.de),
+    .hw2reg_intr_state_d_o  (hw2reg.intr_state.tx_watermark.d),
+    .intr_o                 (intr_tx_watermark_o)
+  );
+
+  prim_intr_hw #(.Width(1)) intr_hw_complete (
+    .clk_i,
+    .rst_ni,
+    .event_intr_i           (event_complete),
+    .reg2hw_intr_enable_q_i (reg2hw.intr_enable.complete.q),
+    .reg2hw_intr_test_q_i   (reg2hw.intr_test.complete.q),
+    .reg2hw_intr_test_qe_i  (reg2hw.intr_test.complete.qe),
+    .reg2hw_intr_state_q_i  (reg2hw.intr_state.complete.q),
+    .hw2reg_intr_state_de_o (hw2reg.intr_state.complete.de),
+    .hw2reg_intr_state_d_o  (hw2reg.intr_state.complete.d),
+    .intr_o                 (intr_complete_o)
+  );
 
-  assign intr_rx_full_o      = 1'b0;
-  assign intr_rx_watermark_o = 1'b0;
-  assign intr_tx_empty_o     = 1'b0;
-  assign intr_tx_watermark_o = 1'b0;
-  assign intr_complete_o     = 1'b0;
+  // FIFO levels and depths are reported in 8-bit STATUS and INFO fields.
+  `ASSERT_INIT(RxFifoDepthMax_A, RxFifoDepth <= 128)
+  `ASSERT_INIT(TxFifoDepthMax_A, TxFifoDepth <= 128)
 endmodule
@@ -0,0 +1,72 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+`include "prim_assert.sv"
+
+// Byte FIFO that can push and pop up to four bytes per cycle, so software can move a whole 32-bit
+// word to or from the SPI block with a single bus access. Bytes are packed little-endian: the
+// first byte pushed or popped is in bits 7:0. Pushes beyond the free space and pops beyond the
+// number of stored bytes are truncated.
+module spi_fifo #(
+  parameter  int unsigned Depth  = 64,
+  localparam int unsigned DepthW = prim_util_pkg::vbits(Depth+1),
+  localparam int unsigned PtrW   = prim_util_pkg::vbits(Depth)
+) (
+  input clk_i,
+  input rst_ni,
+
+  input  logic              clr_i,
+
+  input  logic [2:0]        push_count_i,
+  input  logic [31:0]       wdata_i,
+
+  input  logic [2:0]        pop_count_i,
+  output logic [31:0]       rdata_o,
+
+  output logic              full_o,
+  output logic [DepthW-1:0] depth_o
+);
+  logic [7:0]        mem_q [Depth];
+  logic [PtrW-1:0]   wptr_q, rptr_q;
+  logic [DepthW-1:0] depth_q, space;
+  logic [2:0]        push, pop;
+
+  assign space = DepthW'(Depth) - depth_q;
+  assign push  = DepthW'(push_count_i) > space   ? space[2:0]   : push_count_i;
+  assign pop   = DepthW'(pop_count_i)  > depth_q ? depth_q[2:0] : pop_count_i;
+
+  always_ff @(posedge clk_i) begin
+    for (int unsigned i = 0; i < 4; i++) begin
+      if (3'(i) < push) begin
+        mem_q[wptr_q + PtrW'(i)] <= wdata_i[i*8 +: 8];
+      end
+    end
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      wptr_q  <= '0;
+      rptr_q  <= '0;
+      depth_q <= '0;
+    end else if (clr_i) begin
+      wptr_q  <= '0;
+      rptr_q  <= '0;
+      depth_q <= '0;
+    end else begin
+      wptr_q  <= wptr_q + PtrW'(push);
+      rptr_q  <= rptr_q + PtrW'(pop);
+      depth_q <= depth_q + DepthW'(push) - DepthW'(pop);
+    end
+  end
+
+  for (genvar i = 0; i < 4; i++) begin : g_rdata
+    assign rdata_o[i*8 +: 8] = mem_q[rptr_q + PtrW'(i)];
+  end
+
+  assign full_o  = depth_q == DepthW'(Depth);
+  assign depth_o = depth_q;
+
+  // Pointers wrap by overflowing, so the depth must be a power of two.
+  `ASSERT_INIT(DepthPow2_A, Depth >= 4 && (Depth & (Depth - 1)) == 0)
+endmodule
@@ -53,9 +53,9 @@ module spi_reg_top (
 
   // also check for spurious write enables
   logic reg_we_err;
-  logic [8:0] reg_we_check;
+  logic [12:0] reg_we_check;
   prim_reg_we_check #(
-    .OneHotWidth(9)
+    .OneHotWidth(13)
   ) u_prim_reg_we_check (
     .clk_i(clk_i),
     .rst_ni(rst_ni),
@@ -178,6 +178,18 @@ module spi_reg_top (
   logic [7:0] rx_fifo_qs;
   logic tx_fifo_we;
   logic [7:0] tx_fifo_wd;
+  logic rx_fifo_word_re;
+  logic [31:0] rx_fifo_word_qs;
+  logic tx_fifo_word_we;
+  logic [31:0] tx_fifo_word_wd;
+  logic cs_we;
+  logic [3:0] cs_select_qs;
+  logic [3:0] cs_select_wd;
+  logic cs_hold_qs;
+  logic cs_hold_wd;
+  logic info_re;
+  logic [7:0] info_tx_fifo_depth_qs;
+  logic [7:0] info_rx_fifo_depth_qs;
 
   // Register instances
   // R[intr_state]: V(False)
@@ -1003,19 +1015,167 @@ module spi_reg_top (
   assign reg2hw.tx_fifo.qe = tx_fifo_qe;
 
 
+  // R[rx_fifo_word]: V(True)
+  prim_subreg_ext #(
+    .DW    (32)
+  ) u_rx_fifo_word (
+    .re     (rx_fifo_word_re),
+    .we     (1'b0),
+    .wd     ('0),
+    .d      (hw2reg.rx_fifo_word.d),
+    .qre    (reg2hw.rx_fifo_word.re),
+    .qe     (),
+    .q      (reg2hw.rx_fifo_word.q),
+    .ds     (),
+    .qs     (rx_fifo_word_qs)
+  );
+
+
+  // R[tx_fifo_word]: V(False)
+  logic tx_fifo_word_qe;
+  logic [0:0] tx_fifo_word_flds_we;
+  prim_flop #(
+    .Width(1),
+    .ResetValue(0)
+  ) u_tx_fifo_word0_qe (
+    .clk_i(clk_i),
+    .rst_ni(rst_ni),
+    .d_i(&tx_fifo_word_flds_we),
+    .q_o(tx_fifo_word_qe)
+  );
+  prim_subreg #(
+    .DW      (32),
+    .SwAccess(prim_subreg_pkg::SwAccessWO),
+    .RESVAL  (32'h0),
+    .Mubi    (1'b0)
+  ) u_tx_fifo_word (
+    .clk_i   (clk_i),
+    .rst_ni  (rst_ni),
+
+    // from register interface
+    .we     (tx_fifo_word_we),
+    .wd     (tx_fifo_word_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0),
+
+    // to internal hardware
+    .qe     (tx_fifo_word_flds_we[0]),
+    .q      (reg2hw.tx_fifo_word.q),
+    .ds     (),
 
-  logic [8:0] addr_hit;
+    // to register interface (read)
+    .qs     ()
+  );
+  assign reg2hw.tx_fifo_word.qe = tx_fifo_word_qe;
+
+
+  // R[cs]: V(False)
+  //   F[select]: 3:0
+  prim_subreg #(
+    .DW      (4),
+    .SwAccess(prim_subreg_pkg::SwAccessRW),
+    .RESVAL  (4'h0),
+    .Mubi    (1'b0)
+  ) u_cs_select (
+    .clk_i   (clk_i),
+    .rst_ni  (rst_ni),
+
+    // from register interface
+    .we     (cs_we),
+    .wd     (cs_select_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.cs.select.q),
+    .ds     (),
+
+    // to register interface (read)
+    .qs     (cs_select_qs)
+  );
+
+  //   F[hold]: 31:31
+  prim_subreg #(
+    .DW      (1),
+    .SwAccess(prim_subreg_pkg::SwAccessRW),
+    .RESVAL  (1'h0),
+    .Mubi    (1'b0)
+  ) u_cs_hold (
+    .clk_i   (clk_i),
+    .rst_ni  (rst_ni),
+
+    // from register interface
+    .we     (cs_we),
+    .wd     (cs_hold_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.cs.hold.q),
+    .ds     (),
+
+    // to register interface (read)
+    .qs     (cs_hold_qs)
+  );
+
+
+  // R[info]: V(True)
+  //   F[tx_fifo_depth]: 7:0
+  prim_subreg_ext #(
+    .DW    (8)
+  ) u_info_tx_fifo_depth (
+    .re     (info_re),
+    .we     (1'b0),
+    .wd     ('0),
+    .d      (hw2reg.info.tx_fifo_depth.d),
+    .qre    (),
+    .qe     (),
+    .q      (),
+    .ds     (),
+    .qs     (info_tx_fifo_depth_qs)
+  );
+
+  //   F[rx_fifo_depth]: 15:8
+  prim_subreg_ext #(
+    .DW    (8)
+  ) u_info_rx_fifo_depth (
+    .re     (info_re),
+    .we     (1'b0),
+    .wd     ('0),
+    .d      (hw2reg.info.rx_fifo_depth.d),
+    .qre    (),
+    .qe     (),
+    .q      (),
+    .ds     (),
+    .qs     (info_rx_fifo_depth_qs)
+  );
+
+
+
+  logic [12:0] addr_hit;
   always_comb begin
     addr_hit = '0;
-    addr_hit[0] = (reg_addr == SPI_INTR_STATE_OFFSET);
-    addr_hit[1] = (reg_addr == SPI_INTR_ENABLE_OFFSET);
-    addr_hit[2] = (reg_addr == SPI_INTR_TEST_OFFSET);
-    addr_hit[3] = (reg_addr == SPI_CFG_OFFSET);
-    addr_hit[4] = (reg_addr == SPI_CONTROL_OFFSET);
-    addr_hit[5] = (reg_addr == SPI_STATUS_OFFSET);
-    addr_hit[6] = (reg_addr == SPI_START_OFFSET);
-    addr_hit[7] = (reg_addr == SPI_RX_FIFO_OFFSET);
-    addr_hit[8] = (reg_addr == SPI_TX_FIFO_OFFSET);
+    addr_hit[ 0] = (reg_addr == SPI_INTR_STATE_OFFSET);
+    addr_hit[ 1] = (reg_addr == SPI_INTR_ENABLE_OFFSET);
+    addr_hit[ 2] = (reg_addr == SPI_INTR_TEST_OFFSET);
+    addr_hit[ 3] = (reg_addr == SPI_CFG_OFFSET);
+    addr_hit[ 4] = (reg_addr == SPI_CONTROL_OFFSET);
+    addr_hit[ 5] = (reg_addr == SPI_STATUS_OFFSET);
+    addr_hit[ 6] = (reg_addr == SPI_START_OFFSET);
+    addr_hit[ 7] = (reg_addr == SPI_RX_FIFO_OFFSET);
+    addr_hit[ 8] = (reg_addr == SPI_TX_FIFO_OFFSET);
+    addr_hit[ 9] = (reg_addr == SPI_RX_FIFO_WORD_OFFSET);
+    addr_hit[10] = (reg_addr == SPI_TX_FIFO_WORD_OFFSET);
+    addr_hit[11] = (reg_addr == SPI_CS_OFFSET);
+    addr_hit[12] = (reg_addr == SPI_INFO_OFFSET);
   end
 
   assign addrmiss = (reg_re || reg_we) ? ~|addr_hit : 1'b0 ;
@@ -1023,15 +1183,19 @@ module spi_reg_top (
   // Check sub-word write is permitted
   always_comb begin
     wr_err = (reg_we &
-              ((addr_hit[0] & (|(SPI_PERMIT[0] & ~reg_be))) |
-               (addr_hit[1] & (|(SPI_PERMIT[1] & ~reg_be))) |
-               (addr_hit[2] & (|(SPI_PERMIT[2] & ~reg_be))) |
-               (addr_hit[3] & (|(SPI_PERMIT[3] & ~reg_be))) |
-               (addr_hit[4] & (|(SPI_PERMIT[4] & ~reg_be))) |
-               (addr_hit[5] & (|(SPI_PERMIT[5] & ~reg_be))) |
-               (addr_hit[6] & (|(SPI_PERMIT[6] & ~reg_be))) |
-               (addr_hit[7] & (|(SPI_PERMIT[7] & ~reg_be))) |
-               (addr_hit[8] & (|(SPI_PERMIT[8] & ~reg_be)))));
+              ((addr_hit[ 0] & (|(SPI_PERMIT[ 0] & ~reg_be))) |
+               (addr_hit[ 1] & (|(SPI_PERMIT[ 1] & ~reg_be))) |
+               (addr_hit[ 2] & (|(SPI_PERMIT[ 2] & ~reg_be))) |
+               (addr_hit[ 3] & (|(SPI_PERMIT[ 3] & ~reg_be))) |
+               (addr_hit[ 4] & (|(SPI_PERMIT[ 4] & ~reg_be))) |
+               (addr_hit[ 5] & (|(SPI_PERMIT[ 5] & ~reg_be))) |
+               (addr_hit[ 6] & (|(SPI_PERMIT[ 6] & ~reg_be))) |
+               (addr_hit[ 7] & (|(SPI_PERMIT[ 7] & ~reg_be))) |
+               (addr_hit[ 8] & (|(SPI_PERMIT[ 8] & ~reg_be))) |
+               (addr_hit[ 9] & (|(SPI_PERMIT[ 9] & ~reg_be))) |
+               (addr_hit[10] & (|(SPI_PERMIT[10] & ~reg_be))) |
+               (addr_hit[11] & (|(SPI_PERMIT[11] & ~reg_be))) |
+               (addr_hit[12] & (|(SPI_PERMIT[12] & ~reg_be)))));
   end
 
   // Generate write-enables
@@ -1090,6 +1254,16 @@ module spi_reg_top (
   assign tx_fifo_we = addr_hit[8] & reg_we & !reg_error;
 
   assign tx_fifo_wd = reg_wdata[7:0];
+  assign rx_fifo_word_re = addr_hit[9] & reg_re & !reg_error;
+  assign tx_fifo_word_we = addr_hit[10] & reg_we & !reg_error;
+
+  assign tx_fifo_word_wd = reg_wdata[31:0];
+  assign cs_we = addr_hit[11] & reg_we & !reg_error;
+
+  assign cs_select_wd = reg_wdata[3:0];
+
+  assign cs_hold_wd = reg_wdata[31];
+  assign info_re = addr_hit[12] & reg_re & !reg_error;
 
   // Assign write-enables to checker logic vector.
   always_comb begin
@@ -1103,6 +1277,10 @@ module spi_reg_top (
     reg_we_check[6] = start_we;
     reg_we_check[7] = 1'b0;
     reg_we_check[8] = tx_fifo_we;
+    reg_we_check[9] = 1'b0;
+    reg_we_check[10] = tx_fifo_word_we;
+    reg_we_check[11] = cs_we;
+    reg_we_check[12] = 1'b0;
   end
 
   // Read data return
@@ -1169,6 +1347,24 @@ module spi_reg_top (
         reg_rdata_next[7:0] = '0;
       end
 
+      addr_hit[9]: begin
+        reg_rdata_next[31:0] = rx_fifo_word_qs;
+      end
+
+      addr_hit[10]: begin
+        reg_rdata_next[31:0] = '0;
+      end
+
+      addr_hit[11]: begin
+        reg_rdata_next[3:0] = cs_select_qs;
+        reg_rdata_next[31] = cs_hold_qs;
+      end
+
+      addr_hit[12]: begin
+        reg_rdata_next[7:0] = info_tx_fifo_depth_qs;
+        reg_rdata_next[15:8] = info_rx_fifo_depth_qs;
+      end
+
       default: begin
         reg_rdata_next = '1;
       end
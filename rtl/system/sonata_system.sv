@@ -82,37 +82,44 @@ module sonata_system #(
   input  logic                     spi_flash_rx_i,
   output logic                     spi_flash_tx_o,
   output logic                     spi_flash_sck_o,
+  output logic [3:0]               spi_flash_cs_no,
 
   // SPI for LCD screen
   input  logic                     spi_lcd_rx_i,
   output logic                     spi_lcd_tx_o,
   output logic                     spi_lcd_sck_o,
+  output logic [3:0]               spi_lcd_cs_no,
 
   // SPI for ethernet
   input  logic                     spi_eth_rx_i,
   output logic                     spi_eth_tx_o,
   output logic                     spi_eth_sck_o,
+  output logic [3:0]               spi_eth_cs_no,
   input  logic                     spi_eth_irq_ni, // Interrupt from Ethernet MAC
 
   // SPI0 on the R-Pi header
   input  logic                     spi_rp0_rx_i,
   output logic                     spi_rp0_tx_o,
   output logic                     spi_rp0_sck_o,
+  output logic [3:0]               spi_rp0_cs_no,
 
   // SPI1 on the R-Pi header
   input  logic                     spi_rp1_rx_i,
   output logic                     spi_rp1_tx_o,
   output logic                     spi_rp1_sck_o,
+  output logic [3:0]               spi_rp1_cs_no,
 
   // SPI on Arduino shield
   input  logic                     spi_ard_rx_i,
   output logic                     spi_ard_tx_o,
   output logic                     spi_ard_sck_o,
+  output logic [3:0]               spi_ard_cs_no,
 
   // SPI on mikroBUS Click
   input  logic                     spi_mkr_rx_i,
   output logic                     spi_mkr_tx_o,
   output logic                     spi_mkr_sck_o,
+  output logic [3:0]               spi_mkr_cs_no,
 
   // User JTAG
   input  logic                     tck_i,   // JTAG test clock pad
@@ -300,9 +307,97 @@ module sonata_system #(
 
   logic spi_eth_irq;
 
+  logic spi_flash_rx_full_irq;
+  logic spi_flash_rx_watermark_irq;
+  logic spi_flash_tx_empty_irq;
+  logic spi_flash_tx_watermark_irq;
+  logic spi_flash_complete_irq;
+
+  logic spi_lcd_rx_full_irq;
+  logic spi_lcd_rx_watermark_irq;
+  logic spi_lcd_tx_empty_irq;
+  logic spi_lcd_tx_watermark_irq;
+  logic spi_lcd_complete_irq;
+
+  logic spi_eth_rx_full_irq;
+  logic spi_eth_rx_watermark_irq;
+  logic spi_eth_tx_empty_irq;
+  logic spi_eth_tx_watermark_irq;
+  logic spi_eth_complete_irq;
+
+  logic spi_rp0_rx_full_irq;
+  logic spi_rp0_rx_watermark_irq;
+  logic spi_rp0_tx_empty_irq;
+  logic spi_rp0_tx_watermark_irq;
+  logic spi_rp0_complete_irq;
+
+  logic spi_rp1_rx_full_irq;
+  logic spi_rp1_rx_watermark_irq;
+  logic spi_rp1_tx_empty_irq;
+  logic spi_rp1_tx_watermark_irq;
+  logic spi_rp1_complete_irq;
+
+  logic spi_ard_rx_full_irq;
+  logic spi_ard_rx_watermark_irq;
+  logic spi_ard_tx_empty_irq;
+  logic spi_ard_tx_watermark_irq;
+  logic spi_ard_complete_irq;
+
+  logic spi_mkr_rx_full_irq;
+  logic spi_mkr_rx_watermark_irq;
+  logic spi_mkr_tx_empty_irq;
+  logic spi_mkr_tx_watermark_irq;
+  logic spi_mkr_complete_irq;
+
+  logic dma_done_irq;
+
   logic [181:0] intr_vector;
   always_comb begin : interrupt_vector
-    intr_vector[73 +: 109] = 109'b0;
+    intr_vector[109 +: 73] = 73'b0;
+
+    intr_vector[108 +: 1] = dma_done_irq;
+
+    intr_vector[107 +: 1] = spi_mkr_complete_irq;
+    intr_vector[106 +: 1] = spi_mkr_tx_watermark_irq;
+    intr_vector[105 +: 1] = spi_mkr_tx_empty_irq;
+    intr_vector[104 +: 1] = spi_mkr_rx_watermark_irq;
+    intr_vector[103 +: 1] = spi_mkr_rx_full_irq;
+
+    intr_vector[102 +: 1] = spi_ard_complete_irq;
+    intr_vector[101 +: 1] = spi_ard_tx_watermark_irq;
+    intr_vector[100 +: 1] = spi_ard_tx_empty_irq;
+    intr_vector[99 +: 1]  = spi_ard_rx_watermark_irq;
+    intr_vector[98 +: 1]  = spi_ard_rx_full_irq;
+
+    intr_vector[97 +: 1] = spi_rp1_complete_irq;
+    intr_vector[96 +: 1] = spi_rp1_tx_watermark_irq;
+    intr_vector[95 +: 1] = spi_rp1_tx_empty_irq;
+    intr_vector[94 +: 1] = spi_rp1_rx_watermark_irq;
+    intr_vector[93 +: 1] = spi_rp1_rx_full_irq;
+
+    intr_vector[92 +: 1] = spi_rp0_complete_irq;
+    intr_vector[91 +: 1] = spi_rp0_tx_watermark_irq;
+    intr_vector[90 +: 1] = spi_rp0_tx_empty_irq;
+    intr_vector[89 +: 1] = spi_rp0_rx_watermark_irq;
+    intr_vector[88 +: 1] = spi_rp0_rx_full_irq;
+
+    intr_vector[87 +: 1] = spi_eth_complete_irq;
+    intr_vector[86 +: 1] = spi_eth_tx_watermark_irq;
+    intr_vector[85 +: 1] = spi_eth_tx_empty_irq;
+    intr_vector[84 +: 1] = spi_eth_rx_watermark_irq;
+    intr_vector[83 +: 1] = spi_eth_rx_full_irq;
+
+    intr_vector[82 +: 1] = spi_lcd_complete_irq;
+    intr_vector[81 +: 1] = spi_lcd_tx_watermark_irq;
+    intr_vector[80 +: 1] = spi_lcd_tx_empty_irq;
+    intr_vector[79 +: 1] = spi_lcd_rx_watermark_irq;
+    intr_vector[78 +: 1] = spi_lcd_rx_full_irq;
+
+    intr_vector[77 +: 1] = spi_flash_complete_irq;
+    intr_vector[76 +: 1] = spi_flash_tx_watermark_irq;
+    intr_vector[75 +: 1] = spi_flash_tx_empty_irq;
+    intr_vector[74 +: 1] = spi_flash_rx_watermark_irq;
+    intr_vector[73 +: 1] = spi_flash_rx_full_irq;
 
     intr_vector[72 +: 1] = hardware_revoker_irq;
 
@@ -491,6 +586,11 @@ module sonata_system #(
   tlul_pkg::tl_h2d_t tl_dbg_host_h2d_q;
   tlul_pkg::tl_d2h_t tl_dbg_host_d2h_q;
 
+  tlul_pkg::tl_h2d_t tl_dma_host_h2d_d;
+  tlul_pkg::tl_d2h_t tl_dma_host_d2h_d;
+  tlul_pkg::tl_h2d_t tl_dma_host_h2d_q;
+  tlul_pkg::tl_d2h_t tl_dma_host_d2h_q;
+
   // Device interfaces.
   tlul_pkg::tl_h2d_t tl_sram_a_h2d_d;
   tlul_pkg::tl_d2h_t tl_sram_a_d2h_d;
@@ -512,6 +612,8 @@ module sonata_system #(
   tlul_pkg::tl_d2h_t tl_pmod_gpio_d2h;
   tlul_pkg::tl_h2d_t tl_xadc_h2d;
   tlul_pkg::tl_d2h_t tl_xadc_d2h;
+  tlul_pkg::tl_h2d_t tl_dma_h2d;
+  tlul_pkg::tl_d2h_t tl_dma_d2h;
   tlul_pkg::tl_h2d_t tl_uart0_h2d;
   tlul_pkg::tl_d2h_t tl_uart0_d2h;
   tlul_pkg::tl_h2d_t tl_uart1_h2d;
@@ -567,6 +669,8 @@ module sonata_system #(
     .tl_ibex_lsu_o    (tl_ibex_lsu_d2h_q),
     .tl_dbg_host_i    (tl_dbg_host_h2d_q),
     .tl_dbg_host_o    (tl_dbg_host_d2h_q),
+    .tl_dma_host_i    (tl_dma_host_h2d_q),
+    .tl_dma_host_o    (tl_dma_host_d2h_q),
 
     // Device interfaces.
     .tl_sram_o        (tl_sram_a_h2d_d),
@@ -591,6 +695,8 @@ module sonata_system #(
     .tl_hw_rev_i      (tl_hw_rev_d2h),
     .tl_xadc_o        (tl_xadc_h2d),
     .tl_xadc_i        (tl_xadc_d2h),
+    .tl_dma_o         (tl_dma_h2d),
+    .tl_dma_i         (tl_dma_d2h),
     .tl_timer_o       (tl_timer_h2d),
     .tl_timer_i       (tl_timer_d2h),
     .tl_uart0_o       (tl_uart0_h2d),
@@ -763,6 +869,27 @@ module sonata_system #(
     .spare_rsp_o (    )
   );
 
+  // This latch is necessary to avoid circular logic. This shows up as an `UNOPTFLAT` warning in Verilator.
+  tlul_fifo_sync #(
+    .ReqPass  ( 0 ),
+    .RspPass  ( 0 ),
+    .ReqDepth ( 2 ),
+    .RspDepth ( 2 )
+  ) tl_dma_host_fifo (
+    .clk_i       (clk_sys_i),
+    .rst_ni      (rst_sys_ni),
+
+    .tl_h_i      (tl_dma_host_h2d_d),
+    .tl_h_o      (tl_dma_host_d2h_d),
+    .tl_d_o      (tl_dma_host_h2d_q),
+    .tl_d_i      (tl_dma_host_d2h_q),
+
+    .spare_req_i (1'b0),
+    .spare_req_o (    ),
+    .spare_rsp_i (1'b0),
+    .spare_rsp_o (    )
+  );
+
   // This latch is necessary to avoid circular logic. This shows up as an `UNOPTFLAT` warning in Verilator.
   tlul_fifo_sync #(
     .ReqPass  ( 0 ),
@@ -1631,8 +1758,26 @@ module sonata_system #(
     .intr_av_setup_empty_o        ()
   );
 
+  // DMA pacing signals from the SPI blocks, in address order.
+  localparam int unsigned NumSpi = 7;
+
+  logic [NumSpi-1:0] spi_dma_tx_ready;
+  logic [NumSpi-1:0] spi_dma_rx_ready;
+  logic [NumSpi-1:0] spi_idle;
+
+  // FIFO depths of the SPI blocks. The LCD and Ethernet stream whole frames so get deep FIFOs,
+  // with little need to receive from the LCD, while the header SPIs stay small.
+  localparam int unsigned SpiFlashFifoDepth  = 64;
+  localparam int unsigned SpiLcdTxFifoDepth  = 128;
+  localparam int unsigned SpiLcdRxFifoDepth  = 16;
+  localparam int unsigned SpiEthFifoDepth    = 128;
+  localparam int unsigned SpiHeaderFifoDepth = 16;
+
   // SPI host for talking to Flash memory.
-  spi u_spi_flash (
+  spi #(
+    .RxFifoDepth ( SpiFlashFifoDepth ),
+    .TxFifoDepth ( SpiFlashFifoDepth )
+  ) u_spi_flash (
     .clk_i               (clk_sys_i),
     .rst_ni              (rst_sys_ni),
 
@@ -1640,21 +1785,30 @@ module sonata_system #(
     .tl_i                (tl_spi_flash_h2d),
     .tl_o                (tl_spi_flash_d2h),
 
-    // Interrupts currently disconnected.
-    .intr_rx_full_o      (),
-    .intr_rx_watermark_o (),
-    .intr_tx_empty_o     (),
-    .intr_tx_watermark_o (),
-    .intr_complete_o     (),
+    // Interrupts.
+    .intr_rx_full_o      (spi_flash_rx_full_irq),
+    .intr_rx_watermark_o (spi_flash_rx_watermark_irq),
+    .intr_tx_empty_o     (spi_flash_tx_empty_irq),
+    .intr_tx_watermark_o (spi_flash_tx_watermark_irq),
+    .intr_complete_o     (spi_flash_complete_irq),
+
+    // DMA pacing.
+    .dma_tx_ready_o      (spi_dma_tx_ready[0]),
+    .dma_rx_ready_o      (spi_dma_rx_ready[0]),
+    .idle_o              (spi_idle[0]),
 
     // SPI signals.
     .spi_copi_o          (spi_flash_tx_o),
     .spi_cipo_i          (spi_flash_rx_i),
-    .spi_clk_o           (spi_flash_sck_o)
+    .spi_clk_o           (spi_flash_sck_o),
+    .spi_cs_no           (spi_flash_cs_no)
   );
 
   // SPI host for writing to the LCD screen.
-  spi u_spi_lcd (
+  spi #(
+    .RxFifoDepth ( SpiLcdRxFifoDepth ),
+    .TxFifoDepth ( SpiLcdTxFifoDepth )
+  ) u_spi_lcd (
     .clk_i               (clk_sys_i),
     .rst_ni              (rst_sys_ni),
 
@@ -1662,21 +1816,30 @@ module sonata_system #(
     .tl_i                (tl_spi_lcd_h2d),
     .tl_o                (tl_spi_lcd_d2h),
 
-    // Interrupts currently disconnected.
-    .intr_rx_full_o      (),
-    .intr_rx_watermark_o (),
-    .intr_tx_empty_o     (),
-    .intr_tx_watermark_o (),
-    .intr_complete_o     (),
+    // Interrupts.
+    .intr_rx_full_o      (spi_lcd_rx_full_irq),
+    .intr_rx_watermark_o (spi_lcd_rx_watermark_irq),
+    .intr_tx_empty_o     (spi_lcd_tx_empty_irq),
+    .intr_tx_watermark_o (spi_lcd_tx_watermark_irq),
+    .intr_complete_o     (spi_lcd_complete_irq),
+
+    // DMA pacing.
+    .dma_tx_ready_o      (spi_dma_tx_ready[1]),
+    .dma_rx_ready_o      (spi_dma_rx_ready[1]),
+    .idle_o              (spi_idle[1]),
 
     // SPI signals.
     .spi_copi_o          (spi_lcd_tx_o),
     .spi_cipo_i          (spi_lcd_rx_i),
-    .spi_clk_o           (spi_lcd_sck_o)
+    .spi_clk_o           (spi_lcd_sck_o),
+    .spi_cs_no           (spi_lcd_cs_no)
   );
 
   // SPI host for talking to ethernet chip.
-  spi u_spi_eth (
+  spi #(
+    .RxFifoDepth ( SpiEthFifoDepth ),
+    .TxFifoDepth ( SpiEthFifoDepth )
+  ) u_spi_eth (
     .clk_i               (clk_sys_i),
     .rst_ni              (rst_sys_ni),
 
@@ -1684,17 +1847,23 @@ module sonata_system #(
     .tl_i                (tl_spi_eth_h2d),
     .tl_o                (tl_spi_eth_d2h),
 
-    // Interrupts currently disconnected.
-    .intr_rx_full_o      (),
-    .intr_rx_watermark_o (),
-    .intr_tx_empty_o     (),
-    .intr_tx_watermark_o (),
-    .intr_complete_o     (),
+    // Interrupts.
+    .intr_rx_full_o      (spi_eth_rx_full_irq),
+    .intr_rx_watermark_o (spi_eth_rx_watermark_irq),
+    .intr_tx_empty_o     (spi_eth_tx_empty_irq),
+    .intr_tx_watermark_o (spi_eth_tx_watermark_irq),
+    .intr_complete_o     (spi_eth_complete_irq),
+
+    // DMA pacing.
+    .dma_tx_ready_o      (spi_dma_tx_ready[2]),
+    .dma_rx_ready_o      (spi_dma_rx_ready[2]),
+    .idle_o              (spi_idle[2]),
 
     // SPI signals.
     .spi_copi_o          (spi_eth_tx_o),
     .spi_cipo_i          (spi_eth_rx_i),
-    .spi_clk_o           (spi_eth_sck_o)
+    .spi_clk_o           (spi_eth_sck_o),
+    .spi_cs_no           (spi_eth_cs_no)
   );
 
   // Sample the ethernet interrupt pin.
@@ -1707,79 +1876,135 @@ module sonata_system #(
   end
 
   // Host for SPI0 on the Raspberry Pi HAT.
-  spi u_spi_rp0 (
+  spi #(
+    .RxFifoDepth ( SpiHeaderFifoDepth ),
+    .TxFifoDepth ( SpiHeaderFifoDepth )
+  ) u_spi_rp0 (
     .clk_i               (clk_sys_i),
     .rst_ni              (rst_sys_ni),
 
     .tl_i                (tl_spi_rp0_h2d),
     .tl_o                (tl_spi_rp0_d2h),
 
-    .intr_rx_full_o      (),
-    .intr_rx_watermark_o (),
-    .intr_tx_empty_o     (),
-    .intr_tx_watermark_o (),
-    .intr_complete_o     (),
+    .intr_rx_full_o      (spi_rp0_rx_full_irq),
+    .intr_rx_watermark_o (spi_rp0_rx_watermark_irq),
+    .intr_tx_empty_o     (spi_rp0_tx_empty_irq),
+    .intr_tx_watermark_o (spi_rp0_tx_watermark_irq),
+    .intr_complete_o     (spi_rp0_complete_irq),
+
+    // DMA pacing.
+    .dma_tx_ready_o      (spi_dma_tx_ready[3]),
+    .dma_rx_ready_o      (spi_dma_rx_ready[3]),
+    .idle_o              (spi_idle[3]),
 
     .spi_copi_o          (spi_rp0_tx_o),
     .spi_cipo_i          (spi_rp0_rx_i),
-    .spi_clk_o           (spi_rp0_sck_o)
+    .spi_clk_o           (spi_rp0_sck_o),
+    .spi_cs_no           (spi_rp0_cs_no)
   );
 
   // Host for SPI1 on the Raspberry Pi HAT.
-  spi u_spi_rp1 (
+  spi #(
+    .RxFifoDepth ( SpiHeaderFifoDepth ),
+    .TxFifoDepth ( SpiHeaderFifoDepth )
+  ) u_spi_rp1 (
     .clk_i               (clk_sys_i),
     .rst_ni              (rst_sys_ni),
 
     .tl_i                (tl_spi_rp1_h2d),
     .tl_o                (tl_spi_rp1_d2h),
 
-    .intr_rx_full_o      (),
-    .intr_rx_watermark_o (),
-    .intr_tx_empty_o     (),
-    .intr_tx_watermark_o (),
-    .intr_complete_o     (),
+    .intr_rx_full_o      (spi_rp1_rx_full_irq),
+    .intr_rx_watermark_o (spi_rp1_rx_watermark_irq),
+    .intr_tx_empty_o     (spi_rp1_tx_empty_irq),
+    .intr_tx_watermark_o (spi_rp1_tx_watermark_irq),
+    .intr_complete_o     (spi_rp1_complete_irq),
+
+    // DMA pacing.
+    .dma_tx_ready_o      (spi_dma_tx_ready[4]),
+    .dma_rx_ready_o      (spi_dma_rx_ready[4]),
+    .idle_o              (spi_idle[4]),
 
     .spi_copi_o          (spi_rp1_tx_o),
     .spi_cipo_i          (spi_rp1_rx_i),
-    .spi_clk_o           (spi_rp1_sck_o)
+    .spi_clk_o           (spi_rp1_sck_o),
+    .spi_cs_no           (spi_rp1_cs_no)
   );
 
   // SPI host for the Arduino Shield.
-  spi u_spi_ard (
+  spi #(
+    .RxFifoDepth ( SpiHeaderFifoDepth ),
+    .TxFifoDepth ( SpiHeaderFifoDepth )
+  ) u_spi_ard (
     .clk_i               (clk_sys_i),
     .rst_ni              (rst_sys_ni),
 
     .tl_i                (tl_spi_ard_h2d),
     .tl_o                (tl_spi_ard_d2h),
 
-    .intr_rx_full_o      (),
-    .intr_rx_watermark_o (),
-    .intr_tx_empty_o     (),
-    .intr_tx_watermark_o (),
-    .intr_complete_o     (),
+    .intr_rx_full_o      (spi_ard_rx_full_irq),
+    .intr_rx_watermark_o (spi_ard_rx_watermark_irq),
+    .intr_tx_empty_o     (spi_ard_tx_empty_irq),
+    .intr_tx_watermark_o (spi_ard_tx_watermark_irq),
+    .intr_complete_o     (spi_ard_complete_irq),
+
+    // DMA pacing.
+    .dma_tx_ready_o      (spi_dma_tx_ready[5]),
+    .dma_rx_ready_o      (spi_dma_rx_ready[5]),
+    .idle_o              (spi_idle[5]),
 
     .spi_copi_o          (spi_ard_tx_o),
     .spi_cipo_i          (spi_ard_rx_i),
-    .spi_clk_o           (spi_ard_sck_o)
+    .spi_clk_o           (spi_ard_sck_o),
+    .spi_cs_no           (spi_ard_cs_no)
   );
 
   // SPI host for mikroBUS Click.
-  spi u_spi_mkr (
+  spi #(
+    .RxFifoDepth ( SpiHeaderFifoDepth ),
+    .TxFifoDepth ( SpiHeaderFifoDepth )
+  ) u_spi_mkr (
     .clk_i               (clk_sys_i),
     .rst_ni              (rst_sys_ni),
 
     .tl_i                (tl_spi_mkr_h2d),
     .tl_o                (tl_spi_mkr_d2h),
 
-    .intr_rx_full_o      (),
-    .intr_rx_watermark_o (),
-    .intr_tx_empty_o     (),
-    .intr_tx_watermark_o (),
-    .intr_complete_o     (),
+    .intr_rx_full_o      (spi_mkr_rx_full_irq),
+    .intr_rx_watermark_o (spi_mkr_rx_watermark_irq),
+    .intr_tx_empty_o     (spi_mkr_tx_empty_irq),
+    .intr_tx_watermark_o (spi_mkr_tx_watermark_irq),
+    .intr_complete_o     (spi_mkr_complete_irq),
+
+    // DMA pacing.
+    .dma_tx_ready_o      (spi_dma_tx_ready[6]),
+    .dma_rx_ready_o      (spi_dma_rx_ready[6]),
+    .idle_o              (spi_idle[6]),
 
     .spi_copi_o          (spi_mkr_tx_o),
     .spi_cipo_i          (spi_mkr_rx_i),
-    .spi_clk_o           (spi_mkr_sck_o)
+    .spi_clk_o           (spi_mkr_sck_o),
+    .spi_cs_no           (spi_mkr_cs_no)
+  );
+
+  // DMA engine for moving data between memory and the SPI blocks.
+  dma #(
+    .NumSpi (NumSpi)
+  ) u_dma (
+    .clk_i          (clk_sys_i),
+    .rst_ni         (rst_sys_ni),
+
+    .tl_i           (tl_dma_h2d),
+    .tl_o           (tl_dma_d2h),
+
+    .host_tl_o      (tl_dma_host_h2d_d),
+    .host_tl_i      (tl_dma_host_d2h_d),
+
+    .intr_done_o    (dma_done_irq),
+
+    .spi_tx_ready_i (spi_dma_tx_ready),
+    .spi_rx_ready_i (spi_dma_rx_ready),
+    .spi_idle_i     (spi_idle)
   );
 
   // RISC-V timer.
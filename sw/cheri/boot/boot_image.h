@@ -0,0 +1,60 @@
+/**
+ * Copyright lowRISC contributors.
+ * Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+#include <stdint.h>
+
+/*
+ * Sonata boot image ("load map") format, produced from an ELF executable by
+ * util/make_boot_image.py. A fixed size header holding the entry point and a
+ * table of loadable segments is followed by the segment data, stored in the
+ * order of the table so the loader can fetch the header with one flash read
+ * and then stream every segment back to back.
+ *
+ * All fields are little endian. Segment offsets are relative to the start of
+ * the image and segment flags use the ELF PF_* values, including
+ * PF_SONATA_LZ4 for compressed segments.
+ *
+ * Each segment carries the CRC-32 of its data as stored in flash (i.e. after
+ * compression), and the header the SHA-256 of all segment data in table
+ * order. The loader checks these while streaming the segments.
+ *
+ * Segments flagged PF_SONATA_LAZY are not loaded at boot. They are left
+ * uncompressed in flash and listed in the boot info region, for the loaded
+ * software to fill in on first use. Their data is not part of the SHA-256.
+ * Instead, the data of each is followed, from the next word boundary, by the
+ * CRC-32 of its part of every 4 KiB aligned chunk its file data overlaps, so
+ * that the software can check each chunk as it loads it.
+ *
+ * The generation identifies the contents of the image. The loader uses it to
+ * tell whether the copy left in HyperRAM by a previous boot is still current.
+ */
+
+#define SONATA_IMAGE_MAGIC 0x4d494253 /* "SBIM" */
+#define SONATA_IMAGE_VERSION 4
+#define SONATA_IMAGE_MAX_SEGMENTS 8
+
+typedef struct sonata_image_segment
+{
+	uint32_t offset;
+	uint32_t vaddr;
+	uint32_t filesz;
+	uint32_t memsz;
+	uint32_t flags;
+	uint32_t crc;
+} SonataImageSegment;
+
+typedef struct sonata_image_header
+{
+	uint32_t magic;
+	/* CRC-32 of the header from `version` to the end of `segments`. */
+	uint32_t header_crc;
+	uint16_t version;
+	uint16_t segment_count;
+	uint32_t entry;
+	uint32_t generation;
+	uint8_t  sha256[32];
+	SonataImageSegment segments[SONATA_IMAGE_MAX_SEGMENTS];
+} SonataImageHeader;
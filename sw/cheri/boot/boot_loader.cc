@@ -8,9 +8,16 @@
 #define CHERIOT_PLATFORM_CUSTOM_UART
 
 #include "../../common/defs.h"
+#include "../common/bl-mem.hh"
+#include "../common/boot-info.hh"
+#include "../common/crc32.hh"
 #include "../common/flash-utils.hh"
+#include "../common/sha256.hh"
+#include "../common/timer-utils.hh"
 #include "../common/uart-utils.hh"
+#include "boot_image.h"
 #include "elf.h"
+#include "lz4.hh"
 
 #include <algorithm>
 #include <cheri.hh>
@@ -19,15 +26,32 @@
 #include <platform-uart.hh>
 #include <stdint.h>
 
-extern "C" {
-	// Use a different name to avoid resolve to CHERIoT-RTOS memset symbol.
-	void bl_memset(void *, int, size_t);
-}
-
 #define DEBUG_ELF_HEADER 0
 
+// Boot images always carry a CRC-32 per segment, which is checked as the
+// data arrives from flash. Checking the whole-image SHA-256 as well pulls in
+// the hash and its constant table. The loader with it has not been shown to
+// fit under __boot_image_limit, so no build option turns it on; setting
+// BOOT_SHA256 by hand is likely to fail at link time.
+#ifndef BOOT_SHA256
+#define BOOT_SHA256 0
+#endif
+
+// Records an mcycle breakdown of the boot in the boot info region and prints
+// it before jumping to the loaded software.
+#ifndef BOOT_TIMING
+#define BOOT_TIMING 0
+#endif
+
 #define ARR_LEN(X) ((sizeof(X)) / (sizeof(X[0])))
 
+// Number of program headers fetched from flash with a single read.
+static constexpr uint32_t PhdrBatchSize = 8;
+
+// Segment data is digested in chunks of this size straight after each chunk
+// is read, while it is still fresh, rather than in a second pass.
+static constexpr uint32_t DigestChunkSize = 512;
+
 const uint32_t SoftwareSlots[] = {
 	0 * 10 * 1024 * 1024,  // Slot 1
 	1 * 10 * 1024 * 1024,  // Slot 2
@@ -40,6 +64,7 @@ const char prefix[] = "\x1b[35mbootloader\033[0m: ";
 
 typedef CHERI::Capability<volatile OpenTitanUart> &UartRef;
 typedef CHERI::Capability<volatile SonataGPIO> &GpioRef;
+typedef CHERI::Capability<BootInfo>            &BootInfoRef;
 
 [[noreturn]] void complain_and_loop(UartRef uart, const char *str)
 {
@@ -63,16 +88,20 @@ uint8_t read_selected_software_slot(GpioRef gpio)
 	return 0;  // Default to software slot 1 (i.e. SW0)
 }
 
-static void debug_print_phdr(UartRef uart, Elf32_Phdr &phdr)
+static void debug_print_segment(UartRef  uart,
+                                uint32_t offset,
+                                uint32_t vaddr,
+                                uint32_t filesz,
+                                uint32_t memsz)
 {
 	write_str(uart, prefix);
-	write_hex(uart, phdr.p_offset);
+	write_hex(uart, offset);
 	write_str(uart, " ");
-	write_hex(uart, phdr.p_vaddr);
+	write_hex(uart, vaddr);
 	write_str(uart, " ");
-	write_hex(uart, phdr.p_filesz);
+	write_hex(uart, filesz);
 	write_str(uart, " ");
-	write_hex(uart, phdr.p_memsz);
+	write_hex(uart, memsz);
 	write_str(uart, "\r\n");
 }
 
@@ -84,18 +113,394 @@ static void write_hex_with_prefix(UartRef uart, const char *msg, uint32_t value)
 	write_str(uart, "\r\n");
 }
 
-uint32_t read_elf(SpiFlash                  &flash,
-                  uint32_t                   addr,
-                  UartRef                    uart,
-                  CHERI::Capability<uint8_t> sram,
-                  CHERI::Capability<uint8_t> hyperram)
+#if BOOT_TIMING
+static BootTiming *boot_timing;
+
+static void record_segment_timing(uint32_t vaddr,
+                                  uint32_t load_bytes,
+                                  uint32_t load_cycles,
+                                  uint32_t zero_bytes,
+                                  uint32_t zero_cycles)
+{
+	boot_timing->load_cycles += load_cycles;
+	boot_timing->zero_cycles += zero_cycles;
+	if (boot_timing->segment_count < BootTimingMaxSegments)
+	{
+		boot_timing->segments[boot_timing->segment_count] = {
+		  vaddr, load_bytes, load_cycles, zero_bytes, zero_cycles};
+	}
+	boot_timing->segment_count++;
+}
+
+static void write_timing_row(UartRef uart, const char *name, uint32_t cycles)
 {
 	write_str(uart, prefix);
-	write_str(uart, "Loading software from flash...\r\n");
+	write_str(uart, name);
+	write_dec(uart, cycles);
+	write_str(uart, "\r\n");
+}
+
+// boot.S fills the loader's free space with 0xa5 bytes before the stack is
+// used. The stack grows down from the program the loader loads.
+static constexpr uint32_t StackFillWord = 0xa5a5a5a5;
+static constexpr uint32_t StackTop      = 0x00101000;
 
-	Elf32_Ehdr ehdr;
-	flash.read(addr, (uint8_t *)&ehdr, sizeof(Elf32_Ehdr));
+// Finds how deep the stack has gone from the lowest word below `StackTop` that
+// no longer holds the fill, and how much room that left above the limit the
+// build sets for the loader's code and data.
+static void record_stack_depth(CHERI::Capability<void> root)
+{
+	uint32_t data_end;
+	uint32_t image_limit;
+	asm("lui %0, %%hi(__DATA_END__)\n"
+	    "addi %0, %0, %%lo(__DATA_END__)\n"
+	    "lui %1, %%hi(__boot_image_limit)\n"
+	    "addi %1, %1, %%lo(__boot_image_limit)"
+	    : "=r"(data_end), "=r"(image_limit));
+	data_end = (data_end + 3) & ~3u;
+
+	CHERI::Capability<const volatile uint32_t> free =
+	  root.cast<const volatile uint32_t>();
+	free.address() = data_end;
+	free.bounds()  = StackTop - data_end;
+
+	uint32_t words = (StackTop - data_end) / 4;
+	uint32_t i     = 0;
+	while (i < words && free[i] == StackFillWord)
+	{
+		i++;
+	}
+	uint32_t lowest = data_end + i * 4;
+
+	boot_timing->stack_bytes = StackTop - lowest;
+	boot_timing->stack_margin_bytes =
+	  lowest > image_limit ? lowest - image_limit : 0;
+}
+
+// Throughput in kB/s, working in units of 10us to stay within 32 bits.
+static uint32_t kbytes_per_second(uint32_t bytes, uint32_t cycles)
+{
+	uint32_t units = cycles / (CPU_TIMER_HZ / 100'000);
+	return bytes * 100 / std::max<uint32_t>(units, 1);
+}
+
+static void print_boot_timing(UartRef uart, const BootTiming &timing)
+{
+	write_timing_row(uart, "startup     ", timing.startup_cycles);
+	write_timing_row(uart, "flash reset ", timing.flash_reset_cycles);
+	write_timing_row(uart, "header      ", timing.header_cycles);
+	write_timing_row(uart, "load        ", timing.load_cycles);
+	write_timing_row(uart, " of digest  ", timing.digest_cycles);
+	write_timing_row(uart, "zero bss    ", timing.zero_cycles);
+	write_timing_row(uart, "total       ", timing.total_cycles);
+	write_timing_row(uart, "stack bytes ", timing.stack_bytes);
+	write_timing_row(uart, " margin     ", timing.stack_margin_bytes);
+
+	write_str(uart, prefix);
+	write_str(uart,
+	          "VirtAddr load bytes/cycles/kB/s, zero bytes/cycles/kB/s\r\n");
+	uint32_t count = std::min(timing.segment_count, BootTimingMaxSegments);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const BootSegmentTiming &seg = timing.segments[i];
+		write_str(uart, prefix);
+		write_hex(uart, seg.vaddr);
+		write_str(uart, " ");
+		write_dec(uart, seg.load_bytes);
+		write_str(uart, "/");
+		write_dec(uart, seg.load_cycles);
+		write_str(uart, "/");
+		write_dec(uart, kbytes_per_second(seg.load_bytes, seg.load_cycles));
+		write_str(uart, ", ");
+		write_dec(uart, seg.zero_bytes);
+		write_str(uart, "/");
+		write_dec(uart, seg.zero_cycles);
+		write_str(uart, "/");
+		write_dec(uart, kbytes_per_second(seg.zero_bytes, seg.zero_cycles));
+		write_str(uart, "\r\n");
+	}
+}
+#endif
+
+/**
+ * Copies segments from flash into memory. Segments whose data directly
+ * follows the previous segment in flash share one long flash read, which is
+ * kept open until `finish` is called.
+ *
+ * When `keep_readonly_hyperram` is set, read-only segments in HyperRAM are
+ * assumed to still hold the right contents and are skipped.
+ *
+ * Segments flagged PF_SONATA_LAZY are recorded in the `lazy` table instead of
+ * being read, and the loaded software fills them in as it uses them.
+ *
+ * When `digest` is set, the bytes of each segment are run through a CRC-32
+ * (and SHA-256 if enabled) as they are read from flash, before any BSS is
+ * cleared, and a segment that does not match its expected CRC stops the boot.
+ */
+class SegmentLoader
+{
+	private:
+	SpiFlash                  &flash;
+	UartRef                    uart;
+	CHERI::Capability<uint8_t> sram;
+	CHERI::Capability<uint8_t> hyperram;
+	bool                       streaming   = false;
+	uint32_t                   stream_addr = 0;
+	uint32_t                   segment_crc = Crc32Init;
+
+	public:
+	LazySegmentTable *lazy                   = nullptr;
+	bool              keep_readonly_hyperram = false;
+	bool              digest                 = false;
+	uint32_t          load_bytes             = 0;
+	uint32_t          flash_bytes            = 0;
+	uint32_t          kept_bytes             = 0;
+	uint32_t          lazy_bytes             = 0;
+	uint32_t          digest_cycles          = 0;
+#if BOOT_SHA256
+	Sha256 sha256;
+#endif
 
+	SegmentLoader(SpiFlash                  &flash,
+	              UartRef                    uart,
+	              CHERI::Capability<uint8_t> sram,
+	              CHERI::Capability<uint8_t> hyperram)
+	  : flash(flash), uart(uart), sram(sram), hyperram(hyperram)
+	{
+	}
+
+	/**
+	 * Reads the next `len` bytes of the current flash stream into `data`,
+	 * digesting them on the way if requested.
+	 */
+	void read_stream(uint8_t *data, uint32_t len)
+	{
+		while (len > 0)
+		{
+			uint32_t chunk = std::min(len, DigestChunkSize);
+			flash.read_stream(data, chunk);
+			if (digest)
+			{
+				uint32_t digest_start = get_mcycle();
+				segment_crc = crc32_update(segment_crc, data, chunk);
+#if BOOT_SHA256
+				sha256.update(data, chunk);
+#endif
+				digest_cycles += get_mcycle() - digest_start;
+			}
+			data += chunk;
+			len -= chunk;
+		}
+	}
+
+	void load(uint32_t flash_addr,
+	          uint32_t vaddr,
+	          uint32_t filesz,
+	          uint32_t memsz,
+	          uint32_t flags,
+	          uint32_t expected_crc = 0)
+	{
+#if DEBUG_ELF_HEADER
+		debug_print_segment(uart, flash_addr, vaddr, filesz, memsz);
+#endif
+
+		bool in_hyperram = vaddr >= sram.top();
+		if ((flags & PF_SONATA_LAZY) && in_hyperram &&
+		    lazy->count < LazyMaxSegments)
+		{
+			// Nothing is written to the segment here, so that boot time does
+			// not depend on its size. The chunk CRCs follow the data, word aligned.
+			lazy->segments[lazy->count++] = {
+			  flash_addr, vaddr, filesz, memsz, (flash_addr + filesz + 3) & ~3u};
+			lazy_bytes += memsz;
+			return;
+		}
+		if (keep_readonly_hyperram && in_hyperram && !(flags & PF_W))
+		{
+			kept_bytes += memsz;
+			return;
+		}
+
+		auto segment      = in_hyperram ? hyperram : sram;
+		segment.address() = vaddr;
+		segment.bounds().set_inexact(memsz);
+
+		if (!segment.is_valid())
+		{
+			debug_print_segment(uart, flash_addr, vaddr, filesz, memsz);
+			complain_and_loop(uart,
+			                  "Cannot get a valid capability for segment\n");
+		}
+
+#if BOOT_TIMING
+		uint32_t load_start = get_mcycle();
+#endif
+
+		uint32_t bss_start = 0;
+		if (filesz != 0)
+		{
+			if (streaming && stream_addr != flash_addr)
+			{
+				finish();
+			}
+			if (!streaming)
+			{
+				flash.read_stream_start(flash_addr);
+				streaming = true;
+			}
+
+			segment_crc        = Crc32Init;
+			uint32_t data_size = filesz;
+			if (flags & PF_SONATA_LZ4)
+			{
+				Lz4StreamDecoder decoder(*this, filesz);
+				int32_t         decoded = decoder.decode(segment.get(), memsz);
+				if (decoded < 0)
+				{
+					debug_print_segment(uart, flash_addr, vaddr, filesz, memsz);
+					complain_and_loop(uart, "Corrupt compressed segment\r\n");
+				}
+				data_size = decoded;
+			}
+			else
+			{
+				read_stream(segment.get(), filesz);
+			}
+
+			if (digest && crc32_final(segment_crc) != expected_crc)
+			{
+				debug_print_segment(uart, flash_addr, vaddr, filesz, memsz);
+				complain_and_loop(uart, "Segment CRC mismatch\r\n");
+			}
+			stream_addr = flash_addr + filesz;
+			flash_bytes += filesz;
+			load_bytes += data_size;
+			bss_start = data_size;
+		}
+
+#if BOOT_TIMING
+		uint32_t zero_start = get_mcycle();
+#endif
+		bl_memset(segment.get() + bss_start, 0, memsz - bss_start);
+#if BOOT_TIMING
+		record_segment_timing(vaddr,
+		                      bss_start,
+		                      zero_start - load_start,
+		                      memsz - bss_start,
+		                      get_mcycle() - zero_start);
+#endif
+	}
+
+	void finish()
+	{
+		if (streaming)
+		{
+			flash.read_stream_end();
+			streaming = false;
+		}
+	}
+};
+
+static uint32_t warm_boot_stamp_crc(const WarmBootStamp &stamp)
+{
+	return crc32((const uint8_t *)&stamp, offsetof(WarmBootStamp, crc));
+}
+
+/**
+ * Loads a Sonata boot image, whose header has already been read from flash
+ * in full, by streaming each segment in the table.
+ *
+ * If the warm boot stamp in HyperRAM shows this exact image was loaded from
+ * the same slot before the last reset, its read-only HyperRAM segments are
+ * left in place. Writable segments and anything in SRAM are always reloaded,
+ * as the previous run may have changed them. The stamp is cleared before
+ * loading starts and only rewritten once the image is complete, so an
+ * interrupted load is never trusted.
+ */
+static uint32_t read_boot_image(SegmentLoader           &loader,
+                                uint32_t                 addr,
+                                uint8_t                  slot,
+                                UartRef                  uart,
+                                const SonataImageHeader &header,
+                                BootInfoRef              boot_info)
+{
+	if (header.version != SONATA_IMAGE_VERSION ||
+	    header.segment_count > SONATA_IMAGE_MAX_SEGMENTS)
+	{
+		complain_and_loop(uart, "Unsupported boot image version\r\n");
+	}
+
+	constexpr size_t CrcStart = offsetof(SonataImageHeader, version);
+	if (crc32((const uint8_t *)&header + CrcStart, sizeof(header) - CrcStart) !=
+	    header.header_crc)
+	{
+		complain_and_loop(uart, "Boot image header CRC mismatch\r\n");
+	}
+
+	loader.digest        = true;
+	WarmBootStamp &stamp = boot_info->warm_boot;
+	loader.keep_readonly_hyperram =
+	  stamp.magic == WarmBootMagic && stamp.crc == warm_boot_stamp_crc(stamp) &&
+	  stamp.slot == slot && stamp.image_crc == header.header_crc &&
+	  stamp.generation == header.generation;
+	stamp.magic = 0;
+
+	for (uint32_t i = 0; i < header.segment_count; i++)
+	{
+		const SonataImageSegment &seg = header.segments[i];
+		loader.load(addr + seg.offset,
+		            seg.vaddr,
+		            seg.filesz,
+		            seg.memsz,
+		            seg.flags,
+		            seg.crc);
+	}
+
+#if BOOT_SHA256
+	// Kept segments were not read, but were verified by the boot that
+	// stamped them.
+	if (!loader.keep_readonly_hyperram)
+	{
+		uint8_t sha256[32];
+		loader.sha256.finish(sha256);
+		for (uint32_t i = 0; i < sizeof(sha256); i++)
+		{
+			if (sha256[i] != header.sha256[i])
+			{
+				complain_and_loop(uart, "Boot image SHA-256 mismatch\r\n");
+			}
+		}
+	}
+#endif
+
+	if (loader.keep_readonly_hyperram)
+	{
+		write_str(uart, prefix);
+		write_str(uart, "Warm boot, kept ");
+		write_dec(uart, loader.kept_bytes);
+		write_str(uart, " bytes in HyperRAM\r\n");
+	}
+
+	stamp.slot       = slot;
+	stamp.image_crc  = header.header_crc;
+	stamp.generation = header.generation;
+	stamp.entry      = header.entry;
+	stamp.crc        = warm_boot_stamp_crc(stamp);
+	stamp.magic      = WarmBootMagic;
+	return header.entry;
+}
+
+/**
+ * Loads an ELF executable whose header has already been read from flash.
+ * Program headers are fetched in batches so each segment of a batch can be
+ * streamed without interleaving header reads.
+ */
+static uint32_t read_elf(SpiFlash         &flash,
+                         SegmentLoader    &loader,
+                         uint32_t          addr,
+                         UartRef           uart,
+                         const Elf32_Ehdr &ehdr)
+{
 	// Check the ELF magic numbers.
 	if (ehdr.e_ident[EI_MAG0] != ELFMAG0 || ehdr.e_ident[EI_MAG1] != ELFMAG1 ||
 	    ehdr.e_ident[EI_MAG2] != ELFMAG2 || ehdr.e_ident[EI_MAG3] != ELFMAG3)
@@ -112,47 +517,119 @@ uint32_t read_elf(SpiFlash                  &flash,
 		                  "ELF file is not 32-bit CHERI RISC-V executable\r\n");
 	}
 
-#if DEBUG_ELF_HEADER
-	write_str(uart, prefix);
-	write_str(uart, "Offset   VirtAddr FileSize MemSize\r\n");
-#endif
+	if (ehdr.e_phentsize != sizeof(Elf32_Phdr))
+	{
+		complain_and_loop(uart, "Unexpected ELF program header size\r\n");
+	}
 
-	Elf32_Phdr phdr;
-	for (uint32_t i = 0; i < ehdr.e_phnum; i++)
+	Elf32_Phdr phdrs[PhdrBatchSize];
+	for (uint32_t first = 0; first < ehdr.e_phnum; first += PhdrBatchSize)
 	{
-		uint32_t phdr_read_addr = addr + ehdr.e_phoff;
-		flash.read(phdr_read_addr + ehdr.e_phentsize * i,
-		           (uint8_t *)&phdr,
-		           sizeof(Elf32_Phdr));
+		uint32_t count =
+		  std::min<uint32_t>(ehdr.e_phnum - first, PhdrBatchSize);
+		flash.read(addr + ehdr.e_phoff + sizeof(Elf32_Phdr) * first,
+		           (uint8_t *)phdrs,
+		           sizeof(Elf32_Phdr) * count);
 
-		if (phdr.p_type != PT_LOAD)
-			continue;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			Elf32_Phdr &phdr = phdrs[i];
+			if (phdr.p_type == PT_LOAD)
+			{
+				loader.load(addr + phdr.p_offset,
+				            phdr.p_vaddr,
+				            phdr.p_filesz,
+				            phdr.p_memsz,
+				            phdr.p_flags);
+			}
+		}
+		loader.finish();
+	}
+	return ehdr.e_entry;
+}
+
+/**
+ * Loads the software in the slot at `addr`, which is either a Sonata boot
+ * image or, failing that, an ELF executable. The first read fetches enough
+ * for either header, so a boot image takes that read plus one stream for its
+ * segments.
+ */
+uint32_t load_software(SpiFlash                  &flash,
+                       uint8_t                    slot,
+                       uint32_t                   addr,
+                       UartRef                    uart,
+                       CHERI::Capability<uint8_t> sram,
+                       CHERI::Capability<uint8_t> hyperram,
+                       BootInfoRef                boot_info)
+{
+	write_str(uart, prefix);
+	write_str(uart, "Loading software from flash...\r\n");
 
 #if DEBUG_ELF_HEADER
-		debug_print_phdr(uart, phdr);
+	write_str(uart, prefix);
+	write_str(uart, "Offset   VirtAddr FileSize MemSize\r\n");
 #endif
 
-		auto segment      = phdr.p_vaddr >= sram.top() ? hyperram : sram;
-		segment.address() = phdr.p_vaddr;
-		segment.bounds().set_inexact(phdr.p_memsz);
+	uint32_t load_start = get_mcycle();
 
-		if (!segment.is_valid())
-		{
-			debug_print_phdr(uart, phdr);
-			complain_and_loop(uart,
-			                  "Cannot get a valid capability for segment\n");
-		}
+	union
+	{
+		SonataImageHeader image;
+		Elf32_Ehdr        ehdr;
+	} header;
+	flash.read(addr, (uint8_t *)&header, sizeof(header));
+#if BOOT_TIMING
+	boot_timing->header_cycles = get_mcycle() - load_start;
+#endif
 
-		for (uint32_t offset = 0; offset < phdr.p_filesz; offset += 0x400)
-		{
-			uint32_t size = std::min(phdr.p_filesz, offset + 0x400) - offset;
-			flash.read(addr + phdr.p_offset + offset, segment.get() + offset, size);
-		}
+	bl_memset(&boot_info->lazy, 0, sizeof(LazySegmentTable));
 
-		bl_memset(segment.get() + phdr.p_filesz, 0, phdr.p_memsz - phdr.p_filesz);
+	SegmentLoader loader(flash, uart, sram, hyperram);
+	loader.lazy = &boot_info->lazy;
+	uint32_t entry;
+	if (header.image.magic == SONATA_IMAGE_MAGIC)
+	{
+		entry =
+		  read_boot_image(loader, addr, slot, uart, header.image, boot_info);
+	}
+	else
+	{
+		boot_info->warm_boot.magic = 0;
+		entry = read_elf(flash, loader, addr, uart, header.ehdr);
 	}
+	loader.finish();
 
-	return ehdr.e_entry;
+	uint32_t load_cycles = get_mcycle() - load_start;
+	write_str(uart, prefix);
+	write_str(uart, "Loaded ");
+	write_dec(uart, loader.load_bytes);
+	write_str(uart, " bytes (");
+	write_dec(uart, loader.flash_bytes);
+	write_str(uart, " from flash) in ");
+	write_dec(uart, load_cycles);
+	write_str(uart, " cycles (");
+	write_dec(uart,
+	          loader.load_bytes / std::max<uint32_t>(load_cycles / 1000, 1));
+	write_str(uart, " bytes/kcycle)\r\n");
+	if (loader.lazy_bytes)
+	{
+		write_str(uart, prefix);
+		write_str(uart, "Left ");
+		write_dec(uart, loader.lazy_bytes);
+		write_str(uart, " bytes to load on demand\r\n");
+	}
+#if BOOT_TIMING
+	boot_timing->digest_cycles = loader.digest_cycles;
+#endif
+	if (loader.digest)
+	{
+		write_str(uart, prefix);
+		write_str(uart, "Digest took ");
+		write_dec(uart, loader.digest_cycles);
+		write_str(uart, " of those cycles\r\n");
+	}
+
+	return entry;
 }
 
 /**
@@ -161,6 +638,9 @@ uint32_t read_elf(SpiFlash                  &flash,
  */
 extern "C" uint32_t rom_loader_entry(void *rwRoot)
 {
+#if BOOT_TIMING
+	uint32_t entry_cycles = get_mcycle();
+#endif
 	CHERI::Capability<void> root{rwRoot};
 
 	// Create a bounded capability to the UART
@@ -184,13 +664,29 @@ extern "C" uint32_t rom_loader_entry(void *rwRoot)
 
 	CHERI::Capability<uint8_t> hyperram = root.cast<uint8_t>();
 	hyperram.address()                  = HYPERRAM_ADDRESS;
-	hyperram.bounds()                   = HYPERRAM_BOUNDS;
+	hyperram.bounds()                   = HYPERRAM_BOUNDS - BootInfoBounds;
+
+	CHERI::Capability<BootInfo> boot_info = root.cast<BootInfo>();
+	boot_info.address()                   = BootInfoAddress;
+	boot_info.bounds()                    = sizeof(BootInfo);
+	boot_info->timing.magic               = 0;
+#if BOOT_TIMING
+	boot_timing                 = &boot_info->timing;
+	*boot_timing                = {};
+	boot_timing->startup_cycles = entry_cycles;
+#endif
 
 	spi->init(false, false, true, 0);
 	uart->init(BAUD_RATE);
 
 	SpiFlash spi_flash(spi, gpio, FLASH_CSN_GPIO_BIT);
+#if BOOT_TIMING
+	uint32_t flash_reset_start = get_mcycle();
+#endif
 	spi_flash.reset();
+#if BOOT_TIMING
+	boot_timing->flash_reset_cycles = get_mcycle() - flash_reset_start;
+#endif
 	
 	uint8_t software_slot = read_selected_software_slot(gpio);
 	write_str(uart, prefix);
@@ -200,7 +696,21 @@ extern "C" uint32_t rom_loader_entry(void *rwRoot)
 	write_str(uart, software_slot_str);
 	uint32_t flash_addr = SoftwareSlots[software_slot];
 	
-	uint32_t entrypoint = read_elf(spi_flash, flash_addr, uart, sram, hyperram);
+	uint32_t entrypoint =
+	  load_software(spi_flash,
+	                software_slot,
+	                flash_addr,
+	                uart,
+	                sram,
+	                hyperram,
+	                boot_info);
+
+#if BOOT_TIMING
+	boot_timing->total_cycles = get_mcycle() - entry_cycles;
+	boot_timing->magic        = BootTimingMagic;
+	record_stack_depth(root);
+	print_boot_timing(uart, *boot_timing);
+#endif
 
 	write_str(uart, prefix);
 	write_str(uart, "Booting into program, hopefully.\r\n");
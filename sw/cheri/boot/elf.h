@@ -20,6 +20,16 @@ typedef uint32_t Elf32_Word;
 #define PT_SHLIB 5
 #define PT_PHDR 6
 
+#define PF_X 0x1
+#define PF_W 0x2
+#define PF_R 0x4
+// OS-specific flag set by util/compress_elf.py on segments whose file data is
+// a raw LZ4 block. p_filesz is then the compressed size.
+#define PF_SONATA_LZ4 0x00100000
+// OS-specific flag set by util/make_boot_image.py on read-only HyperRAM
+// segments that the loaded software fills in from flash on demand.
+#define PF_SONATA_LAZY 0x00200000
+
 #define ET_NONE 0
 #define ET_REL 1
 #define ET_EXEC 2
@@ -0,0 +1,152 @@
+/**
+ * Copyright lowRISC contributors.
+ * Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+#include "../common/bl-mem.hh"
+#include <algorithm>
+#include <stdint.h>
+
+/**
+ * Decompresses a raw LZ4 block (no frame header) while it is streamed from
+ * flash. Literals are read straight into the destination where possible and
+ * matches are copied from data already written to the destination, so the
+ * only staging needed is a small buffer for the sequence headers.
+ *
+ * `Stream` supplies the compressed bytes in order through
+ * `read_stream(uint8_t *data, uint32_t len)`, as `SpiFlash` does.
+ */
+template<typename Stream>
+class Lz4StreamDecoder
+{
+	private:
+	static constexpr uint32_t BufferSize = 64;
+
+	Stream &stream;
+	// Bytes of the compressed block that have not been read from flash yet.
+	uint32_t remaining;
+	uint8_t  buffer[BufferSize];
+	uint32_t buffer_pos;
+	uint32_t buffer_end;
+	bool     overrun;
+
+	bool empty()
+	{
+		return buffer_pos == buffer_end && remaining == 0;
+	}
+
+	uint8_t next()
+	{
+		if (buffer_pos == buffer_end)
+		{
+			if (remaining == 0)
+			{
+				overrun = true;
+				return 0;
+			}
+			buffer_end = std::min(remaining, BufferSize);
+			buffer_pos = 0;
+			stream.read_stream(buffer, buffer_end);
+			remaining -= buffer_end;
+		}
+		return buffer[buffer_pos++];
+	}
+
+	uint32_t next_length(uint32_t length)
+	{
+		if (length == 15)
+		{
+			uint8_t byte;
+			do
+			{
+				byte = next();
+				length += byte;
+			} while (byte == 255 && !overrun);
+		}
+		return length;
+	}
+
+	bool copy_literals(uint8_t *out, uint32_t len)
+	{
+		uint32_t buffered = std::min(len, buffer_end - buffer_pos);
+		bl_memcpy(out, buffer + buffer_pos, buffered);
+		buffer_pos += buffered;
+		len -= buffered;
+		if (len > remaining)
+		{
+			return false;
+		}
+		stream.read_stream(out + buffered, len);
+		remaining -= len;
+		return true;
+	}
+
+	public:
+	/**
+	 * Prepares to decode `compressed_len` bytes from a stream that is
+	 * positioned at the beginning of the block.
+	 */
+	Lz4StreamDecoder(Stream &stream_, uint32_t compressed_len)
+	  : stream(stream_),
+	    remaining(compressed_len),
+	    buffer_pos(0),
+	    buffer_end(0),
+	    overrun(false)
+	{
+	}
+
+	/**
+	 * Decodes the whole block into `out`, which has room for `out_len`
+	 * bytes. Returns the number of bytes produced, or -1 if the block is
+	 * malformed or does not fit.
+	 */
+	int32_t decode(uint8_t *out, uint32_t out_len)
+	{
+		uint32_t written = 0;
+		while (!empty())
+		{
+			uint8_t  token    = next();
+			uint32_t literals = next_length(token >> 4);
+			if (overrun || literals > out_len - written ||
+			    !copy_literals(out + written, literals))
+			{
+				return -1;
+			}
+			written += literals;
+
+			// The last sequence of a block only has literals.
+			if (empty())
+			{
+				break;
+			}
+
+			uint32_t offset = next();
+			offset |= next() << 8;
+			uint32_t match = next_length(token & 0xf) + 4;
+			if (overrun || offset == 0 || offset > written ||
+			    match > out_len - written)
+			{
+				return -1;
+			}
+
+			// Matches may overlap with the bytes they produce, in which case
+			// they have to be copied one byte at a time.
+			uint8_t       *dst = out + written;
+			const uint8_t *src = dst - offset;
+			if (offset >= match)
+			{
+				bl_memcpy(dst, src, match);
+			}
+			else
+			{
+				for (uint32_t i = 0; i < match; i++)
+				{
+					dst[i] = src[i];
+				}
+			}
+			written += match;
+		}
+		return written;
+	}
+};
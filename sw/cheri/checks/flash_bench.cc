@@ -0,0 +1,262 @@
+/**
+ * Copyright lowRISC contributors.
+ * Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#define CHERIOT_NO_AMBIENT_MALLOC
+#define CHERIOT_NO_NEW_DELETE
+#define CHERIOT_PLATFORM_CUSTOM_UART
+
+#include "../../common/defs.h"
+#include "../common/flash-cache.hh"
+#include "../common/flash-kv.hh"
+#include "../common/flash-utils.hh"
+#include "../common/timer-utils.hh"
+#include "../common/uart-utils.hh"
+
+#include <algorithm>
+#include <cheri.hh>
+#include <platform-gpio.hh>
+#include <platform-spi.hh>
+#include <platform-uart.hh>
+#include <stdint.h>
+
+using namespace CHERI;
+
+// Amount of data read from the start of the first software slot, roughly the
+// size of a small boot image.
+static constexpr uint32_t BenchSize = 64 * 1024;
+
+// Scratch area for the write benchmark, at the end of the third software slot
+// where boot images do not reach. Its contents are overwritten.
+static constexpr uint32_t WriteBenchAddress = 3 * 10 * 1024 * 1024 - BenchSize;
+
+// Random small reads, as software might make to a configuration table.
+static constexpr uint32_t SmallReadRegion = 16 * 1024;
+static constexpr uint32_t SmallReads      = 2000;
+
+typedef CachedSpiFlash<256, 64> BenchCache;
+static uint8_t cache_storage[256 * 64];
+
+// Sector buffer for `SpiFlash::write`.
+static uint8_t write_scratch[SpiFlash::SectorSize];
+
+// Key/value store in the free space after the third software slot. Its
+// contents are kept between runs, so the mount time reflects the data left
+// by earlier runs.
+static constexpr uint32_t KvStoreAddress = 3 * 10 * 1024 * 1024;
+static constexpr uint32_t KvUpdates      = 1000;
+
+typedef FlashKvStore<16, 128> BenchKvStore;
+
+static const char *ReadModeNames[] = {
+  "read       ",
+  "fast read  ",
+  "dual output",
+  "quad output",
+};
+
+/**
+ * Makes `SmallReads` reads of 16 to 64 bytes at random addresses within
+ * `SmallReadRegion` bytes of the start of flash and returns the cycles taken.
+ */
+template<typename Flash>
+static uint32_t random_small_reads(Flash &flash)
+{
+	uint8_t  data[64];
+	uint32_t seed  = 1;
+	uint32_t start = get_mcycle();
+	for (uint32_t i = 0; i < SmallReads; i++)
+	{
+		seed         = seed * 1664525 + 1013904223;
+		uint32_t len = 16 + ((seed >> 8) % 49);
+		flash.read((seed >> 16) % (SmallReadRegion - len), data, len);
+	}
+	return get_mcycle() - start;
+}
+
+static void write_cycles(volatile OpenTitanUart *uart,
+                         const char             *name,
+                         uint32_t                cycles)
+{
+	write_str(uart, name);
+	write_str(uart, ": ");
+	write_dec(uart, cycles);
+	write_str(uart, " cycles\r\n");
+}
+
+/**
+ * Reads flash for a while using each read mode and reports the throughput,
+ * then times `SpiFlash::write` for a full, an unchanged and a one byte
+ * update. Finally compares the time a blocking sector erase keeps flash busy
+ * with the worst read latency seen while an erase runs in the background,
+ * and random small reads with and without a `CachedSpiFlash`, and times
+ * mounting and updating a `FlashKvStore`.
+ */
+[[noreturn]] extern "C" void entry_point(void *rwRoot)
+{
+	Capability<void> root{rwRoot};
+
+	Capability<volatile OpenTitanUart> uart =
+	  root.cast<volatile OpenTitanUart>();
+	uart.address() = UART_ADDRESS;
+	uart.bounds()  = UART_BOUNDS;
+
+	Capability<volatile SonataSpi> spi = root.cast<volatile SonataSpi>();
+	spi.address()                      = SPI_ADDRESS;
+	spi.bounds()                       = SPI_BOUNDS;
+
+	Capability<volatile SonataGPIO> gpio = root.cast<volatile SonataGPIO>();
+	gpio.address()                       = GPIO_ADDRESS;
+	gpio.bounds()                        = GPIO_BOUNDS;
+
+	// Use HyperRAM as the destination, as the boot loader would for a large
+	// image.
+	Capability<uint8_t> buffer = root.cast<uint8_t>();
+	buffer.address()           = HYPERRAM_ADDRESS;
+	buffer.bounds()            = BenchSize;
+
+	spi->init(false, false, true, 0);
+	uart->init(BAUD_RATE);
+
+	SpiFlash spi_flash(spi, gpio, FLASH_CSN_GPIO_BIT);
+	spi_flash.reset();
+
+	write_str(uart, "Flash block erase size: ");
+	write_dec(uart, spi_flash.block_size());
+	write_str(uart, " bytes\r\n");
+
+	write_str(uart, "Reading ");
+	write_dec(uart, BenchSize);
+	write_str(uart, " bytes per mode\r\n");
+
+	FlashReadMode default_mode = spi_flash.read_mode();
+	for (uint8_t i = 0; i < sizeof(ReadModeNames) / sizeof(ReadModeNames[0]);
+	     i++)
+	{
+		FlashReadMode mode = FlashReadMode(i);
+		write_str(uart, ReadModeNames[i]);
+		write_str(uart, ": ");
+		if (!spi_flash.read_mode_supported_by_flash(mode))
+		{
+			write_str(uart, "not supported by flash\r\n");
+			continue;
+		}
+		if (!spi_flash.set_read_mode(mode))
+		{
+			write_str(uart, "not supported by SPI controller\r\n");
+			continue;
+		}
+
+		uint32_t start = get_mcycle();
+		spi_flash.read(0, buffer, BenchSize);
+		uint32_t cycles = get_mcycle() - start;
+
+		write_dec(uart, cycles);
+		write_str(uart, " cycles, ");
+		write_dec(uart, BenchSize / (cycles / 1000));
+		write_str(uart, " bytes/kcycle");
+		if (mode == default_mode)
+		{
+			write_str(uart, " (default)");
+		}
+		write_str(uart, "\r\n");
+	}
+	// The remaining benchmarks measure the mode `reset()` picked.
+	spi_flash.set_read_mode(default_mode);
+
+	for (uint32_t i = 0; i < BenchSize; i++)
+	{
+		buffer[i] = i * 7;
+	}
+
+	write_str(uart, "Writing ");
+	write_dec(uart, BenchSize);
+	write_str(uart, " bytes\r\n");
+
+	uint32_t start = get_mcycle();
+	spi_flash.write(WriteBenchAddress, buffer, BenchSize, write_scratch);
+	write_cycles(uart, "full write ", get_mcycle() - start);
+
+	start = get_mcycle();
+	spi_flash.write(WriteBenchAddress, buffer, BenchSize, write_scratch);
+	write_cycles(uart, "unchanged  ", get_mcycle() - start);
+
+	buffer[BenchSize / 2] ^= 0xff;
+	start = get_mcycle();
+	spi_flash.write(WriteBenchAddress, buffer, BenchSize, write_scratch);
+	write_cycles(uart, "one byte   ", get_mcycle() - start);
+
+	start = get_mcycle();
+	spi_flash.erase_sector(WriteBenchAddress);
+	write_cycles(uart, "blocking sector erase", get_mcycle() - start);
+
+	spi_flash.erase_sector_start(WriteBenchAddress + SpiFlash::SectorSize);
+	uint32_t reads        = 0;
+	uint32_t worst_cycles = 0;
+	uint8_t  data[16];
+	while (spi_flash.operation_busy())
+	{
+		start = get_mcycle();
+		spi_flash.read(reads * sizeof(data), data, sizeof(data));
+		worst_cycles = std::max(worst_cycles, get_mcycle() - start);
+		reads++;
+	}
+	write_str(uart, "background sector erase: ");
+	write_dec(uart, reads);
+	write_str(uart, " reads, worst latency ");
+	write_dec(uart, worst_cycles);
+	write_str(uart, " cycles\r\n");
+
+	BenchCache cache(spi_flash, cache_storage);
+	write_str(uart, "Making ");
+	write_dec(uart, SmallReads);
+	write_str(uart, " random 16-64 byte reads\r\n");
+	write_cycles(uart, "uncached", random_small_reads(spi_flash));
+	write_cycles(uart, "cached  ", random_small_reads(cache));
+	write_str(uart, "cache hits ");
+	write_dec(uart, cache.hits);
+	write_str(uart, ", misses ");
+	write_dec(uart, cache.misses);
+	write_str(uart, "\r\n");
+
+	BenchKvStore store(spi_flash, KvStoreAddress);
+	start = get_mcycle();
+	bool mounted = store.mount();
+	write_cycles(uart, "key/value store mount", get_mcycle() - start);
+	write_str(uart, mounted ? "mounted " : "mount failed, ");
+	write_dec(uart, store.keys());
+	write_str(uart, " keys\r\n");
+
+	// Update a few dozen counters, as software logging telemetry might,
+	// giving the store a chance to do background work between updates.
+	uint32_t worst_put = 0;
+	uint32_t failures  = 0;
+	uint32_t total     = get_mcycle();
+	for (uint32_t i = 0; i < KvUpdates; i++)
+	{
+		uint32_t key = i % 40;
+		uint32_t value[4];
+		int32_t  len = store.get(key, (uint8_t *)value, sizeof(value));
+		value[0]     = len == sizeof(value) ? value[0] + 1 : 0;
+		value[1] = value[2] = value[3] = i;
+
+		start = get_mcycle();
+		failures += !store.put(key, (uint8_t *)value, sizeof(value));
+		worst_put = std::max(worst_put, get_mcycle() - start);
+		store.service();
+	}
+	total = get_mcycle() - total;
+	write_str(uart, "key/value updates: ");
+	write_dec(uart, total / KvUpdates);
+	write_str(uart, " cycles average, worst put ");
+	write_dec(uart, worst_put);
+	write_str(uart, " cycles, ");
+	write_dec(uart, failures);
+	write_str(uart, " failures\r\n");
+
+	while (true)
+	{
+		asm("");
+	}
+}
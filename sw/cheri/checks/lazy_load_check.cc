@@ -0,0 +1,249 @@
+/**
+ * Copyright lowRISC contributors.
+ * Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#define CHERIOT_NO_AMBIENT_MALLOC
+#define CHERIOT_NO_NEW_DELETE
+#define CHERIOT_PLATFORM_CUSTOM_UART
+
+#include "../../common/defs.h"
+#include "../common/boot-info.hh"
+#include "../common/crc32.hh"
+#include "../common/flash-utils.hh"
+#include "../common/lazy-load.hh"
+#include "../common/uart-utils.hh"
+
+#include <algorithm>
+#include <cheri.hh>
+#include <platform-gpio.hh>
+#include <platform-spi.hh>
+#include <platform-uart.hh>
+#include <stdint.h>
+
+using namespace CHERI;
+
+// Flash for the lazy segments, below the area flash_bench writes at the end
+// of the third software slot. Its contents are overwritten.
+static constexpr uint32_t LazyFlashAddress = 3 * 10 * 1024 * 1024 - 256 * 1024;
+
+// A segment that starts and ends part way through a chunk and has some BSS,
+// and a one chunk segment whose stored CRC is wrong.
+static constexpr uint32_t GoodVaddr  = HYPERRAM_ADDRESS + 0x40800;
+static constexpr uint32_t GoodFilesz = 3 * LazyChunkSize + 100;
+static constexpr uint32_t GoodMemsz  = GoodFilesz + 6000;
+static constexpr uint32_t BadVaddr   = HYPERRAM_ADDRESS + 0x60000;
+static constexpr uint32_t BadFilesz  = LazyChunkSize;
+
+// Staging area for data written to flash, away from the segments.
+static constexpr uint32_t StagingAddress = HYPERRAM_ADDRESS;
+
+static uint8_t write_scratch[SpiFlash::SectorSize];
+
+// Left in t0 by check_trap.
+static constexpr uint32_t CheckTrapMarker = 0x5a;
+
+/**
+ * Trap handler for traps the lazy loader passes on, which resumes after the
+ * 4 byte instruction that took the trap with `CheckTrapMarker` in t0. The
+ * loader enters it with ct0 holding its address, so ct0 is free to use.
+ */
+asm(R"(
+	.section .text.check_trap, "ax", @progbits
+	.p2align 2
+check_trap:
+	cspecialr  ct0, mepcc
+	cincoffset ct0, ct0, 4
+	cspecialw  mepcc, ct0
+	li         t0, 0x5a
+	mret
+	.previous
+)");
+
+/// Installs check_trap as the trap handler.
+static void install_check_trap()
+{
+	void *handler;
+	asm volatile("auipcc    %0, 0\n"
+	             "lui       t0, %%hi(check_trap)\n"
+	             "addi      t0, t0, %%lo(check_trap)\n"
+	             "csetaddr  %0, %0, t0\n"
+	             "cspecialw mtcc, %0"
+	             : "=&C"(handler)
+	             :
+	             : "t0");
+}
+
+static uint8_t segment_byte(uint32_t offset)
+{
+	return uint8_t(offset * 13 + (offset >> 8) + 0x80);
+}
+
+/**
+ * Writes the file data of a lazy segment at `vaddr` to flash at
+ * `flash_address` followed by its chunk CRCs, as make_boot_image.py does, and
+ * returns the address of the CRCs. The CRC of the first chunk is corrupted
+ * if `corrupt` is set.
+ */
+static uint32_t write_segment(SpiFlash           &flash,
+                              Capability<uint8_t> staging,
+                              uint32_t            flash_address,
+                              uint32_t            vaddr,
+                              uint32_t            filesz,
+                              bool                corrupt)
+{
+	for (uint32_t i = 0; i < filesz; i++)
+	{
+		staging[i] = segment_byte(i);
+	}
+	uint32_t crc_offset = (filesz + 3) & ~3u;
+	uint32_t crc_count  = 0;
+	for (uint32_t chunk = vaddr & ~(LazyChunkSize - 1); chunk < vaddr + filesz;
+	     chunk += LazyChunkSize)
+	{
+		uint32_t low  = std::max(chunk, vaddr) - vaddr;
+		uint32_t high = std::min(chunk + LazyChunkSize, vaddr + filesz) - vaddr;
+		uint32_t crc  = crc32(&staging[low], high - low);
+		if (corrupt && crc_count == 0)
+		{
+			crc ^= 1;
+		}
+		for (uint32_t i = 0; i < sizeof(crc); i++)
+		{
+			staging[crc_offset + crc_count * sizeof(crc) + i] = crc >> (8 * i);
+		}
+		crc_count++;
+	}
+	flash.write(flash_address,
+	            staging.get(),
+	            crc_offset + crc_count * sizeof(uint32_t),
+	            write_scratch);
+	return flash_address + crc_offset;
+}
+
+/**
+ * Sets up two lazy segments the way the boot loader would, then reads one of
+ * them through the capability `LazyLoader` hands out, so that the trap
+ * handler has to load it, and checks what it reads. Also checks that a chunk
+ * whose CRC does not match is refused.
+ */
+[[noreturn]] extern "C" void entry_point(void *rwRoot)
+{
+	Capability<void> root{rwRoot};
+
+	Capability<volatile OpenTitanUart> uart =
+	  root.cast<volatile OpenTitanUart>();
+	uart.address() = UART_ADDRESS;
+	uart.bounds()  = UART_BOUNDS;
+
+	Capability<volatile SonataSpi> spi = root.cast<volatile SonataSpi>();
+	spi.address()                      = SPI_ADDRESS;
+	spi.bounds()                       = SPI_BOUNDS;
+
+	Capability<volatile SonataGPIO> gpio = root.cast<volatile SonataGPIO>();
+	gpio.address()                       = GPIO_ADDRESS;
+	gpio.bounds()                        = GPIO_BOUNDS;
+
+	Capability<uint8_t> staging = root.cast<uint8_t>();
+	staging.address()           = StagingAddress;
+	staging.bounds()            = 4 * LazyChunkSize;
+
+	Capability<LazySegmentTable> table = root.cast<LazySegmentTable>();
+	table.address() = BootInfoAddress + offsetof(BootInfo, lazy);
+	table.bounds()  = sizeof(LazySegmentTable);
+
+	spi->init(false, false, true, 0);
+	uart->init(BAUD_RATE);
+
+	SpiFlash spi_flash(spi, gpio, FLASH_CSN_GPIO_BIT);
+	spi_flash.reset();
+
+	uint32_t bad_flash_address = LazyFlashAddress + 4 * LazyChunkSize;
+
+	uint32_t good_crcs = write_segment(
+	  spi_flash, staging, LazyFlashAddress, GoodVaddr, GoodFilesz, false);
+	uint32_t bad_crcs = write_segment(
+	  spi_flash, staging, bad_flash_address, BadVaddr, BadFilesz, true);
+
+	bl_memset(table.get(), 0, sizeof(LazySegmentTable));
+	table->segments[0] = {
+	  LazyFlashAddress, GoodVaddr, GoodFilesz, GoodMemsz, good_crcs};
+	table->segments[1] = {
+	  bad_flash_address, BadVaddr, BadFilesz, BadFilesz, bad_crcs};
+	table->count = 2;
+
+	// Clear what an earlier run loaded, so the loads below only see the data
+	// if the loader loads it again.
+	Capability<uint8_t> link_time = root.cast<uint8_t>();
+	link_time.address()           = GoodVaddr;
+	link_time.bounds()            = GoodMemsz;
+	bl_memset(link_time.get(), 0, GoodMemsz);
+
+	install_check_trap();
+	LazyLoader lazy(spi_flash, root);
+	lazy.install();
+
+	// A trap that is not for the loader goes to the handler installed before
+	// it, and the loader must still handle the loads below afterwards.
+	uint32_t marker;
+	asm volatile(".4byte 0x00100073\n" // ebreak
+	             "mv %0, t0"
+	             : "=r"(marker)
+	             :
+	             : "t0", "memory");
+	uint32_t failures = marker != CheckTrapMarker;
+
+	// Derive pointers into every chunk from the handle, as software
+	// indexing a table would, and load through them.
+	Capability<const volatile uint8_t> bytes =
+	  lazy.capability(0).cast<const volatile uint8_t>();
+	if (bytes.permissions().contains(Permission::Load))
+	{
+		write_str(uart, "Handle can load before the segment is loaded\r\n");
+		failures++;
+	}
+	for (uint32_t offset = 0; offset < GoodFilesz; offset += 1021)
+	{
+		const volatile uint8_t *byte = bytes.get() + offset;
+		failures += *byte != segment_byte(offset);
+		const volatile int8_t *signed_byte =
+		  reinterpret_cast<const volatile int8_t *>(byte);
+		failures += *signed_byte != int8_t(segment_byte(offset));
+	}
+	Capability<const volatile uint32_t> words =
+	  lazy.capability(0).cast<const volatile uint32_t>();
+	uint32_t last_word = (GoodFilesz / 4) - 1;
+	uint32_t expected  = 0;
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		expected |= uint32_t(segment_byte(last_word * 4 + i)) << (8 * i);
+	}
+	failures += words.get()[last_word] != expected;
+	failures += words.get()[GoodMemsz / 4 - 1] != 0;
+
+	write_str(uart, "Loads handled by the trap handler: ");
+	write_dec(uart, lazy.faults);
+	write_str(uart, "\r\n");
+	failures += lazy.faults == 0;
+
+	// Once the whole segment is in place, the handle is upgraded on its
+	// next fault and new capabilities can load directly.
+	failures += !lazy.ensure(GoodVaddr, GoodMemsz);
+	uint32_t faults = lazy.faults;
+	failures += bytes.get()[1] != segment_byte(1);
+	failures += lazy.faults != faults + 1;
+	failures += !lazy.capability(0).permissions().contains(Permission::Load);
+
+	// A chunk that does not match its CRC is not handed out.
+	failures += lazy.ensure(BadVaddr, BadFilesz);
+	failures += lazy.crc_errors != 1;
+	failures += lazy.capability(1).permissions().contains(Permission::Load);
+
+	write_str(uart, "Lazy load check ");
+	write_str(uart, failures == 0 ? "passed\r\n" : "FAILED\r\n");
+
+	while (true)
+	{
+		asm("");
+	}
+}
@@ -0,0 +1,148 @@
+/**
+ * Copyright lowRISC contributors.
+ * Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#define CHERIOT_NO_AMBIENT_MALLOC
+#define CHERIOT_NO_NEW_DELETE
+#define CHERIOT_PLATFORM_CUSTOM_UART
+
+#include "../../common/defs.h"
+#include "../common/platform-dma.hh"
+#include "../common/timer-utils.hh"
+#include "../common/uart-utils.hh"
+
+#include <algorithm>
+#include <cheri.hh>
+#include <platform-gpio.hh>
+#include <platform-spi.hh>
+#include <platform-uart.hh>
+#include <stdint.h>
+
+using namespace CHERI;
+
+// Amount of flash read in each mode.
+static constexpr uint32_t BenchSize = 16 * 1024;
+
+// The flash SPI block's chip select register, which follows the registers in
+// `SonataSpi`. The flash is on its first chip select line.
+static constexpr size_t   CsRegister = 0x2c / sizeof(uint32_t);
+static constexpr uint32_t CsFlash    = 1 << 0;
+static constexpr uint32_t CsHold     = 1u << 31;
+
+static constexpr uint8_t CmdReadData4Addr = 0x13;
+
+typedef SpiDma<2 * (BenchSize / SpiDma<2>::ChunkLen + 1)> FlashDma;
+
+/**
+ * Reads `BenchSize` bytes from the start of flash into `buffer`, with the DMA
+ * engine when `dma` is given, and returns the cycles taken.
+ */
+static uint32_t read_flash(Capability<volatile SonataSpi> spi,
+                           FlashDma                      *dma,
+                           Capability<uint8_t>            buffer)
+{
+	volatile uint32_t *cs = reinterpret_cast<volatile uint32_t *>(spi.get());
+	const uint8_t      cmd[5] = {CmdReadData4Addr, 0, 0, 0, 0};
+
+	uint32_t start = get_mcycle();
+	cs[CsRegister] = CsFlash | CsHold;
+	spi->blocking_write(cmd, sizeof(cmd));
+	bool ok = true;
+	if (dma != nullptr)
+	{
+		ok = dma->read(buffer, BenchSize);
+	}
+	else
+	{
+		// A single start can only ask for 0x7ff bytes, so read in the same
+		// chunks the DMA engine uses.
+		for (uint32_t offset = 0; offset < BenchSize;
+		     offset += FlashDma::ChunkLen)
+		{
+			spi->blocking_read(buffer.get() + offset,
+			                   std::min<uint32_t>(BenchSize - offset,
+			                                      FlashDma::ChunkLen));
+		}
+	}
+	cs[CsRegister] = CsFlash;
+	uint32_t cycles = get_mcycle() - start;
+
+	return ok ? cycles : 0;
+}
+
+/**
+ * Reads flash with the CPU moving data out of the SPI receive FIFO, then with
+ * the DMA engine doing it, and checks both read the same data. Also checks
+ * that the driver refuses a buffer capability without store permission.
+ */
+[[noreturn]] extern "C" void entry_point(void *rwRoot)
+{
+	Capability<void> root{rwRoot};
+
+	Capability<volatile OpenTitanUart> uart =
+	  root.cast<volatile OpenTitanUart>();
+	uart.address() = UART_ADDRESS;
+	uart.bounds()  = UART_BOUNDS;
+
+	Capability<volatile SonataSpi> spi = root.cast<volatile SonataSpi>();
+	spi.address()                      = SPI_ADDRESS;
+	spi.bounds()                       = SPI_BOUNDS;
+
+	Capability<volatile SonataGPIO> gpio = root.cast<volatile SonataGPIO>();
+	gpio.address()                       = GPIO_ADDRESS;
+	gpio.bounds()                        = GPIO_BOUNDS;
+
+	Capability<volatile SonataDma> dma = root.cast<volatile SonataDma>();
+	dma.address()                      = DMA_ADDRESS;
+	dma.bounds()                       = DMA_BOUNDS;
+
+	Capability<uint8_t> cpu_buffer = root.cast<uint8_t>();
+	cpu_buffer.address()           = HYPERRAM_ADDRESS;
+	cpu_buffer.bounds()            = BenchSize;
+
+	Capability<uint8_t> dma_buffer = root.cast<uint8_t>();
+	dma_buffer.address()           = HYPERRAM_ADDRESS + BenchSize;
+	dma_buffer.bounds()            = BenchSize;
+
+	spi->init(false, false, true, 0);
+	uart->init(BAUD_RATE);
+
+	// Leave the flash chip select to the SPI block.
+	gpio->output = gpio->output | (1 << FLASH_CSN_GPIO_BIT);
+
+	static FlashDma flash_dma(dma, spi);
+
+	write_str(uart, "Reading ");
+	write_dec(uart, BenchSize);
+	write_str(uart, " bytes of flash\r\n");
+
+	uint32_t cpu_cycles = read_flash(spi, nullptr, cpu_buffer);
+	uint32_t dma_cycles = read_flash(spi, &flash_dma, dma_buffer);
+
+	write_str(uart, "CPU: ");
+	write_dec(uart, cpu_cycles);
+	write_str(uart, " cycles\r\nDMA: ");
+	write_dec(uart, dma_cycles);
+	write_str(uart, " cycles\r\n");
+
+	uint32_t mismatches = 0;
+	for (uint32_t i = 0; i < BenchSize; i++)
+	{
+		mismatches += cpu_buffer[i] != dma_buffer[i];
+	}
+	write_str(uart, "Mismatched bytes: ");
+	write_dec(uart, mismatches);
+	write_str(uart, "\r\n");
+
+	Capability<uint8_t> read_only = dma_buffer;
+	read_only.permissions() &= PermissionSet{Permission::Global, Permission::Load};
+	write_str(uart, flash_dma.read(read_only, BenchSize)
+	                  ? "Read-only buffer accepted\r\n"
+	                  : "Read-only buffer refused\r\n");
+
+	while (true)
+	{
+		asm("");
+	}
+}
@@ -0,0 +1,17 @@
+/**
+ * Copyright lowRISC contributors.
+ * Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+#include <stddef.h>
+
+// Fill and copy routines from bl_mem.S. These use different names to avoid
+// resolving to the CHERIoT-RTOS memset/memcpy symbols. Both move 8 bytes per
+// access once the destination is aligned; bl_memcpy also needs the source to
+// share that alignment and its buffers must not overlap.
+extern "C" {
+	void bl_memset(void *dst, int value, size_t len);
+	void bl_memcpy(void *dst, const void *src, size_t len);
+}
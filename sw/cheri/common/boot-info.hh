@@ -0,0 +1,121 @@
+/**
+ * Copyright lowRISC contributors.
+ * Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+#include "../../common/defs.h"
+#include <stdint.h>
+
+/**
+ * A small region at the top of HyperRAM is reserved for information the boot
+ * loader keeps across resets. The loader does not hand it out as part of the
+ * HyperRAM capability used to load software, and software should not use it.
+ */
+static constexpr uint32_t BootInfoBounds = 0x400;
+static constexpr uint32_t BootInfoAddress =
+  HYPERRAM_ADDRESS + HYPERRAM_BOUNDS - BootInfoBounds;
+
+static constexpr uint32_t WarmBootMagic = 0x4d524157;  // "WARM"
+
+/**
+ * Describes the boot image that was last loaded completely. On a warm boot
+ * the loader compares this with the header in flash and, if the image is
+ * unchanged, leaves its read-only HyperRAM segments in place.
+ */
+struct WarmBootStamp
+{
+	uint32_t magic;
+	uint32_t slot;
+	// Header CRC of the loaded boot image, which covers its generation.
+	uint32_t image_crc;
+	uint32_t generation;
+	uint32_t entry;
+	// CRC-32 of the fields above.
+	uint32_t crc;
+};
+
+static constexpr uint32_t BootTimingMagic       = 0x454d4954;  // "TIME"
+static constexpr uint32_t BootTimingMaxSegments = 8;
+
+struct BootSegmentTiming
+{
+	uint32_t vaddr;
+	// Bytes written from flash and the cycles spent reading them.
+	uint32_t load_bytes;
+	uint32_t load_cycles;
+	// Bytes of BSS cleared and the cycles spent clearing them.
+	uint32_t zero_bytes;
+	uint32_t zero_cycles;
+};
+
+/**
+ * mcycle breakdown of the last boot, recorded by a boot loader built with
+ * BOOT_TIMING=1. Software can read it to track boot time; it is only valid
+ * if `magic` is `BootTimingMagic`.
+ */
+struct BootTiming
+{
+	uint32_t magic;
+	// Cycles from reset to the loader's C++ entry point.
+	uint32_t startup_cycles;
+	uint32_t flash_reset_cycles;
+	uint32_t header_cycles;
+	// Totals over all segments. Digest cycles are part of the load cycles.
+	uint32_t load_cycles;
+	uint32_t zero_cycles;
+	uint32_t digest_cycles;
+	// Cycles from the entry point until the jump to the loaded software.
+	uint32_t total_cycles;
+	// Deepest the loader's stack went, and the room that was left between it
+	// and `__boot_image_limit`, in bytes.
+	uint32_t stack_bytes;
+	uint32_t stack_margin_bytes;
+	// Number of segments loaded; only the first `BootTimingMaxSegments` are
+	// recorded individually.
+	uint32_t          segment_count;
+	BootSegmentTiming segments[BootTimingMaxSegments];
+};
+
+static constexpr uint32_t LazyChunkSize   = 4096;
+static constexpr uint32_t LazyMaxSegments = 4;
+static constexpr uint32_t LazyChunkWords =
+  (HYPERRAM_BOUNDS / LazyChunkSize + 31) / 32;
+
+/**
+ * A read-only HyperRAM segment that the boot loader left in flash rather
+ * than copying, because the boot image marked it PF_SONATA_LAZY.
+ */
+struct LazySegment
+{
+	uint32_t flash_address;
+	uint32_t vaddr;
+	uint32_t filesz;
+	uint32_t memsz;
+	// Flash address of the CRC-32 of the file data in each chunk the segment
+	// overlaps, in address order.
+	uint32_t crc_address;
+};
+
+/**
+ * Lazy segments of the loaded software, which it fills in on demand a
+ * `LazyChunkSize` chunk at a time (see lazy-load.hh).
+ */
+struct LazySegmentTable
+{
+	uint32_t    count;
+	LazySegment segments[LazyMaxSegments];
+	// One bit per chunk of HyperRAM, set once the parts of lazy segments in
+	// that chunk have been filled.
+	uint32_t loaded[LazyChunkWords];
+};
+
+struct BootInfo
+{
+	WarmBootStamp    warm_boot;
+	BootTiming       timing;
+	LazySegmentTable lazy;
+};
+
+static_assert(sizeof(BootInfo) <= BootInfoBounds);
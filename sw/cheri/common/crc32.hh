@@ -0,0 +1,49 @@
+/**
+ * Copyright lowRISC contributors.
+ * Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * CRC-32 (IEEE 802.3, as used by zlib) computed four bits at a time. The
+ * 16-entry table keeps the code small enough for the boot loader while
+ * still being several times faster than a bitwise loop.
+ */
+static const uint32_t Crc32NibbleTable[16] = {
+  0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4,
+  0x4db26158, 0x5005713c, 0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+  0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+};
+
+static constexpr uint32_t Crc32Init = 0xffffffff;
+
+/**
+ * Folds `len` bytes into a running CRC. Start from `Crc32Init` and pass the
+ * result through `crc32_final` once all data has been added.
+ */
+[[maybe_unused]] static uint32_t crc32_update(uint32_t       crc,
+                                              const uint8_t *data,
+                                              size_t         len)
+{
+	for (size_t i = 0; i < len; i++)
+	{
+		crc ^= data[i];
+		crc = (crc >> 4) ^ Crc32NibbleTable[crc & 0xf];
+		crc = (crc >> 4) ^ Crc32NibbleTable[crc & 0xf];
+	}
+	return crc;
+}
+
+static inline uint32_t crc32_final(uint32_t crc)
+{
+	return ~crc;
+}
+
+[[maybe_unused]] static uint32_t crc32(const uint8_t *data, size_t len)
+{
+	return crc32_final(crc32_update(Crc32Init, data, len));
+}
@@ -0,0 +1,165 @@
+/**
+ * Copyright lowRISC contributors.
+ * Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+#include "bl-mem.hh"
+#include "flash-utils.hh"
+#include <algorithm>
+#include <stdint.h>
+
+/**
+ * A read cache in front of `SpiFlash` for software that makes many small
+ * reads, each of which would otherwise pay for a full read command. Flash is
+ * cached in `LineCount` lines of `LineSize` bytes with least recently used
+ * replacement.
+ *
+ * Line storage is supplied by the caller, so it can live in SRAM or
+ * HyperRAM, and must hold `LineSize * LineCount` bytes. Erases and writes
+ * made through the cache go straight to flash and invalidate the lines they
+ * touch; flash changed behind the cache's back needs `invalidate_all()`.
+ */
+template<uint32_t LineSize, uint32_t LineCount>
+class CachedSpiFlash
+{
+	static_assert((LineSize & (LineSize - 1)) == 0,
+	              "Line size must be a power of two");
+	static_assert(LineSize >= SpiFlash::PageSize &&
+	                LineSize <= SpiFlash::SectorSize,
+	              "Lines must be between a page and a sector");
+
+	private:
+	static constexpr uint32_t InvalidLine = 0xffffffff;
+
+	// Reads at least this long skip the cache, as they would only evict
+	// lines to save a single command overhead.
+	static constexpr uint32_t BypassLen = 2 * LineSize;
+
+	SpiFlash &flash;
+	uint8_t  *storage;
+	uint32_t  line_address[LineCount];
+	uint32_t  line_last_use[LineCount];
+	uint32_t  use_counter;
+
+	/**
+	 * Returns the index of the line holding `address`, filling the least
+	 * recently used line from flash on a miss.
+	 */
+	uint32_t lookup(uint32_t address)
+	{
+		uint32_t base   = address & ~(LineSize - 1);
+		uint32_t victim = 0;
+		for (uint32_t i = 0; i < LineCount; i++)
+		{
+			if (line_address[i] == base)
+			{
+				hits++;
+				line_last_use[i] = ++use_counter;
+				return i;
+			}
+			if (line_last_use[i] < line_last_use[victim])
+			{
+				victim = i;
+			}
+		}
+
+		misses++;
+		flash.read(base, storage + victim * LineSize, LineSize);
+		line_address[victim]  = base;
+		line_last_use[victim] = ++use_counter;
+		return victim;
+	}
+
+	/**
+	 * Drops any lines overlapping `len` bytes at `address`.
+	 */
+	void invalidate(uint32_t address, uint32_t len)
+	{
+		for (uint32_t i = 0; i < LineCount; i++)
+		{
+			if (line_address[i] != InvalidLine &&
+			    line_address[i] + LineSize > address &&
+			    line_address[i] < address + len)
+			{
+				line_address[i]  = InvalidLine;
+				line_last_use[i] = 0;
+			}
+		}
+	}
+
+	public:
+	uint32_t hits   = 0;
+	uint32_t misses = 0;
+
+	CachedSpiFlash(SpiFlash &flash_, uint8_t *storage_)
+	  : flash(flash_), storage(storage_)
+	{
+		invalidate_all();
+	}
+
+	void invalidate_all()
+	{
+		for (uint32_t i = 0; i < LineCount; i++)
+		{
+			line_address[i]  = InvalidLine;
+			line_last_use[i] = 0;
+		}
+		use_counter = 0;
+	}
+
+	void reset_counters()
+	{
+		hits   = 0;
+		misses = 0;
+	}
+
+	void read(uint32_t address, uint8_t *data_out, uint32_t len)
+	{
+		if (len >= BypassLen)
+		{
+			flash.read(address, data_out, len);
+			return;
+		}
+
+		while (len > 0)
+		{
+			uint32_t offset = address & (LineSize - 1);
+			uint32_t size   = std::min(len, LineSize - offset);
+			bl_memcpy(
+			  data_out, storage + lookup(address) * LineSize + offset, size);
+			address += size;
+			data_out += size;
+			len -= size;
+		}
+	}
+
+	void erase_sector(uint32_t address)
+	{
+		invalidate(address & ~(SpiFlash::SectorSize - 1), SpiFlash::SectorSize);
+		flash.erase_sector(address);
+	}
+
+	void erase_block(uint32_t address)
+	{
+		uint32_t size = flash.block_size();
+		invalidate(address & ~(size - 1), size);
+		flash.erase_block(address);
+	}
+
+	void write_page(uint32_t address, uint8_t *data)
+	{
+		invalidate(address, SpiFlash::PageSize);
+		flash.write_page(address, data);
+	}
+
+	void write(uint32_t       address,
+	           const uint8_t *data,
+	           uint32_t       len,
+	           uint8_t       *sector)
+	{
+		invalidate(address, len);
+		flash.write(address, data, len, sector);
+	}
+};
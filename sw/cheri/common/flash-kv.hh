@@ -0,0 +1,630 @@
+/**
+ * Copyright lowRISC contributors.
+ * Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+#include "crc32.hh"
+#include "flash-utils.hh"
+#include <algorithm>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A log-structured key/value store in `SectorCount` flash sectors starting
+ * at `base`, for small values such as calibration data and counters.
+ *
+ * Each sector starts with a header holding a magic number, written once the
+ * sector has been erased, and a sequence number, written when the sector is
+ * opened for appending. Records are only ever appended to the open sector
+ * and a record for a key supersedes any older one, so updates never program
+ * a location twice. Each record carries a CRC so that a write torn by a
+ * reset is detected.
+ *
+ * `mount()` rebuilds an in-RAM hash index from key to record location by
+ * reading each sector header and each record header once, so its cost is
+ * bounded by the size of the store. Lookups then take a single flash read.
+ *
+ * Space is reclaimed by relocating the live records of the oldest sector to
+ * the open sector and erasing it. Sectors are reused in a ring, which evens
+ * out wear. `service()` does this in the background, one step per call,
+ * keeping `ReserveSectors` erased sectors ready. A `put()` only has to wait
+ * for an erase when `service()` has not kept up.
+ *
+ * Keys are 32-bit, with 0xffffffff reserved, and the index holds at most
+ * `IndexSize - 1` keys.
+ */
+template<uint32_t SectorCount, uint32_t IndexSize>
+class FlashKvStore
+{
+	public:
+	static constexpr uint32_t MaxValueLen    = 240;
+	static constexpr uint32_t ReserveSectors = 2;
+
+	private:
+	static_assert((IndexSize & (IndexSize - 1)) == 0 && IndexSize <= 0x10000,
+	              "Index size must be a power of two up to 65536");
+	static_assert(SectorCount > ReserveSectors + 1,
+	              "Store needs sectors beyond its reserve");
+
+	static constexpr uint32_t SectorMagic = 0x5356564b;  // "KVVS"
+	static constexpr uint32_t Erased      = 0xffffffff;
+	static constexpr uint32_t NoSector    = SectorCount;
+
+	static constexpr uint16_t RecordValue  = 0x0001;
+	static constexpr uint16_t RecordDelete = 0x0002;
+
+	struct SectorHeader
+	{
+		uint32_t magic;
+		uint32_t sequence;
+	};
+
+	struct RecordHeader
+	{
+		uint32_t key;
+		uint16_t len;
+		uint16_t type;
+		// CRC-32 of the fields above followed by the value.
+		uint32_t crc;
+	};
+
+	static constexpr uint32_t FirstRecord   = sizeof(SectorHeader);
+	static constexpr uint32_t SectorSpace   = SpiFlash::SectorSize - FirstRecord;
+	static constexpr uint32_t MaxRecordSize = sizeof(RecordHeader) + MaxValueLen;
+
+	// Live data is limited so that compaction always has somewhere to go.
+	static constexpr uint32_t Capacity =
+	  (SectorCount - ReserveSectors - 1) * SectorSpace;
+
+	enum class SectorState : uint8_t
+	{
+		Dirty,
+		Erasing,
+		Free,
+		Used,
+	};
+
+	struct IndexEntry
+	{
+		uint32_t key;
+		uint32_t address;
+		uint32_t size;
+	};
+
+	SpiFlash &flash;
+	uint32_t  base;
+
+	SectorState sector_state[SectorCount];
+	uint32_t    sector_sequence[SectorCount];
+	uint16_t    sector_live[SectorCount];
+	uint32_t    free_sectors;
+	uint32_t    next_sequence;
+	uint32_t    active;
+	uint32_t    write_offset;
+	uint32_t    erasing;
+
+	IndexEntry index[IndexSize];
+	uint32_t   index_count;
+	uint32_t   live_bytes;
+	bool       index_overflow;
+
+	static uint32_t record_size(uint32_t len)
+	{
+		return (sizeof(RecordHeader) + len + 3) & ~3u;
+	}
+
+	static uint32_t record_crc(const RecordHeader &header, const uint8_t *value)
+	{
+		uint32_t crc = crc32_update(
+		  Crc32Init, (const uint8_t *)&header, offsetof(RecordHeader, crc));
+		return crc32_final(crc32_update(crc, value, header.len));
+	}
+
+	uint32_t sector_address(uint32_t sector)
+	{
+		return base + sector * SpiFlash::SectorSize;
+	}
+
+	uint32_t sector_of(uint32_t address)
+	{
+		return (address - base) / SpiFlash::SectorSize;
+	}
+
+	uint32_t index_slot(uint32_t key)
+	{
+		return ((key * 0x9e3779b1) >> 16) & (IndexSize - 1);
+	}
+
+	/**
+	 * Returns the index slot holding `key`, or the empty slot where it
+	 * would go.
+	 */
+	uint32_t index_find(uint32_t key)
+	{
+		uint32_t slot = index_slot(key);
+		while (index[slot].address != Erased && index[slot].key != key)
+		{
+			slot = (slot + 1) & (IndexSize - 1);
+		}
+		return slot;
+	}
+
+	/**
+	 * Points `key` at the record of `size` bytes at `address`, releasing the
+	 * record it replaces. Returns false if the index is full.
+	 */
+	bool index_set(uint32_t key, uint32_t address, uint32_t size)
+	{
+		IndexEntry &entry = index[index_find(key)];
+		if (entry.address != Erased)
+		{
+			release(entry);
+		}
+		else if (index_count == IndexSize - 1)
+		{
+			return false;
+		}
+		else
+		{
+			index_count++;
+		}
+		entry = {key, address, size};
+		sector_live[sector_of(address)] += size;
+		live_bytes += size;
+		return true;
+	}
+
+	void index_remove(uint32_t key)
+	{
+		uint32_t slot = index_find(key);
+		if (index[slot].address == Erased)
+		{
+			return;
+		}
+		release(index[slot]);
+		index_count--;
+
+		// Shift later entries of the probe sequence back so that lookups
+		// never stop early at the hole.
+		uint32_t hole = slot;
+		while (true)
+		{
+			slot = (slot + 1) & (IndexSize - 1);
+			if (index[slot].address == Erased)
+			{
+				break;
+			}
+			uint32_t home = index_slot(index[slot].key);
+			if (((slot - home) & (IndexSize - 1)) >=
+			    ((slot - hole) & (IndexSize - 1)))
+			{
+				index[hole] = index[slot];
+				hole        = slot;
+			}
+		}
+		index[hole].address = Erased;
+	}
+
+	void release(const IndexEntry &entry)
+	{
+		sector_live[sector_of(entry.address)] -= entry.size;
+		live_bytes -= entry.size;
+	}
+
+	/**
+	 * Replays the records of a used sector into the index. Records are
+	 * checked against their CRC if `verify` is set, which is only needed
+	 * for the sector that was open when the store was last used. Returns
+	 * the offset after the last good record, or the sector size if nothing
+	 * more can be appended.
+	 */
+	uint32_t scan_sector(uint32_t sector, bool verify)
+	{
+		uint8_t  record[MaxRecordSize];
+		uint32_t address = sector_address(sector);
+		uint32_t offset  = FirstRecord;
+		while (offset + sizeof(RecordHeader) <= SpiFlash::SectorSize)
+		{
+			RecordHeader header;
+			flash.read(address + offset, (uint8_t *)&header, sizeof(header));
+			if (header.key == Erased && header.len == 0xffff)
+			{
+				return offset;
+			}
+
+			uint32_t size = record_size(header.len);
+			bool     valid =
+			  header.len <= MaxValueLen &&
+			  offset + size <= SpiFlash::SectorSize &&
+			  (header.type == RecordValue || header.type == RecordDelete);
+			if (valid && verify)
+			{
+				flash.read(address + offset + sizeof(header), record, header.len);
+				valid = record_crc(header, record) == header.crc;
+			}
+			if (!valid)
+			{
+				// Only the last record written can be torn, so close the
+				// sector rather than append after something unknown.
+				return SpiFlash::SectorSize;
+			}
+
+			if (header.type == RecordValue)
+			{
+				if (!index_set(header.key, address + offset, size))
+				{
+					index_overflow = true;
+					return SpiFlash::SectorSize;
+				}
+			}
+			else
+			{
+				index_remove(header.key);
+			}
+			offset += size;
+		}
+		return SpiFlash::SectorSize;
+	}
+
+	/**
+	 * Writes the magic number to a sector whose erase has completed.
+	 */
+	void finish_erase()
+	{
+		SectorHeader header = {SectorMagic, Erased};
+		flash.write_erased(
+		  sector_address(erasing), (uint8_t *)&header.magic, sizeof(uint32_t));
+		sector_state[erasing] = SectorState::Free;
+		free_sectors++;
+		erasing = NoSector;
+	}
+
+	void start_erase(uint32_t sector)
+	{
+		if (erasing != NoSector)
+		{
+			flash.wait_for_operation();
+			finish_erase();
+		}
+		// Clear the magic number first, so that the sector's records are not
+		// replayed by a mount that happens before the erase completes.
+		// Otherwise values whose deletions were dropped by compaction would
+		// come back.
+		uint32_t invalid = 0;
+		flash.write_erased(
+		  sector_address(sector), (uint8_t *)&invalid, sizeof(invalid));
+		flash.erase_sector_start(sector_address(sector));
+		sector_state[sector] = SectorState::Erasing;
+		erasing              = sector;
+	}
+
+	/**
+	 * Opens the next free sector after the current one for appending.
+	 */
+	void open_sector()
+	{
+		uint32_t sector = active == NoSector ? 0 : active;
+		do
+		{
+			sector = sector + 1 == SectorCount ? 0 : sector + 1;
+		} while (sector_state[sector] != SectorState::Free);
+
+		uint32_t sequence = next_sequence++;
+		flash.write_erased(sector_address(sector) +
+		                     offsetof(SectorHeader, sequence),
+		                   (uint8_t *)&sequence,
+		                   sizeof(sequence));
+		sector_state[sector]    = SectorState::Used;
+		sector_sequence[sector] = sequence;
+		free_sectors--;
+		active       = sector;
+		write_offset = FirstRecord;
+	}
+
+	/**
+	 * Appends a record holding an already encoded header and value, opening
+	 * a new sector if it does not fit in the current one. The caller must
+	 * make sure a free sector is available. Returns its address.
+	 */
+	uint32_t append(const uint8_t *record, uint32_t len)
+	{
+		uint32_t size = record_size(len - sizeof(RecordHeader));
+		if (active == NoSector || write_offset + size > SpiFlash::SectorSize)
+		{
+			open_sector();
+		}
+		uint32_t address = sector_address(active) + write_offset;
+		flash.write_erased(address, record, len);
+		write_offset += size;
+		return address;
+	}
+
+	/**
+	 * Moves the live records out of the oldest sector and starts erasing it.
+	 * Returns false if there is nothing to compact or nowhere to put the
+	 * live records.
+	 */
+	bool compact_oldest()
+	{
+		uint32_t victim = NoSector;
+		for (uint32_t i = 0; i < SectorCount; i++)
+		{
+			if (sector_state[i] == SectorState::Used && i != active &&
+			    (victim == NoSector ||
+			     sector_sequence[i] < sector_sequence[victim]))
+			{
+				victim = i;
+			}
+		}
+		if (victim == NoSector ||
+		    (free_sectors == 0 &&
+		     sector_live[victim] > SpiFlash::SectorSize - write_offset))
+		{
+			return false;
+		}
+
+		uint8_t  record[MaxRecordSize];
+		uint32_t address = sector_address(victim);
+		for (uint32_t offset = FirstRecord;
+		     sector_live[victim] > 0 && offset < SpiFlash::SectorSize;)
+		{
+			RecordHeader &header = *(RecordHeader *)record;
+			flash.read(address + offset, record, sizeof(header));
+			uint32_t size = record_size(header.len);
+
+			// Deletions can be dropped: any value they hid was in an older
+			// sector, and this is the oldest.
+			IndexEntry &entry = index[index_find(header.key)];
+			if (header.type == RecordValue && entry.address == address + offset)
+			{
+				uint32_t len = sizeof(header) + header.len;
+				flash.read(address + offset, record, len);
+				index_set(header.key, append(record, len), size);
+			}
+			offset += size;
+		}
+
+		sector_state[victim] = SectorState::Dirty;
+		start_erase(victim);
+		return true;
+	}
+
+	/**
+	 * Makes progress towards freeing a sector, waiting for flash if need be.
+	 */
+	bool reclaim_now()
+	{
+		if (erasing != NoSector)
+		{
+			flash.wait_for_operation();
+			finish_erase();
+			return true;
+		}
+		for (uint32_t i = 0; i < SectorCount; i++)
+		{
+			if (sector_state[i] == SectorState::Dirty)
+			{
+				start_erase(i);
+				return true;
+			}
+		}
+		return compact_oldest();
+	}
+
+	/**
+	 * Makes room for a record of `size` bytes. A new sector is only opened
+	 * for ordinary writes while another stays free for compaction.
+	 */
+	bool reserve(uint32_t size)
+	{
+		if (active != NoSector && write_offset + size <= SpiFlash::SectorSize)
+		{
+			return true;
+		}
+		for (uint32_t attempts = 0; free_sectors < 2; attempts++)
+		{
+			if (attempts == 2 * SectorCount || !reclaim_now())
+			{
+				return false;
+			}
+		}
+		open_sector();
+		return true;
+	}
+
+	bool write_record(uint32_t       key,
+	                  uint16_t       type,
+	                  const uint8_t *data,
+	                  uint32_t       len)
+	{
+		uint8_t       record[MaxRecordSize];
+		RecordHeader &header = *(RecordHeader *)record;
+		header.key           = key;
+		header.len           = len;
+		header.type          = type;
+		for (uint32_t i = 0; i < len; i++)
+		{
+			record[sizeof(header) + i] = data[i];
+		}
+		header.crc = record_crc(header, data);
+
+		if (!reserve(record_size(len)))
+		{
+			return false;
+		}
+		uint32_t address = append(record, sizeof(header) + len);
+		if (type == RecordValue)
+		{
+			return index_set(key, address, record_size(len));
+		}
+		index_remove(key);
+		return true;
+	}
+
+	public:
+	FlashKvStore(SpiFlash &flash_, uint32_t base_) : flash(flash_), base(base_)
+	{
+	}
+
+	/**
+	 * Rebuilds the in-RAM state from flash. Sectors without a valid header
+	 * are left for `service()` to erase. Returns false if the index is too
+	 * small for the keys found.
+	 */
+	bool mount()
+	{
+		free_sectors  = 0;
+		next_sequence = 0;
+		active        = NoSector;
+		write_offset  = SpiFlash::SectorSize;
+		erasing       = NoSector;
+		index_count    = 0;
+		live_bytes     = 0;
+		index_overflow = false;
+		for (uint32_t i = 0; i < IndexSize; i++)
+		{
+			index[i].address = Erased;
+		}
+
+		// Sort the used sectors by sequence number as the headers are read.
+		uint16_t order[SectorCount];
+		uint32_t used = 0;
+		for (uint32_t i = 0; i < SectorCount; i++)
+		{
+			SectorHeader header;
+			flash.read(sector_address(i), (uint8_t *)&header, sizeof(header));
+			sector_live[i] = 0;
+			if (header.magic != SectorMagic)
+			{
+				sector_state[i] = SectorState::Dirty;
+			}
+			else if (header.sequence == Erased)
+			{
+				sector_state[i] = SectorState::Free;
+				free_sectors++;
+			}
+			else
+			{
+				sector_state[i]    = SectorState::Used;
+				sector_sequence[i] = header.sequence;
+				uint32_t pos       = used++;
+				for (; pos > 0 && sector_sequence[order[pos - 1]] > header.sequence;
+				     pos--)
+				{
+					order[pos] = order[pos - 1];
+				}
+				order[pos]    = i;
+				next_sequence = std::max(next_sequence, header.sequence + 1);
+			}
+		}
+
+		for (uint32_t i = 0; i < used; i++)
+		{
+			write_offset = scan_sector(order[i], i + 1 == used);
+		}
+		if (used > 0)
+		{
+			active = order[used - 1];
+		}
+		return !index_overflow;
+	}
+
+	/**
+	 * Stores `len` bytes of `data` under `key`. Returns false if the value
+	 * is too long, the store or its index is full, or `key` is reserved.
+	 */
+	bool put(uint32_t key, const uint8_t *data, uint32_t len)
+	{
+		if (key == Erased || len > MaxValueLen)
+		{
+			return false;
+		}
+		IndexEntry &entry    = index[index_find(key)];
+		uint32_t    replaced = entry.address == Erased ? 0 : entry.size;
+		if (live_bytes - replaced + record_size(len) > Capacity ||
+		    (replaced == 0 && index_count == IndexSize - 1))
+		{
+			return false;
+		}
+		return write_record(key, RecordValue, data, len);
+	}
+
+	/**
+	 * Copies the value stored under `key` into `data_out`, which has room
+	 * for `max_len` bytes. Returns the length of the value, or -1 if there is
+	 * none, it does not fit, or it is corrupt.
+	 */
+	int32_t get(uint32_t key, uint8_t *data_out, uint32_t max_len)
+	{
+		IndexEntry &entry = index[index_find(key)];
+		if (entry.address == Erased)
+		{
+			return -1;
+		}
+
+		uint8_t       record[MaxRecordSize];
+		RecordHeader &header = *(RecordHeader *)record;
+		flash.read(entry.address, record, entry.size);
+		const uint8_t *value = record + sizeof(header);
+		if (header.len > max_len || record_crc(header, value) != header.crc)
+		{
+			return -1;
+		}
+		for (uint32_t i = 0; i < header.len; i++)
+		{
+			data_out[i] = value[i];
+		}
+		return header.len;
+	}
+
+	/**
+	 * Deletes `key`. Returns false if the deletion could not be recorded.
+	 */
+	bool remove(uint32_t key)
+	{
+		if (index[index_find(key)].address == Erased)
+		{
+			return true;
+		}
+		return write_record(key, RecordDelete, nullptr, 0);
+	}
+
+	/**
+	 * Does one step of background maintenance: finishing an erase, erasing
+	 * a sector left dirty, or compacting the oldest sector while fewer than
+	 * `ReserveSectors` sectors are free. Never waits for an erase. Returns
+	 * true if there may be more to do.
+	 */
+	bool service()
+	{
+		if (erasing != NoSector)
+		{
+			if (flash.operation_busy())
+			{
+				return true;
+			}
+			finish_erase();
+		}
+		for (uint32_t i = 0; i < SectorCount; i++)
+		{
+			if (sector_state[i] == SectorState::Dirty)
+			{
+				start_erase(i);
+				return true;
+			}
+		}
+		return free_sectors < ReserveSectors && compact_oldest();
+	}
+
+	uint32_t keys()
+	{
+		return index_count;
+	}
+
+	uint32_t free_sector_count()
+	{
+		return free_sectors;
+	}
+};
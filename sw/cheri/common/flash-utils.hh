@@ -6,6 +6,7 @@
 
 #pragma once
 #include "timer-utils.hh"
+#include <algorithm>
 #include <cheri.hh>
 #include <platform-gpio.hh>
 #include <platform-spi.hh>
@@ -18,42 +19,453 @@ static const uint8_t CmdReset               = 0x99;
 static const uint8_t CmdReadJEDECId         = 0x9f;
 static const uint8_t CmdWriteEnable         = 0x06;
 static const uint8_t CmdSectorErase         = 0x20;
+static const uint8_t CmdSectorErase4Addr    = 0x21;
+static const uint8_t CmdBlockErase32K       = 0x52;
+static const uint8_t CmdBlockErase32K4Addr  = 0x5c;
+static const uint8_t CmdBlockErase64K       = 0xd8;
+static const uint8_t CmdBlockErase64K4Addr  = 0xdc;
 static const uint8_t CmdReadStatusRegister1 = 0x05;
+static const uint8_t CmdReadStatusRegister2 = 0x35;
+static const uint8_t CmdSuspend             = 0x75;
+static const uint8_t CmdResume              = 0x7a;
 static const uint8_t CmdPageProgram         = 0x02;
+static const uint8_t CmdPageProgram4Addr    = 0x12;
 static const uint8_t CmdReadData            = 0x03;
 static const uint8_t CmdReadData4Addr       = 0x13;
+static const uint8_t CmdFastReadData4Addr   = 0x0c;
+static const uint8_t CmdReadSfdp            = 0x5a;
+
+/**
+ * Read modes a flash device may support, named after the number of lanes used
+ * for the data phase of the read.
+ */
+enum class FlashReadMode : uint8_t
+{
+	Read       = 0, // 0x13 read, no dummy cycles.
+	FastRead   = 1, // 0x0c fast read, 8 dummy cycles.
+	DualOutput = 2, // 1-1-2 fast read.
+	QuadOutput = 3, // 1-1-4 fast read.
+};
 
 class SpiFlash
 {
 	private:
-	SpiRef   spi;
-	GpioRef  gpio;
-	uint32_t csn_bit;
+	// Maximum number of bytes transferred by a single SPI operation.
+	static constexpr uint32_t MaxTransferLen = 0x400;
+
+	// The Sonata SPI controller only drives a single data lane in each
+	// direction, so the multi-lane read modes cannot be used even when the
+	// flash device supports them.
+	static constexpr uint8_t ControllerReadModes =
+	  (1 << uint8_t(FlashReadMode::Read)) |
+	  (1 << uint8_t(FlashReadMode::FastRead));
+
+	// Offsets into the Serial Flash Discoverable Parameters (JESD216).
+	static constexpr uint32_t SfdpSignature        = 0x50444653; // "SFDP"
+	static constexpr uint32_t SfdpBasicTableDwords = 9;
+
+	// The SPI block's chip select register, which follows the registers in
+	// `SonataSpi`. The flash is on its first chip select line.
+	static constexpr size_t   CsRegister = 0x2c / sizeof(uint32_t);
+	static constexpr uint32_t CsFlash    = 1 << 0;
+	static constexpr uint32_t CsHold     = 1u << 31;
+
+	SpiRef spi;
+
+	// Bitmap of `FlashReadMode`s supported by the flash device.
+	uint8_t       supported_read_modes;
+	FlashReadMode current_read_mode;
+
+	// The largest erase operation supported by the flash device.
+	uint8_t  block_erase_cmd;
+	uint32_t block_erase_size;
+
+	// An erase or program has been started and may not have completed.
+	bool operation_pending;
+	// The pending operation is an erase rather than a program.
+	bool operation_is_erase;
+	// The pending operation is suspended for a read.
+	bool     operation_suspended;
+	uint32_t resume_cycle;
 
+	// The flash ignores a suspend that comes too soon after a resume (tSUS,
+	// 20us on the Sonata flash). Waiting also guarantees the operation some
+	// progress between back to back reads.
+	static constexpr uint32_t MinResumeToSuspendCycles = 1000;
+
+	/**
+	 * Holds chip select asserted between SPI operations, or releases it.
+	 * Each operation asserts it anyway, so a single operation transaction
+	 * needs no call. The blocking operations all return once the SPI block
+	 * is idle, so releasing takes effect straight away.
+	 */
 	void set_cs(bool enable)
 	{
-		gpio->output =
-		  enable ? (gpio->output & ~csn_bit) : (gpio->output | csn_bit);
+		reinterpret_cast<volatile uint32_t *>(spi.get())[CsRegister] =
+		  CsFlash | (enable ? CsHold : 0);
 	}
 
-	public:
-	SpiFlash(SpiRef spi_, GpioRef gpio_, size_t csn_index)
-	  : spi(spi_), gpio(gpio_), csn_bit(1 << csn_index)
+	uint8_t read_status(uint8_t cmd)
 	{
+		uint8_t status;
+		set_cs(true);
+		spi->blocking_write(&cmd, 1);
+		spi->blocking_read(&status, 1);
+		set_cs(false);
+		return status;
 	}
 
-	void reset()
+	void write_command(uint8_t cmd)
+	{
+		spi->blocking_write(&cmd, 1);
+	}
+
+	void wait_while_busy()
 	{
 		set_cs(true);
-		spi->blocking_write(&CmdEnableReset, 1);
+		spi->blocking_write(&CmdReadStatusRegister1, 1);
+
+		uint8_t status;
+		do
+		{
+			spi->blocking_read(&status, 1);
+		} while ((status & 0x1) == 1);
+
 		set_cs(false);
+	}
+
+	/**
+	 * Sends `cmd` followed by a 4-byte address, after a write enable. Erase
+	 * and program commands all take this form, and using 4-byte addresses
+	 * (as reads already do) reaches the whole of the 32 MiB flash.
+	 */
+	void write_command_start(uint8_t cmd, uint32_t address)
+	{
+		// A suspended erase stays pending while a page is programmed.
+		if (!operation_suspended)
+		{
+			wait_for_operation();
+		}
+		operation_pending = true;
+
+		const uint8_t addr_cmd[5] = {cmd,
+		                             uint8_t((address >> 24) & 0xff),
+		                             uint8_t((address >> 16) & 0xff),
+		                             uint8_t((address >> 8) & 0xff),
+		                             uint8_t(address & 0xff)};
+
+		write_command(CmdWriteEnable);
 
 		set_cs(true);
-		spi->blocking_write(&CmdReset, 1);
+		spi->blocking_write(addr_cmd, 5);
+	}
+
+	/**
+	 * Starts the 4-byte address form of the 3-byte address erase `cmd`,
+	 * which must be a sector, 32 KiB block or 64 KiB block erase.
+	 */
+	void erase_start(uint8_t cmd, uint32_t address)
+	{
+		switch (cmd)
+		{
+			case CmdSectorErase:
+				cmd = CmdSectorErase4Addr;
+				break;
+			case CmdBlockErase32K:
+				cmd = CmdBlockErase32K4Addr;
+				break;
+			case CmdBlockErase64K:
+				cmd = CmdBlockErase64K4Addr;
+				break;
+		}
+		write_command_start(cmd, address);
 		set_cs(false);
+		operation_is_erase = true;
+	}
+
+	void erase(uint8_t cmd, uint32_t address)
+	{
+		erase_start(cmd, address);
+		wait_for_operation();
+	}
+
+	/**
+	 * Starts programming `len` bytes, which must not cross a page boundary.
+	 */
+	void program_start(uint32_t address, const uint8_t *data, uint32_t len)
+	{
+		if (!operation_suspended)
+		{
+			operation_is_erase = false;
+		}
+		write_command_start(CmdPageProgram4Addr, address);
+		spi->blocking_write(data, len);
+		set_cs(false);
+	}
+
+	void program(uint32_t address, const uint8_t *data, uint32_t len)
+	{
+		program_start(address, data, len);
+		if (operation_suspended)
+		{
+			wait_while_busy();
+		}
+		else
+		{
+			wait_for_operation();
+		}
+	}
+
+	/**
+	 * Suspends any pending erase or program so that the flash array can be
+	 * read. Does nothing if the operation has already completed.
+	 */
+	void suspend_operation()
+	{
+		if (!operation_pending || !operation_busy())
+		{
+			return;
+		}
+		while (get_mcycle() - resume_cycle < MinResumeToSuspendCycles) {}
+		write_command(CmdSuspend);
+		wait_while_busy();
+		// The operation may have completed before the suspend took effect.
+		operation_suspended = read_status(CmdReadStatusRegister2) & 0x80;
+		operation_pending   = operation_suspended;
+	}
+
+	void resume_operation()
+	{
+		if (operation_suspended)
+		{
+			write_command(CmdResume);
+			operation_suspended = false;
+			resume_cycle        = get_mcycle();
+		}
+	}
+
+	/**
+	 * Programs `len` bytes from `data`, splitting the write at page
+	 * boundaries and skipping pages that already hold the right data.
+	 * `old` is the current flash contents, or null if the range has just
+	 * been erased.
+	 */
+	void program_changed(uint32_t       address,
+	                     const uint8_t *data,
+	                     uint32_t       len,
+	                     const uint8_t *old)
+	{
+		while (len > 0)
+		{
+			uint32_t size =
+			  std::min(len, PageSize - (address & (PageSize - 1)));
+			for (uint32_t i = 0; i < size; i++)
+			{
+				if (data[i] != (old ? old[i] : 0xff))
+				{
+					program(address, data, size);
+					break;
+				}
+			}
+			address += size;
+			data += size;
+			len -= size;
+			if (old)
+			{
+				old += size;
+			}
+		}
+	}
+
+	enum class Update
+	{
+		None,
+		Program,
+		Erase,
+	};
+
+	/**
+	 * Works out what it takes to turn `old` flash contents into `data`.
+	 * Programming can only clear bits, so anything else needs an erase.
+	 */
+	static Update compare(const uint8_t *old, const uint8_t *data, uint32_t len)
+	{
+		Update update = Update::None;
+		for (uint32_t i = 0; i < len; i++)
+		{
+			if (old[i] != data[i])
+			{
+				if ((old[i] & data[i]) != data[i])
+				{
+					return Update::Erase;
+				}
+				update = Update::Program;
+			}
+		}
+		return update;
+	}
+
+	void read_sfdp(uint32_t address, uint8_t *data_out, uint32_t len)
+	{
+		// The SFDP read always uses a 3-byte address and 8 dummy cycles.
+		const uint8_t sfdp_cmd[5] = {CmdReadSfdp,
+		                             uint8_t((address >> 16) & 0xff),
+		                             uint8_t((address >> 8) & 0xff),
+		                             uint8_t(address & 0xff),
+		                             0};
+		set_cs(true);
+		spi->blocking_write(sfdp_cmd, 5);
+		spi->blocking_read(data_out, len);
+		set_cs(false);
+	}
+
+	/**
+	 * Reads the JEDEC Basic Flash Parameter Table to find out which read
+	 * modes and erase sizes the device supports. Leaves the conservative
+	 * defaults in place if the device has no valid SFDP.
+	 */
+	void discover_parameters()
+	{
+		supported_read_modes = 1 << uint8_t(FlashReadMode::Read);
+		block_erase_cmd      = CmdSectorErase;
+		block_erase_size     = SectorSize;
+
+		uint32_t header[4];
+		read_sfdp(0, (uint8_t *)header, sizeof(header));
+		if (header[0] != SfdpSignature)
+		{
+			return;
+		}
+
+		// The first parameter header always describes the basic table.
+		uint32_t table_dwords  = header[2] >> 24;
+		uint32_t table_pointer = header[3] & 0xffffff;
+
+		// Entries beyond the length the device reports read as zero, which
+		// advertises nothing.
+		uint32_t table[SfdpBasicTableDwords] = {};
+		read_sfdp(table_pointer,
+		          (uint8_t *)table,
+		          sizeof(uint32_t) *
+		            std::min(table_dwords, SfdpBasicTableDwords));
+
+		// Fast read with 8 dummy cycles is mandatory for any device with SFDP.
+		supported_read_modes |= 1 << uint8_t(FlashReadMode::FastRead);
+		if (table[0] & (1 << 16))
+		{
+			supported_read_modes |= 1 << uint8_t(FlashReadMode::DualOutput);
+		}
+		if (table[0] & (1 << 22))
+		{
+			supported_read_modes |= 1 << uint8_t(FlashReadMode::QuadOutput);
+		}
+
+		if (table_dwords < SfdpBasicTableDwords)
+		{
+			return;
+		}
+
+		// Dwords 8 and 9 hold up to four erase types as a size exponent and
+		// an opcode each. A size exponent of zero marks an unused entry. Only
+		// the block erases that `erase_start()` has a 4-byte address form for
+		// are used; any other erase type leaves the sector erase in place.
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			uint32_t entry    = table[7 + i / 2] >> (16 * (i % 2));
+			uint32_t exponent = entry & 0xff;
+			uint8_t  opcode   = (entry >> 8) & 0xff;
+			bool     mapped =
+			  opcode == CmdBlockErase32K || opcode == CmdBlockErase64K;
+			if (mapped && exponent != 0 && exponent < 32 &&
+			    (1u << exponent) > block_erase_size)
+			{
+				block_erase_size = 1u << exponent;
+				block_erase_cmd  = opcode;
+			}
+		}
+	}
+
+	public:
+	static constexpr uint32_t PageSize   = 256;
+	static constexpr uint32_t SectorSize = 4096;
+
+	/**
+	 * Chip select is driven by the SPI block, with the GPIO output at
+	 * `csn_index`, which can also assert it, set high.
+	 */
+	SpiFlash(SpiRef spi_, GpioRef gpio, size_t csn_index)
+	  : spi(spi_),
+	    supported_read_modes(1 << uint8_t(FlashReadMode::Read)),
+	    current_read_mode(FlashReadMode::Read),
+	    block_erase_cmd(CmdSectorErase),
+	    block_erase_size(SectorSize),
+	    operation_pending(false),
+	    operation_is_erase(false),
+	    operation_suspended(false),
+	    resume_cycle(0)
+	{
+		gpio->output = gpio->output | (1 << csn_index);
+		set_cs(false);
+	}
+
+	void reset()
+	{
+		write_command(CmdEnableReset);
+		write_command(CmdReset);
 
 		// Need to wait at least 30us for the reset to complete.
 		wait_mcycle(2000);
+
+		discover_parameters();
+
+		// The controller only drives a single lane (see
+		// `ControllerReadModes`), and a single lane fast read is not worth it:
+		// the SPI clock is well below the limit of the plain read command, so
+		// its extra dummy byte would only slow reads down.
+		current_read_mode = FlashReadMode::Read;
+	}
+
+	/**
+	 * Returns true if `mode` is supported by both the flash device and the
+	 * SPI controller.
+	 */
+	bool read_mode_usable(FlashReadMode mode)
+	{
+		return (supported_read_modes & ControllerReadModes) &
+		       (1 << uint8_t(mode));
+	}
+
+	bool read_mode_supported_by_flash(FlashReadMode mode)
+	{
+		return supported_read_modes & (1 << uint8_t(mode));
+	}
+
+	/**
+	 * Selects the command used by subsequent reads. Returns false, leaving
+	 * the current mode unchanged, if `mode` cannot be used.
+	 */
+	bool set_read_mode(FlashReadMode mode)
+	{
+		if (!read_mode_usable(mode))
+		{
+			return false;
+		}
+		current_read_mode = mode;
+		return true;
+	}
+
+	FlashReadMode read_mode()
+	{
+		return current_read_mode;
+	}
+
+	/**
+	 * Size in bytes of the largest erase supported, as used by
+	 * `erase_block()`.
+	 */
+	uint32_t block_size()
+	{
+		return block_erase_size;
 	}
 
 	void read_jedec_id(uint8_t *jedec_id_out)
@@ -64,71 +476,228 @@ class SpiFlash
 		set_cs(false);
 	}
 
+	/**
+	 * Returns true while an erase or program started with one of the
+	 * `_start` functions is still in progress.
+	 */
+	bool operation_busy()
+	{
+		if (operation_pending && !operation_suspended &&
+		    !(read_status(CmdReadStatusRegister1) & 0x1))
+		{
+			operation_pending = false;
+		}
+		return operation_pending;
+	}
+
+	/**
+	 * Waits for an erase or program started with one of the `_start`
+	 * functions to complete.
+	 */
+	void wait_for_operation()
+	{
+		if (operation_pending)
+		{
+			wait_while_busy();
+			operation_pending = false;
+		}
+	}
+
 	void erase_sector(uint32_t address)
 	{
-		const uint8_t erase_cmd[4] = {CmdSectorErase,
-		                              uint8_t((address >> 16) & 0xff),
-		                              uint8_t((address >> 8) & 0xff),
-		                              uint8_t(address & 0xff)};
+		erase(CmdSectorErase, address);
+	}
 
-		set_cs(true);
-		spi->blocking_write(&CmdWriteEnable, 1);
-		set_cs(false);
+	/**
+	 * Starts erasing the sector containing `address` and returns without
+	 * waiting for the erase to complete. Reads issued in the meantime
+	 * suspend the erase and resume it afterwards, though they must not read
+	 * from the sector being erased. Any other erase or program waits for
+	 * this one to finish first.
+	 */
+	void erase_sector_start(uint32_t address)
+	{
+		erase_start(CmdSectorErase, address);
+	}
 
-		set_cs(true);
-		spi->blocking_write(erase_cmd, 4);
-		set_cs(false);
+	/**
+	 * As `erase_sector_start()`, for the `block_size()` sized block
+	 * containing `address`.
+	 */
+	void erase_block_start(uint32_t address)
+	{
+		erase_start(block_erase_cmd, address & ~(block_erase_size - 1));
+	}
 
-		set_cs(true);
-		spi->blocking_write(&CmdReadStatusRegister1, 1);
+	/**
+	 * Erases the `block_size()` sized block containing `address`.
+	 */
+	void erase_block(uint32_t address)
+	{
+		erase(block_erase_cmd, address & ~(block_erase_size - 1));
+	}
 
-		uint8_t status;
-		do
+	void write_page(uint32_t address, uint8_t *data)
+	{
+		program(address, data, PageSize);
+	}
+
+	/**
+	 * Programs `len` bytes of `data` at `address`, which must already be
+	 * erased, splitting the write at page boundaries. Unlike `write()` this
+	 * does not read the flash back first, so it suits append-only use.
+	 *
+	 * A pending erase is suspended rather than waited for, as the flash can
+	 * program pages outside the sector or block being erased while an erase
+	 * is suspended. `address` must not be in that sector or block. A pending
+	 * program cannot be suspended for this and is waited for.
+	 */
+	void write_erased(uint32_t address, const uint8_t *data, uint32_t len)
+	{
+		if (!operation_is_erase)
 		{
-			spi->blocking_read(&status, 1);
-		} while ((status & 0x1) == 1);
+			wait_for_operation();
+		}
+		suspend_operation();
+		program_changed(address, data, len, nullptr);
+		resume_operation();
+	}
 
-		set_cs(false);
+	/**
+	 * Starts programming a page and returns without waiting for it to
+	 * complete, which behaves like `erase_sector_start()`.
+	 */
+	void write_page_start(uint32_t address, const uint8_t *data)
+	{
+		program_start(address, data, PageSize);
 	}
 
-	void write_page(uint32_t address, uint8_t *data)
+	/**
+	 * Writes `len` bytes of `data` to flash at `address`, preserving the rest
+	 * of any partially covered sector.
+	 *
+	 * Each sector is read back first. Sectors that already match are left
+	 * alone, changes that only clear bits are programmed in place, and only
+	 * sectors that really need it are erased. Fully covered blocks of
+	 * `block_size()` bytes that need an erase get a single block erase.
+	 * Programming is split at page boundaries and skips unchanged pages, so
+	 * the cost of an update follows the size of the difference rather than
+	 * the size of the data.
+	 *
+	 * `sector` is scratch space of `SectorSize` bytes supplied by the caller,
+	 * so it can live wherever there is room rather than on the stack.
+	 */
+	void write(uint32_t       address,
+	           const uint8_t *data,
+	           uint32_t       len,
+	           uint8_t       *sector)
 	{
-		const uint8_t write_cmd[4] = {CmdPageProgram,
-		                              uint8_t((address >> 16) & 0xff),
-		                              uint8_t((address >> 8) & 0xff),
-		                              uint8_t(address & 0xff)};
+		uint32_t end = address + len;
+		while (address < end)
+		{
+			if (block_erase_size > SectorSize &&
+			    (address & (block_erase_size - 1)) == 0 &&
+			    end - address >= block_erase_size)
+			{
+				// Program what can be programmed in place until a sector
+				// is found that needs an erase, then redo the whole block.
+				bool needs_erase = false;
+				for (uint32_t offset = 0; offset < block_erase_size;
+				     offset += SectorSize)
+				{
+					read(address + offset, sector, SectorSize);
+					Update update = compare(sector, data + offset, SectorSize);
+					if (update == Update::Erase)
+					{
+						needs_erase = true;
+						break;
+					}
+					if (update == Update::Program)
+					{
+						program_changed(
+						  address + offset, data + offset, SectorSize, sector);
+					}
+				}
+				if (needs_erase)
+				{
+					erase_block(address);
+					program_changed(address, data, block_erase_size, nullptr);
+				}
+				address += block_erase_size;
+				data += block_erase_size;
+				continue;
+			}
 
-		set_cs(true);
-		spi->blocking_write(&CmdWriteEnable, 1);
-		set_cs(false);
+			uint32_t sector_base = address & ~(SectorSize - 1);
+			uint32_t offset      = address - sector_base;
+			uint32_t size        = std::min(end - address, SectorSize - offset);
+			read(sector_base, sector, SectorSize);
+			Update update = compare(sector + offset, data, size);
+			if (update == Update::Program)
+			{
+				program_changed(address, data, size, sector + offset);
+			}
+			else if (update == Update::Erase)
+			{
+				for (uint32_t i = 0; i < size; i++)
+				{
+					sector[offset + i] = data[i];
+				}
+				erase_sector(sector_base);
+				program_changed(sector_base, sector, SectorSize, nullptr);
+			}
+			address += size;
+			data += size;
+		}
+	}
 
-		set_cs(true);
-		spi->blocking_write(write_cmd, 4);
-		spi->blocking_write(data, 256);
-		set_cs(false);
+	/**
+	 * Starts a read at `address` that is kept open until `read_stream_end()`
+	 * is called. The read command is only sent once, so any number of
+	 * `read_stream()` calls can follow to fetch consecutive bytes without
+	 * the chip select and command overhead of separate `read()` calls.
+	 *
+	 * A pending erase or program is suspended for the duration of the read.
+	 */
+	void read_stream_start(uint32_t address)
+	{
+		suspend_operation();
 
+		bool          fast        = current_read_mode == FlashReadMode::FastRead;
+		const uint8_t read_cmd[6] = {
+		  fast ? CmdFastReadData4Addr : CmdReadData4Addr,
+		  uint8_t((address >> 24) & 0xff),
+		  uint8_t((address >> 16) & 0xff),
+		  uint8_t((address >> 8) & 0xff),
+		  uint8_t(address & 0xff),
+		  0, // Dummy byte for the fast read.
+		};
 		set_cs(true);
-		spi->blocking_write(&CmdReadStatusRegister1, 1);
+		spi->blocking_write(read_cmd, fast ? 6 : 5);
+	}
 
-		uint8_t status;
-		do
+	void read_stream(uint8_t *data_out, uint32_t len)
+	{
+		// A single SPI operation can only transfer a limited number of bytes,
+		// so split the read up. The flash keeps streaming data for as long as
+		// the chip select is held, so this costs no extra flash commands.
+		for (uint32_t offset = 0; offset < len; offset += MaxTransferLen)
 		{
-			spi->blocking_read(&status, 1);
-		} while ((status & 0x1) == 1);
+			uint32_t size = std::min(len - offset, MaxTransferLen);
+			spi->blocking_read(data_out + offset, size);
+		}
+	}
 
+	void read_stream_end()
+	{
 		set_cs(false);
+		resume_operation();
 	}
 
 	void read(uint32_t address, uint8_t *data_out, uint32_t len)
 	{
-		const uint8_t read_cmd[5] = {CmdReadData4Addr,
-		                             uint8_t((address >> 24) & 0xff),
-		                             uint8_t((address >> 16) & 0xff),
-		                             uint8_t((address >> 8) & 0xff),
-		                             uint8_t(address & 0xff)};
-		set_cs(true);
-		spi->blocking_write(read_cmd, 5);
-		spi->blocking_read(data_out, len);
-		set_cs(false);
+		read_stream_start(address);
+		read_stream(data_out, len);
+		read_stream_end();
 	}
 };
@@ -0,0 +1,460 @@
+/**
+ * Copyright lowRISC contributors.
+ * Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+#include "bl-mem.hh"
+#include "boot-info.hh"
+#include "crc32.hh"
+#include "flash-utils.hh"
+#include <algorithm>
+#include <cheri.hh>
+#include <stddef.h>
+#include <stdint.h>
+
+// From lazy_trap.S.
+extern "C" {
+	void *lazy_trap_install(void *loader);
+}
+
+/**
+ * State saved by the lazy segment trap entry. Slot n of `registers` holds
+ * cn, and `pcc` the capability to the trapping instruction. The handler may
+ * replace any of them before they are restored.
+ */
+struct LazyTrapFrame
+{
+	void *registers[16];
+	void *pcc;
+};
+
+/**
+ * Fills in the lazy segments the boot loader left in flash, a
+ * `LazyChunkSize` chunk at a time, so that boot time does not depend on the
+ * size of rarely used read-only data. Each chunk is checked against the
+ * CRC-32 the boot image stores for it before it is used.
+ *
+ * Software reaches a lazy segment through `capability()`, a handle with the
+ * bounds of the segment but without load permission. Pointer arithmetic on
+ * the handle works as on any capability, and once `install()` has been
+ * called, a load through it or anything derived from it raises a CHERI
+ * permission fault. The trap handler loads the chunks that the faulting
+ * load touches, performs the load on the program's behalf and resumes after
+ * it. When every chunk of the segment is in place, the handler instead
+ * gives the faulting register load permission, so later loads through it
+ * run at full speed. Any other trap is passed on to the trap handler that
+ * was installed before, which is entered with ct0 holding its own address
+ * and every other register as it was when the trap was taken. The loader
+ * stays installed.
+ *
+ * `ensure()` loads a range up front, for software that would rather not
+ * take the faults, or that reads lazy data while it has a flash read open,
+ * as the handler uses the same flash device.
+ *
+ * Nothing is written to a lazy segment's memory before its chunks are
+ * loaded, so that boot time does not grow with the segment. Reading it
+ * through its link-time address, rather than a capability from this loader,
+ * sees whatever HyperRAM held until then.
+ */
+class LazyLoader
+{
+	private:
+	typedef bool (*TrapHandler)(LazyTrapFrame *, LazyLoader *);
+
+	// Found by lazy_trap.S at offsets 0 and 8.
+	TrapHandler                         handler;
+	void                               *previous_handler;
+	SpiFlash                           &flash;
+	CHERI::Capability<void>             root;
+	CHERI::Capability<uint8_t>          hyperram;
+	CHERI::Capability<LazySegmentTable> table;
+
+	// A CHERI exception has the cause in mtval[4:0] and the register that
+	// caused it in mtval[10:5].
+	static constexpr uint32_t McauseCheriFault         = 0x1c;
+	static constexpr uint32_t CheriPermitLoadViolation = 0x12;
+
+	static constexpr uint32_t ChunkMask = ~(LazyChunkSize - 1);
+
+	static constexpr CHERI::PermissionSet HandlePermissions{
+	  CHERI::Permission::Global};
+	static constexpr CHERI::PermissionSet LoadedPermissions{
+	  CHERI::Permission::Global, CHERI::Permission::Load};
+
+	/**
+	 * A load instruction that faulted on a handle.
+	 */
+	struct Load
+	{
+		uint32_t address;
+		uint32_t size;
+		// Destination register.
+		uint32_t rd;
+		bool     sign_extend;
+		// Length of the instruction in bytes.
+		uint32_t length;
+	};
+
+	uint32_t chunk_index(uint32_t address)
+	{
+		return (address - HYPERRAM_ADDRESS) / LazyChunkSize;
+	}
+
+	bool chunk_loaded(uint32_t address)
+	{
+		uint32_t index = chunk_index(address);
+		return table->loaded[index / 32] & (1u << (index % 32));
+	}
+
+	bool segment_loaded(const LazySegment &segment)
+	{
+		for (uint32_t chunk = segment.vaddr & ChunkMask;
+		     chunk < segment.vaddr + segment.memsz;
+		     chunk += LazyChunkSize)
+		{
+			if (!chunk_loaded(chunk))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Returns a capability with `permissions` over `len` bytes at `base`,
+	 * pointing at `address`. Large ranges may get slightly wider bounds, as
+	 * the boot loader's own capability to a segment does, but no wider than
+	 * the chunks they occupy.
+	 */
+	CHERI::Capability<const void>
+	make_capability(uint32_t             base,
+	                uint32_t             len,
+	                uint32_t             address,
+	                CHERI::PermissionSet permissions)
+	{
+		CHERI::Capability<const void> capability = root.cast<const void>();
+		capability.address()                     = base;
+		capability.bounds().set_inexact(len);
+		capability.address() = address;
+		capability.permissions() &= permissions;
+		return capability;
+	}
+
+	/**
+	 * Returns the lazy segment that `capability` is a handle to. Software may
+	 * narrow a handle to part of its segment, but it must not reach beyond
+	 * the chunks the segment occupies.
+	 */
+	const LazySegment *find_handle(CHERI::Capability<void> capability)
+	{
+		if (!capability.is_valid() ||
+		    capability.permissions().contains(CHERI::Permission::Load))
+		{
+			return nullptr;
+		}
+		for (uint32_t i = 0; i < table->count; i++)
+		{
+			const LazySegment &segment = table->segments[i];
+			uint32_t           first   = segment.vaddr & ChunkMask;
+			uint32_t           end =
+			  (segment.vaddr + segment.memsz + LazyChunkSize - 1) & ChunkMask;
+			if (capability.base() >= first && capability.top() <= end)
+			{
+				return &segment;
+			}
+		}
+		return nullptr;
+	}
+
+	/**
+	 * Copies the parts of lazy segments in the chunk holding `address` from
+	 * flash, clearing the parts past the end of their file data. Returns
+	 * false, leaving the chunk unloaded, if the data read does not match the
+	 * CRC-32 stored for it.
+	 */
+	bool load_chunk(uint32_t address)
+	{
+		uint32_t start = address & ChunkMask;
+		if (chunk_loaded(start))
+		{
+			return true;
+		}
+		for (uint32_t i = 0; i < table->count; i++)
+		{
+			const LazySegment &segment = table->segments[i];
+			uint32_t           low     = std::max(start, segment.vaddr);
+			uint32_t           high =
+			  std::min(start + LazyChunkSize, segment.vaddr + segment.memsz);
+			if (low >= high)
+			{
+				continue;
+			}
+			uint32_t file_end =
+			  std::max(low, std::min(high, segment.vaddr + segment.filesz));
+			uint8_t *data = hyperram.get() + (low - HYPERRAM_ADDRESS);
+			if (file_end > low)
+			{
+				// The boot image has a CRC-32 for the file data of each chunk
+				// the segment's file data overlaps.
+				uint32_t crc_index =
+				  (start - (segment.vaddr & ChunkMask)) / LazyChunkSize;
+				uint32_t expected;
+				flash.read(segment.crc_address + crc_index * sizeof(uint32_t),
+				           reinterpret_cast<uint8_t *>(&expected),
+				           sizeof(expected));
+				flash.read(segment.flash_address + (low - segment.vaddr),
+				           data,
+				           file_end - low);
+				if (crc32(data, file_end - low) != expected)
+				{
+					crc_errors++;
+					return false;
+				}
+			}
+			bl_memset(data + (file_end - low), 0, high - file_end);
+		}
+		uint32_t index = chunk_index(start);
+		table->loaded[index / 32] |= 1u << (index % 32);
+		return true;
+	}
+
+	/**
+	 * Decodes the load at `pc` whose base is in register `reg`, holding
+	 * `base`. Handles the I-type loads and the compressed c.lw and c.clc,
+	 * which are the only ones that can use a register other than csp as
+	 * their base.
+	 */
+	bool decode_load(uint32_t pc, uint32_t reg, uint32_t base, Load &load)
+	{
+		CHERI::Capability<const uint16_t> code = root.cast<const uint16_t>();
+		code.address()                         = pc;
+		uint32_t instruction                   = code[0];
+
+		if ((instruction & 0x3) == 0x3)
+		{
+			instruction |= uint32_t(code[1]) << 16;
+			uint32_t funct3 = (instruction >> 12) & 0x7;
+			if ((instruction & 0x7f) != 0x03 ||
+			    ((instruction >> 15) & 0x1f) != reg || funct3 > 5)
+			{
+				return false;
+			}
+			load.address     = base + (int32_t(instruction) >> 20);
+			load.size        = 1 << (funct3 & 0x3);
+			load.rd          = (instruction >> 7) & 0x1f;
+			load.sign_extend = funct3 < 2;
+			load.length      = 4;
+			return true;
+		}
+
+		uint32_t funct3 = instruction >> 13;
+		if ((instruction & 0x3) != 0 || (funct3 != 2 && funct3 != 3) ||
+		    8 + ((instruction >> 7) & 0x7) != reg)
+		{
+			return false;
+		}
+		uint32_t offset = ((instruction >> 10) & 0x7) << 3;
+		if (funct3 == 2)
+		{
+			offset |= ((instruction >> 6) & 0x1) << 2;
+			offset |= ((instruction >> 5) & 0x1) << 6;
+		}
+		else
+		{
+			offset |= ((instruction >> 5) & 0x3) << 6;
+		}
+		load.address     = base + offset;
+		load.size        = 1 << funct3;
+		load.rd          = 8 + ((instruction >> 2) & 0x7);
+		load.sign_extend = false;
+		load.length      = 2;
+		return true;
+	}
+
+	/**
+	 * Writes the result of `load`, which must be loaded, to its destination
+	 * register in `frame`. Capabilities come out untagged, as flash holds no
+	 * tags.
+	 */
+	void emulate_load(LazyTrapFrame *frame, const Load &load)
+	{
+		if (load.rd == 0)
+		{
+			return;
+		}
+
+		const uint8_t *data = hyperram.get() + (load.address - HYPERRAM_ADDRESS);
+		uint8_t *slot = reinterpret_cast<uint8_t *>(&frame->registers[load.rd]);
+		if (load.size == sizeof(void *))
+		{
+			for (uint32_t i = 0; i < sizeof(void *); i++)
+			{
+				slot[i] = data[i];
+			}
+			return;
+		}
+
+		uint32_t value = 0;
+		for (uint32_t i = 0; i < load.size; i++)
+		{
+			value |= uint32_t(data[i]) << (8 * i);
+		}
+		if (load.sign_extend)
+		{
+			uint32_t shift = 32 - 8 * load.size;
+			value          = uint32_t(int32_t(value << shift) >> shift);
+		}
+		// An integer register is the address of an untagged capability.
+		uint32_t *words = reinterpret_cast<uint32_t *>(slot);
+		words[0]        = value;
+		words[1]        = 0;
+	}
+
+	/**
+	 * Handles a load through a handle to a lazy segment, returning false if
+	 * the trap is anything else.
+	 */
+	bool handle_fault(LazyTrapFrame *frame)
+	{
+		uint32_t mcause, mtval;
+		asm volatile("csrr %0, mcause" : "=r"(mcause));
+		asm volatile("csrr %0, mtval" : "=r"(mtval));
+
+		uint32_t reg = (mtval >> 5) & 0x3f;
+		if (mcause != McauseCheriFault ||
+		    (mtval & 0x1f) != CheriPermitLoadViolation || reg == 0 ||
+		    reg == 2 || reg >= 16)
+		{
+			return false;
+		}
+
+		CHERI::Capability<void> handle{frame->registers[reg]};
+		const LazySegment      *segment = find_handle(handle);
+		if (segment == nullptr)
+		{
+			return false;
+		}
+
+		// The permission check comes before the bounds check, so the load
+		// may also be out of the handle's bounds.
+		CHERI::Capability<void> pcc{frame->pcc};
+		Load                    load;
+		if (!decode_load(pcc.address(), reg, handle.address(), load) ||
+		    load.rd == 2 || load.rd >= 16 || load.address < handle.base() ||
+		    load.address + load.size > handle.top() ||
+		    load.address < segment->vaddr ||
+		    load.address + load.size > segment->vaddr + segment->memsz ||
+		    !ensure(load.address, load.size))
+		{
+			return false;
+		}
+		faults++;
+
+		if (segment_loaded(*segment))
+		{
+			// Retry the load with a capability that no longer faults.
+			frame->registers[reg] = const_cast<void *>(
+			  make_capability(handle.base(),
+			                  handle.top() - handle.base(),
+			                  handle.address(),
+			                  LoadedPermissions)
+			    .get());
+			return true;
+		}
+
+		emulate_load(frame, load);
+		pcc.address() += load.length;
+		frame->pcc = pcc.get();
+		return true;
+	}
+
+	/**
+	 * Returns false if lazy_trap.S should pass the trap on to the previous
+	 * handler. With no previous handler, the trap cannot be handled, so this
+	 * never returns.
+	 */
+	static bool trap_handler(LazyTrapFrame *frame, LazyLoader *loader)
+	{
+		if (loader->handle_fault(frame))
+		{
+			return true;
+		}
+		if (!CHERI::Capability<void>{loader->previous_handler}.is_valid())
+		{
+			while (true)
+			{
+				asm("");
+			}
+		}
+		return false;
+	}
+
+	public:
+	// Loads handled by the trap handler, and chunks that failed their CRC.
+	uint32_t faults     = 0;
+	uint32_t crc_errors = 0;
+
+	LazyLoader(SpiFlash &flash_, CHERI::Capability<void> root_)
+	  : handler(trap_handler),
+	    previous_handler(nullptr),
+	    flash(flash_),
+	    root(root_),
+	    hyperram(root_.cast<uint8_t>()),
+	    table(root_.cast<LazySegmentTable>())
+	{
+		hyperram.address() = HYPERRAM_ADDRESS;
+		hyperram.bounds()  = HYPERRAM_BOUNDS - BootInfoBounds;
+		table.address()    = BootInfoAddress + offsetof(BootInfo, lazy);
+		table.bounds()     = sizeof(LazySegmentTable);
+	}
+
+	uint32_t segment_count()
+	{
+		return table->count;
+	}
+
+	/**
+	 * Returns a read-only capability to lazy segment `index`: a handle that
+	 * faults the segment in as it is used, or a plain capability once the
+	 * whole segment is loaded.
+	 */
+	CHERI::Capability<const void> capability(uint32_t index)
+	{
+		const LazySegment &segment = table->segments[index];
+		return make_capability(segment.vaddr,
+		                       segment.memsz,
+		                       segment.vaddr,
+		                       segment_loaded(segment) ? LoadedPermissions
+		                                               : HandlePermissions);
+	}
+
+	/**
+	 * Loads every chunk of lazy segments that overlaps `len` bytes at
+	 * `address`. Returns false if any of them does not match its CRC-32.
+	 */
+	bool ensure(uint32_t address, uint32_t len)
+	{
+		uint32_t start = std::max<uint32_t>(address, HYPERRAM_ADDRESS);
+		uint32_t end   = std::min<uint32_t>(address + len, BootInfoAddress);
+		for (uint32_t chunk = start & ChunkMask; chunk < end;
+		     chunk += LazyChunkSize)
+		{
+			if (!load_chunk(chunk))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Makes this loader handle faults on handles to lazy segments. The
+	 * loader and its flash device must stay alive while it is installed.
+	 */
+	void install()
+	{
+		previous_handler = lazy_trap_install(this);
+	}
+};
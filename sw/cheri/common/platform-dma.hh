@@ -0,0 +1,300 @@
+/**
+ * Copyright lowRISC contributors.
+ * Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+#include <algorithm>
+#include <cheri.hh>
+#include <platform-spi.hh>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * The Sonata DMA engine, which copies data between two addresses following a
+ * chain of descriptors, optionally paced by one of the SPI blocks. See
+ * doc/ip/dma.md.
+ *
+ * The engine does not check capabilities, so anything given an address for it
+ * must first have been checked against a capability for that memory. The
+ * drivers below only take capabilities.
+ */
+struct SonataDma
+{
+	uint32_t interruptState;
+	uint32_t interruptEnable;
+	uint32_t interruptTest;
+	uint32_t source;
+	uint32_t destination;
+	uint32_t byteCount;
+	uint32_t status;
+	uint32_t control;
+	uint32_t next;
+
+	static constexpr uint32_t InterruptDone = 1 << 0;
+
+	static constexpr uint32_t StatusReady      = 1 << 0;
+	static constexpr uint32_t StatusBusError   = 1 << 1;
+	static constexpr uint32_t StatusReadError  = 1 << 4;
+	static constexpr uint32_t StatusWriteError = 1 << 5;
+	static constexpr uint32_t StatusErrors =
+	  StatusBusError | StatusReadError | StatusWriteError;
+
+	static constexpr uint32_t ControlRequest      = 1 << 0;
+	static constexpr uint32_t ControlReadInc      = 1 << 1;
+	static constexpr uint32_t ControlWriteInc     = 1 << 2;
+	static constexpr uint32_t ControlDisableRead  = 1 << 3;
+	static constexpr uint32_t ControlDisableWrite = 1 << 4;
+	static constexpr uint32_t ControlStop         = 1 << 5;
+	static constexpr uint32_t ControlSpiShift     = 8;
+	static constexpr uint32_t ControlSpiTx        = 1 << 11;
+	static constexpr uint32_t ControlSpiRx        = 1 << 12;
+	static constexpr uint32_t ControlSpiWaitIdle  = 1 << 13;
+
+	/**
+	 * A descriptor as the engine reads it from memory. The last word is not
+	 * read by the engine; descriptors that write a register copy from it.
+	 */
+	struct Descriptor
+	{
+		uint32_t source;
+		uint32_t destination;
+		uint32_t byteCount;
+		uint32_t control;
+		uint32_t next;
+		uint32_t value;
+	};
+
+	/// Starts the chain beginning with `first`. The engine must be ready.
+	void start(const Descriptor &first) volatile
+	{
+		interruptState = InterruptDone;
+		source         = first.source;
+		destination    = first.destination;
+		byteCount      = first.byteCount;
+		next           = first.next;
+		control        = first.control | ControlRequest;
+	}
+
+	/// Asks a running transfer to stop after the access in progress.
+	void stop() volatile
+	{
+		control = ControlStop;
+	}
+
+	bool busy() volatile
+	{
+		return (status & StatusReady) == 0;
+	}
+
+	/// Waits for the transfer to finish and returns its error bits.
+	uint32_t wait() volatile
+	{
+		uint32_t s;
+		do
+		{
+			s = status;
+		} while ((s & StatusReady) == 0);
+		return s & StatusErrors;
+	}
+};
+
+/**
+ * Moves SPI transfers between memory and an SPI block's FIFOs with the DMA
+ * engine, using room for `MaxDescriptors` descriptors. Each SPI operation of
+ * up to `ChunkLen` bytes takes two.
+ *
+ * Buffers must be word aligned. The whole words of a transfer are moved by the
+ * engine and any remaining bytes by the CPU.
+ */
+template<size_t MaxDescriptors>
+class SpiDma
+{
+	// SPI registers written by descriptors, which follow the registers in
+	// `SonataSpi`, as word offsets.
+	static constexpr size_t   ControlRegister    = 0x10 / sizeof(uint32_t);
+	static constexpr size_t   StatusRegister     = 0x14 / sizeof(uint32_t);
+	static constexpr size_t   StartRegister      = 0x18 / sizeof(uint32_t);
+	static constexpr size_t   RxFifoWordRegister = 0x24 / sizeof(uint32_t);
+	static constexpr size_t   TxFifoWordRegister = 0x28 / sizeof(uint32_t);
+	static constexpr size_t   SpiRegistersLen    = 0x2c;
+	static constexpr uint32_t SpiTransmitEnable  = 1 << 2;
+	static constexpr uint32_t SpiReceiveEnable   = 1 << 3;
+	static constexpr uint32_t SpiStatusIdle      = 1 << 18;
+	// SPI blocks are 4 KiB apart, numbered in address order.
+	static constexpr uint32_t SpiBlockShift      = 12;
+	static constexpr uint32_t SpiBlockMask       = 0x7;
+
+	CHERI::Capability<volatile SonataDma> dma;
+	CHERI::Capability<volatile SonataSpi> spi;
+
+	SonataDma::Descriptor descriptors[MaxDescriptors];
+
+	volatile uint32_t *spi_registers()
+	{
+		return reinterpret_cast<volatile uint32_t *>(spi.get());
+	}
+
+	static uint32_t address_of(const void *pointer)
+	{
+		return CHERI::Capability<const void>{pointer}.address();
+	}
+
+	uint32_t spi_address(size_t reg)
+	{
+		return spi.address() + reg * sizeof(uint32_t);
+	}
+
+	void wait_spi_idle()
+	{
+		while ((spi_registers()[StatusRegister] & SpiStatusIdle) == 0) {}
+	}
+
+	/**
+	 * Returns true if `data` may be used for `len` bytes of a transfer that
+	 * needs `permission`, so that the engine cannot reach memory the caller
+	 * could not.
+	 */
+	template<typename T>
+	static bool allowed(CHERI::Capability<T> data,
+	                    size_t               len,
+	                    CHERI::Permission    permission)
+	{
+		return data.is_valid() && data.permissions().contains(permission) &&
+		       data.address() >= data.base() &&
+		       data.address() + len <= data.base() + data.length() &&
+		       (data.address() & 3) == 0;
+	}
+
+	/**
+	 * Builds and runs the chain moving `words` bytes, a multiple of four,
+	 * to or from `memory`, then waits for it. Returns the engine's error bits.
+	 */
+	uint32_t run(uint32_t memory, size_t words, bool transmit)
+	{
+		// A partial last word would get a write error from the transmit
+		// FIFO, which only permits full word writes, or wait forever for
+		// the receive FIFO to hold four bytes.
+		if ((words & 3) != 0)
+		{
+			return SonataDma::StatusWriteError;
+		}
+
+		uint32_t pacing = ((spi.address() >> SpiBlockShift) & SpiBlockMask)
+		                  << SonataDma::ControlSpiShift;
+
+		size_t n = 0;
+		for (size_t done = 0; done < words; done += ChunkLen)
+		{
+			uint32_t chunk = std::min(words - done, ChunkLen);
+
+			// Start an SPI operation for the chunk once the last one has
+			// finished.
+			SonataDma::Descriptor &start = descriptors[n++];
+			start.value                  = chunk;
+			start.source                 = address_of(&start.value);
+			start.destination            = spi_address(StartRegister);
+			start.byteCount              = sizeof(uint32_t);
+			start.control = pacing | SonataDma::ControlSpiWaitIdle;
+
+			SonataDma::Descriptor &data = descriptors[n++];
+			if (transmit)
+			{
+				data.source      = memory + done;
+				data.destination = spi_address(TxFifoWordRegister);
+				data.control     = pacing | SonataDma::ControlSpiTx |
+				               SonataDma::ControlReadInc;
+			}
+			else
+			{
+				data.source      = spi_address(RxFifoWordRegister);
+				data.destination = memory + done;
+				data.control     = pacing | SonataDma::ControlSpiRx |
+				               SonataDma::ControlWriteInc;
+			}
+			data.byteCount = chunk;
+		}
+		for (size_t i = 0; i < n; i++)
+		{
+			descriptors[i].next =
+			  i + 1 < n ? address_of(&descriptors[i + 1]) : 0;
+		}
+
+		wait_spi_idle();
+		spi_registers()[ControlRegister] =
+		  transmit ? SpiTransmitEnable : SpiReceiveEnable;
+		dma->start(descriptors[0]);
+		uint32_t errors = dma->wait();
+		wait_spi_idle();
+		return errors;
+	}
+
+	public:
+	/// Whole words moved by a single SPI operation.
+	static constexpr size_t ChunkLen = 0x7ff & ~3u;
+
+	/// Largest transfer the descriptor storage covers.
+	static constexpr size_t MaxLen = MaxDescriptors / 2 * ChunkLen;
+
+	/**
+	 * `spi` must cover the SPI block's registers with store permission, as
+	 * the engine writes them on the caller's behalf.
+	 */
+	SpiDma(CHERI::Capability<volatile SonataDma> dma,
+	       CHERI::Capability<volatile SonataSpi> spi)
+	  : dma(dma), spi(spi)
+	{
+	}
+
+	/**
+	 * Sends `len` bytes from `data`. Returns false without sending anything
+	 * if `data` does not allow the engine to load them, or the transfer is
+	 * too long, otherwise waits for it and returns true if the engine
+	 * reported no errors.
+	 */
+	bool write(CHERI::Capability<const uint8_t> data, size_t len)
+	{
+		if (len > MaxLen || !allowed(data, len, CHERI::Permission::Load) ||
+		    !allowed(spi, SpiRegistersLen, CHERI::Permission::Store))
+		{
+			return false;
+		}
+
+		size_t words = len & ~size_t(3);
+		if (words > 0 && run(data.address(), words, true) != 0)
+		{
+			return false;
+		}
+		if (words < len)
+		{
+			spi->blocking_write(data.get() + words, len - words);
+		}
+		return true;
+	}
+
+	/**
+	 * Receives `len` bytes into `data`, as for `write` but needing store
+	 * permission. The engine does not write capability tags, so any
+	 * capabilities in the buffer are cleared.
+	 */
+	bool read(CHERI::Capability<uint8_t> data, size_t len)
+	{
+		if (len > MaxLen || !allowed(data, len, CHERI::Permission::Store) ||
+		    !allowed(spi, SpiRegistersLen, CHERI::Permission::Store))
+		{
+			return false;
+		}
+
+		size_t words = len & ~size_t(3);
+		if (words > 0 && run(data.address(), words, false) != 0)
+		{
+			return false;
+		}
+		if (words < len)
+		{
+			spi->blocking_read(data.get() + words, len - words);
+		}
+		return true;
+	}
+};
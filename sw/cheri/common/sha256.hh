@@ -0,0 +1,140 @@
+/**
+ * Copyright lowRISC contributors.
+ * Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Incremental SHA-256 (FIPS 180-4), written for size rather than speed so it
+ * can be built into the boot loader.
+ */
+class Sha256
+{
+	private:
+	static constexpr uint32_t K[64] = {
+	  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+	  0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+	  0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+	  0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+	  0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+	  0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+	};
+
+	uint32_t state[8] = {
+	  0x6a09e667,
+	  0xbb67ae85,
+	  0x3c6ef372,
+	  0xa54ff53a,
+	  0x510e527f,
+	  0x9b05688c,
+	  0x1f83d9ab,
+	  0x5be0cd19,
+	};
+	uint8_t  block[64];
+	uint32_t block_len = 0;
+	uint32_t total_len = 0;
+
+	static uint32_t rotr(uint32_t x, uint32_t n)
+	{
+		return (x >> n) | (x << (32 - n));
+	}
+
+	void compress()
+	{
+		uint32_t w[16];
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			w[i] = (uint32_t(block[i * 4]) << 24) |
+			       (uint32_t(block[i * 4 + 1]) << 16) |
+			       (uint32_t(block[i * 4 + 2]) << 8) | block[i * 4 + 3];
+		}
+
+		uint32_t v[8];
+		for (uint32_t i = 0; i < 8; i++)
+		{
+			v[i] = state[i];
+		}
+
+		for (uint32_t i = 0; i < 64; i++)
+		{
+			// The message schedule is kept as a rolling window of 16 words.
+			if (i >= 16)
+			{
+				uint32_t w15 = w[(i + 1) & 15];
+				uint32_t w2  = w[(i + 14) & 15];
+				uint32_t s0  = rotr(w15, 7) ^ rotr(w15, 18) ^ (w15 >> 3);
+				uint32_t s1  = rotr(w2, 17) ^ rotr(w2, 19) ^ (w2 >> 10);
+				w[i & 15] += s0 + w[(i + 9) & 15] + s1;
+			}
+
+			uint32_t s1 = rotr(v[4], 6) ^ rotr(v[4], 11) ^ rotr(v[4], 25);
+			uint32_t ch = (v[4] & v[5]) ^ (~v[4] & v[6]);
+			uint32_t t1 = v[7] + s1 + ch + K[i] + w[i & 15];
+			uint32_t s0 = rotr(v[0], 2) ^ rotr(v[0], 13) ^ rotr(v[0], 22);
+			uint32_t maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+			for (uint32_t j = 7; j > 0; j--)
+			{
+				v[j] = v[j - 1];
+			}
+			v[4] += t1;
+			v[0] = t1 + s0 + maj;
+		}
+
+		for (uint32_t i = 0; i < 8; i++)
+		{
+			state[i] += v[i];
+		}
+	}
+
+	public:
+	void update(const uint8_t *data, size_t len)
+	{
+		total_len += len;
+		for (size_t i = 0; i < len; i++)
+		{
+			block[block_len++] = data[i];
+			if (block_len == sizeof(block))
+			{
+				compress();
+				block_len = 0;
+			}
+		}
+	}
+
+	/**
+	 * Pads the message and writes the 32-byte digest to `out`. The object
+	 * must not be updated afterwards.
+	 */
+	void finish(uint8_t out[32])
+	{
+		uint32_t bit_len = total_len << 3;
+		uint8_t  pad     = 0x80;
+		update(&pad, 1);
+		pad = 0;
+		while (block_len != 56)
+		{
+			update(&pad, 1);
+		}
+		// Messages are limited to 512 MiB, so the top length word is zero.
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			block[56 + i] = 0;
+			block[60 + i] = bit_len >> (24 - i * 8);
+		}
+		compress();
+
+		for (uint32_t i = 0; i < 32; i++)
+		{
+			out[i] = state[i / 4] >> (24 - (i % 4) * 8);
+		}
+	}
+};
@@ -19,8 +19,10 @@ static inline void reset_mcycle(void)
 	asm volatile("csrw mcycle, x0");
 }
 
+// Waits for `value` cycles. mcycle is left running so that callers can still
+// use it to time longer operations.
 static inline void wait_mcycle(uint32_t value)
 {
-	reset_mcycle();
-	while (get_mcycle() < value) {}
+	uint32_t start = get_mcycle();
+	while (get_mcycle() - start < value) {}
 }
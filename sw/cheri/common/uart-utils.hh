@@ -52,3 +52,17 @@ static void to_hex(char str_buf[Digits + 1], uint32_t num)
 	to_hex<2>(str_buf, num);
 	write_str(uart, str_buf);
 }
+
+[[maybe_unused]] static void write_dec(volatile OpenTitanUart *uart,
+                                       uint32_t                  num)
+{
+	char  str_buf[11];
+	char *ptr = &str_buf[10];
+	*ptr      = 0;
+	do
+	{
+		*--ptr = (num % 10) + '0';
+		num /= 10;
+	} while (num != 0);
+	write_str(uart, ptr);
+}
@@ -18,12 +18,15 @@
 #define GPIO_ADDRESS (0x8000'0000)
 #define GPIO_BOUNDS  (0x0000'0020)
 
+#define DMA_ADDRESS (0x8000'2000)
+#define DMA_BOUNDS  (0x0000'0024)
+
 #define UART_BOUNDS   (0x0000'0034)
 #define UART_ADDRESS  (0x8010'0000)
 #define UART1_ADDRESS (0x8010'1000)
 
 #define SPI_ADDRESS  (0x8030'0000)
-#define SPI_BOUNDS   (0x0000'0024)
+#define SPI_BOUNDS   (0x0000'0034)
 
 #define USBDEV_ADDRESS (0x8040'0000)
 #define USBDEV_BOUNDS  (0x0000'1000)
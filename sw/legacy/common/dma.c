@@ -0,0 +1,114 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "dma.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dev_access.h"
+#include "sonata_system.h"
+
+#define SPI_BLOCK_SIZE 0x1000
+
+static uint32_t dma_addr(const volatile void *ptr) { return (uint32_t)(uintptr_t)ptr; }
+
+static uint32_t spi_block(spi_t *spi) { return ((uintptr_t)spi->reg - SPI0_BASE) / SPI_BLOCK_SIZE; }
+
+static uint32_t min_u32(uint32_t a, uint32_t b) { return a < b ? a : b; }
+
+bool dma_desc_set(dma_desc_t *desc, const volatile void *src, volatile void *dst, uint32_t count, uint32_t control) {
+  // A partial last word would get a write error from the transmit FIFO, which
+  // only permits full word writes, or wait forever for the receive FIFO to
+  // hold four bytes.
+  if ((control & (DMA_CONTROL_SPI_TX | DMA_CONTROL_SPI_RX)) && (count & 3) != 0) {
+    return false;
+  }
+  desc->src     = dma_addr(src);
+  desc->dst     = dma_addr(dst);
+  desc->count   = count;
+  desc->control = control;
+  desc->next    = 0;
+  return true;
+}
+
+void dma_desc_link(dma_desc_t *desc, const dma_desc_t *next) { desc->next = dma_addr(next); }
+
+void dma_start(dma_t dma, const dma_desc_t *first) {
+  DEV_WRITE(dma + DMA_INTR_STATE, DMA_INTR_DONE);
+  DEV_WRITE(dma + DMA_SRC, first->src);
+  DEV_WRITE(dma + DMA_DST, first->dst);
+  DEV_WRITE(dma + DMA_COUNT, first->count);
+  DEV_WRITE(dma + DMA_NEXT, first->next);
+  DEV_WRITE(dma + DMA_CONTROL, first->control | DMA_CONTROL_REQUEST);
+}
+
+void dma_stop(dma_t dma) { DEV_WRITE(dma + DMA_CONTROL, DMA_CONTROL_STOP); }
+
+bool dma_busy(dma_t dma) { return (DEV_READ(dma + DMA_STATUS) & DMA_STATUS_READY) == 0; }
+
+uint32_t dma_wait(dma_t dma) {
+  uint32_t status;
+  do {
+    status = DEV_READ(dma + DMA_STATUS);
+  } while ((status & DMA_STATUS_READY) == 0);
+  return status & DMA_STATUS_ERRORS;
+}
+
+uint32_t dma_spi_chain(dma_desc_t *descs, spi_t *spi, const uint8_t *tx_data, uint8_t *rx_data, uint32_t len) {
+  uint32_t spi_ctrl = DMA_CONTROL_SPI(spi_block(spi));
+  uint32_t words    = len & ~3u;
+
+  dma_desc_t *desc = descs;
+  for (uint32_t done = 0; done < words; done += DMA_SPI_CHUNK) {
+    uint32_t chunk = min_u32(words - done, DMA_SPI_CHUNK);
+
+    // Start an SPI operation for the chunk once the last one has finished.
+    desc->value = chunk;
+    dma_desc_set(desc, &desc->value, spi->reg + SPI_START, 4, spi_ctrl | DMA_CONTROL_SPI_WAIT_IDLE);
+    dma_desc_link(desc, desc + 1);
+    ++desc;
+
+    if (tx_data) {
+      dma_desc_set(desc, tx_data + done, spi->reg + SPI_TX_FIFO_WORD, chunk,
+                   spi_ctrl | DMA_CONTROL_SPI_TX | DMA_CONTROL_READ_INC);
+    } else {
+      dma_desc_set(desc, spi->reg + SPI_RX_FIFO_WORD, rx_data + done, chunk,
+                   spi_ctrl | DMA_CONTROL_SPI_RX | DMA_CONTROL_WRITE_INC);
+    }
+    if (done + chunk < words) {
+      dma_desc_link(desc, desc + 1);
+    }
+    ++desc;
+  }
+
+  return words;
+}
+
+static uint32_t dma_spi_transfer(dma_t dma, spi_t *spi, dma_desc_t *descs, const uint8_t *tx_data, uint8_t *rx_data,
+                                 uint32_t len) {
+  uint32_t words = dma_spi_chain(descs, spi, tx_data, rx_data, len);
+
+  uint32_t errors = 0;
+  if (words > 0) {
+    spi_wait_idle(spi);
+    DEV_WRITE(spi->reg + SPI_CONTROL, tx_data ? SPI_CONTROL_TX_ENABLE : SPI_CONTROL_RX_ENABLE);
+    dma_start(dma, descs);
+    errors = dma_wait(dma);
+  }
+
+  if (errors == 0 && words < len) {
+    spi_transfer(spi, tx_data ? tx_data + words : NULL, rx_data ? rx_data + words : NULL, len - words);
+  }
+  spi_wait_idle(spi);
+  return errors;
+}
+
+uint32_t dma_spi_tx(dma_t dma, spi_t *spi, dma_desc_t *descs, const uint8_t *data, uint32_t len) {
+  return dma_spi_transfer(dma, spi, descs, data, NULL, len);
+}
+
+uint32_t dma_spi_rx(dma_t dma, spi_t *spi, dma_desc_t *descs, uint8_t *data, uint32_t len) {
+  return dma_spi_transfer(dma, spi, descs, NULL, data, len);
+}
@@ -0,0 +1,105 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DMA_H__
+#define DMA_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "spi.h"
+
+#define DMA_INTR_STATE 0x0
+#define DMA_INTR_ENABLE 0x4
+#define DMA_INTR_TEST 0x8
+#define DMA_SRC 0xc
+#define DMA_DST 0x10
+#define DMA_COUNT 0x14
+#define DMA_STATUS 0x18
+#define DMA_CONTROL 0x1c
+#define DMA_NEXT 0x20
+
+#define DMA_INTR_DONE 0x1
+
+#define DMA_STATUS_READY 0x1
+#define DMA_STATUS_BUS_ERROR 0x2
+#define DMA_STATUS_READ_ERROR 0x10
+#define DMA_STATUS_WRITE_ERROR 0x20
+#define DMA_STATUS_ERRORS (DMA_STATUS_BUS_ERROR | DMA_STATUS_READ_ERROR | DMA_STATUS_WRITE_ERROR)
+
+#define DMA_CONTROL_REQUEST 0x1
+#define DMA_CONTROL_READ_INC 0x2
+#define DMA_CONTROL_WRITE_INC 0x4
+#define DMA_CONTROL_DISABLE_READ 0x8
+#define DMA_CONTROL_DISABLE_WRITE 0x10
+#define DMA_CONTROL_STOP 0x20
+#define DMA_CONTROL_SPI(block) ((block) << 8)
+#define DMA_CONTROL_SPI_TX (1u << 11)
+#define DMA_CONTROL_SPI_RX (1u << 12)
+#define DMA_CONTROL_SPI_WAIT_IDLE (1u << 13)
+
+#define DMA_MAX_BYTE_COUNT 0xfffff
+
+#define DMA_IRQ 108
+
+// Largest SPI operation started by a descriptor chain. The FIFOs are accessed
+// a word at a time, so this is the largest multiple of four the SPI block
+// accepts.
+#define DMA_SPI_CHUNK (SPI_MAX_BYTE_COUNT & ~3u)
+
+// Number of descriptors `dma_spi_chain` needs for `len` bytes.
+#define DMA_SPI_DESCS(len) (2 * (((len) + DMA_SPI_CHUNK - 1) / DMA_SPI_CHUNK))
+
+#define DMA_FROM_BASE_ADDR(addr) ((dma_t)(addr))
+
+typedef void *dma_t;
+
+// A descriptor as the engine reads it from memory. Descriptors must be word
+// aligned and stay valid until the transfer has completed.
+typedef struct dma_desc {
+  uint32_t src;
+  uint32_t dst;
+  uint32_t count;
+  uint32_t control;
+  // Address of the next descriptor, or 0 for the last.
+  uint32_t next;
+  // Not read by the engine. Descriptors that write a register copy from here.
+  uint32_t value;
+} dma_desc_t;
+
+// Fills in `desc` to copy `count` bytes from `src` to `dst`, ending the chain.
+// `control` is a combination of the DMA_CONTROL_* flags other than REQUEST and
+// STOP. Returns false, leaving `desc` alone, for an SPI transmit or receive
+// descriptor whose count is not a multiple of four.
+bool dma_desc_set(dma_desc_t *desc, const volatile void *src, volatile void *dst, uint32_t count, uint32_t control);
+
+// Links `desc` to `next`.
+void dma_desc_link(dma_desc_t *desc, const dma_desc_t *next);
+
+// Starts the chain beginning with `first` and returns without waiting for it.
+// The engine must be ready.
+void dma_start(dma_t dma, const dma_desc_t *first);
+
+// Asks a running transfer to stop after the access in progress.
+void dma_stop(dma_t dma);
+
+bool dma_busy(dma_t dma);
+
+// Waits for the transfer to finish and returns its DMA_STATUS_* error bits.
+uint32_t dma_wait(dma_t dma);
+
+// Builds a chain in `descs`, which must have room for DMA_SPI_DESCS(len)
+// entries, that sends `tx_data` or receives into `rx_data` through the FIFO of
+// `spi`. Exactly one of the buffers is given and it must be word aligned. The
+// chain starts one SPI operation per DMA_SPI_CHUNK bytes, and only covers the
+// whole words of `len`. Returns the number of bytes covered.
+uint32_t dma_spi_chain(dma_desc_t *descs, spi_t *spi, const uint8_t *tx_data, uint8_t *rx_data, uint32_t len);
+
+// Equivalents of `spi_tx` and `spi_rx` that move the whole words of the
+// transfer with the DMA engine, using `descs` as for `dma_spi_chain`, and the
+// remaining bytes with the CPU. Return the DMA_STATUS_* error bits.
+uint32_t dma_spi_tx(dma_t dma, spi_t *spi, dma_desc_t *descs, const uint8_t *data, uint32_t len);
+uint32_t dma_spi_rx(dma_t dma, spi_t *spi, dma_desc_t *descs, uint8_t *data, uint32_t len);
+
+#endif  // DMA_H__
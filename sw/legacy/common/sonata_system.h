@@ -37,6 +37,13 @@
 #define ARDUINO_SPI SPI_FROM_BASE_ADDR(SPI5_BASE)
 #define MIKRO_BUS_SPI SPI_FROM_BASE_ADDR(SPI6_BASE)
 #define DEFAULT_USBDEV USBDEV0_BASE
+#define DEFAULT_DMA DMA_FROM_BASE_ADDR(DMA_BASE)
+
+// Fastest SPI clock each device on the board is rated for. spi_init limits
+// these to what the SPI blocks can produce from the system clock.
+#define FLASH_SPI_SPEED_HZ (50 * 1000 * 1000)  // W25Q256JV, for the Read Data instruction
+#define LCD_SPI_SPEED_HZ (15 * 1000 * 1000)    // ST7735, 66 ns serial write cycle
+#define ETH_SPI_SPEED_HZ (40 * 1000 * 1000)    // KSZ8851SNL
 
 /**
  * Writes character to default UART. Signature matches c stdlib function
@@ -7,45 +7,134 @@
 #include <stdint.h>
 
 #include "dev_access.h"
+#include "sonata_system.h"
+
+// The SPI clock is the system clock divided by 2 * (HALF_CLK_PERIOD + 1).
+static uint32_t spi_half_clk_period(uint32_t speed) {
+  if (speed == 0) {
+    return 0;
+  }
+  uint32_t half = (SYSCLK_FREQ + 2 * speed - 1) / (2 * speed);
+  half          = half == 0 ? 0 : half - 1;
+  return half > SPI_CFG_HALF_CLK_PERIOD_MAX ? SPI_CFG_HALF_CLK_PERIOD_MAX : half;
+}
+
+static void spi_set_half_clk_period(spi_t *spi, uint32_t half) {
+  spi_wait_idle(spi);
+  DEV_WRITE(spi->reg + SPI_CFG, SPI_CFG_MSB_FIRST | half);
+  spi->speed = SYSCLK_FREQ / (2 * (half + 1));
+}
 
 void spi_init(spi_t *spi, spi_reg_t spi_reg, uint32_t speed) {
-  spi->reg   = spi_reg;
-  spi->speed = speed;
+  spi->reg = spi_reg;
+
+  uint32_t info      = DEV_READ(spi_reg + SPI_INFO);
+  spi->tx_fifo_depth = SPI_INFO_TX_FIFO_DEPTH(info);
+  spi->rx_fifo_depth = SPI_INFO_RX_FIFO_DEPTH(info);
+
+  spi_set_speed(spi, speed);
 }
 
-void spi_wait_idle(spi_t *spi) {
-  while((DEV_READ(spi->reg + SPI_STATUS) & 0x40000) == 0);
+void spi_set_speed(spi_t *spi, uint32_t speed) { spi_set_half_clk_period(spi, spi_half_clk_period(speed)); }
+
+uint32_t spi_sweep_speed(spi_t *spi, uint32_t max_speed, uint32_t min_speed, spi_check_t check, void *arg) {
+  uint32_t slowest = spi_half_clk_period(min_speed);
+  for (uint32_t half = spi_half_clk_period(max_speed); half <= slowest; ++half) {
+    spi_set_half_clk_period(spi, half);
+
+    bool passed = true;
+    for (int i = 0; passed && i < SPI_SWEEP_CHECKS; ++i) {
+      passed = check(spi, arg);
+    }
+    if (passed) {
+      return spi->speed;
+    }
+  }
+  return 0;
 }
 
-void spi_tx(spi_t *spi, const uint8_t* data, uint32_t len) {
+void spi_set_cs(spi_t *spi, uint32_t select, bool hold) {
   spi_wait_idle(spi);
+  DEV_WRITE(spi->reg + SPI_CS, select | (hold ? SPI_CS_HOLD : 0));
+}
 
-  // TX_ENABLE
-  DEV_WRITE(spi->reg + SPI_CONTROL, 0x4);
-  DEV_WRITE(spi->reg + SPI_START, len);
+void spi_wait_idle(spi_t *spi) {
+  while((DEV_READ(spi->reg + SPI_STATUS) & SPI_STATUS_IDLE) == 0);
+}
 
-  uint32_t tx_avail = 0;
-  for (int i = 0;i < len; ++i) {
-    if (tx_avail == 0) {
-      while (tx_avail < 120) {
-        tx_avail = 128 - (DEV_READ(spi->reg + SPI_STATUS) & 0xff);
-      }
-    }
+static uint32_t min_u32(uint32_t a, uint32_t b) {
+  return a < b ? a : b;
+}
 
-    DEV_WRITE(spi->reg + SPI_TX_FIFO, data[i]);
-    tx_avail--;
+// Uses word accesses for all but the last few bytes.
+const uint8_t *spi_fifo_push(spi_t *spi, const uint8_t *data, uint32_t len) {
+  for (; len >= 4; len -= 4, data += 4) {
+    DEV_WRITE(spi->reg + SPI_TX_FIFO_WORD,
+              data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24));
+  }
+  for (; len > 0; --len) {
+    DEV_WRITE(spi->reg + SPI_TX_FIFO, *data++);
   }
+  return data;
 }
 
-void spi_rx(spi_t *spi, uint8_t* data, uint32_t len) {
+// Uses word accesses for all but the last few bytes.
+uint8_t *spi_fifo_pop(spi_t *spi, uint8_t *data, uint32_t len) {
+  for (; len >= 4; len -= 4, data += 4) {
+    uint32_t word = DEV_READ(spi->reg + SPI_RX_FIFO_WORD);
+    data[0]       = word;
+    data[1]       = word >> 8;
+    data[2]       = word >> 16;
+    data[3]       = word >> 24;
+  }
+  for (; len > 0; --len) {
+    *data++ = (uint8_t)DEV_READ(spi->reg + SPI_RX_FIFO);
+  }
+  return data;
+}
+
+// Transfers at most SPI_MAX_BYTE_COUNT bytes with a single start.
+static void spi_transfer_chunk(spi_t *spi, const uint8_t *tx_data, uint8_t *rx_data, uint32_t len) {
   spi_wait_idle(spi);
 
-  // RX_ENABLE
-  DEV_WRITE(spi->reg + SPI_CONTROL, 0x8);
+  DEV_WRITE(spi->reg + SPI_CONTROL,
+            (tx_data ? SPI_CONTROL_TX_ENABLE : 0) | (rx_data ? SPI_CONTROL_RX_ENABLE : 0));
   DEV_WRITE(spi->reg + SPI_START, len);
 
-  for (int i = 0;i < len; ++i) {
-    while (((DEV_READ(spi->reg + SPI_STATUS) >> 8) & 0xff) == 0);
-    data[i] = (uint8_t)DEV_READ(spi->reg + SPI_RX_FIFO);;
+  uint32_t to_send    = tx_data ? len : 0;
+  uint32_t to_receive = rx_data ? len : 0;
+  while (to_send > 0 || to_receive > 0) {
+    // The block only ever drains the transmit FIFO and fills the receive FIFO
+    // behind our back, so one status read bounds a whole batch of accesses.
+    uint32_t status = DEV_READ(spi->reg + SPI_STATUS);
+
+    uint32_t batch = min_u32(to_send, spi->tx_fifo_depth - SPI_STATUS_TX_LEVEL(status));
+    tx_data        = spi_fifo_push(spi, tx_data, batch);
+    to_send -= batch;
+
+    batch   = min_u32(to_receive, SPI_STATUS_RX_LEVEL(status));
+    rx_data = spi_fifo_pop(spi, rx_data, batch);
+    to_receive -= batch;
   }
 }
+
+// The byte count of a start is only SPI_MAX_BYTE_COUNT wide, so longer
+// transfers are split into several starts. The chip select is left alone
+// between them.
+void spi_transfer(spi_t *spi, const uint8_t *tx_data, uint8_t *rx_data, uint32_t len) {
+  while (len > 0) {
+    uint32_t chunk = min_u32(len, SPI_MAX_BYTE_COUNT);
+    spi_transfer_chunk(spi, tx_data, rx_data, chunk);
+    tx_data = tx_data ? tx_data + chunk : NULL;
+    rx_data = rx_data ? rx_data + chunk : NULL;
+    len -= chunk;
+  }
+}
+
+void spi_tx(spi_t *spi, const uint8_t* data, uint32_t len) {
+  spi_transfer(spi, data, NULL, len);
+}
+
+void spi_rx(spi_t *spi, uint8_t* data, uint32_t len) {
+  spi_transfer(spi, NULL, data, len);
+}
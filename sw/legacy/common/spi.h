@@ -5,27 +5,119 @@
 #ifndef SPI_H__
 #define SPI_H__
 
+#include "stdbool.h"
+#include "stddef.h"
 #include "stdint.h"
 
+#define SPI_INTR_STATE 0x0
+#define SPI_INTR_ENABLE 0x4
+#define SPI_INTR_TEST 0x8
 #define SPI_CFG 0xc
 #define SPI_CONTROL 0x10
 #define SPI_STATUS 0x14
 #define SPI_START 0x18
 #define SPI_RX_FIFO 0x1c
 #define SPI_TX_FIFO 0x20
+#define SPI_RX_FIFO_WORD 0x24
+#define SPI_TX_FIFO_WORD 0x28
+#define SPI_CS 0x2c
+#define SPI_INFO 0x30
+
+#define SPI_CFG_CPOL (1u << 31)
+#define SPI_CFG_CPHA (1u << 30)
+#define SPI_CFG_MSB_FIRST (1u << 29)
+#define SPI_CFG_HALF_CLK_PERIOD_MAX 0xffff
+
+#define SPI_CONTROL_TX_ENABLE 0x4
+#define SPI_CONTROL_RX_ENABLE 0x8
+#define SPI_CONTROL_TX_WATERMARK(encoding) ((encoding) << 4)
+#define SPI_CONTROL_RX_WATERMARK(encoding) ((encoding) << 8)
+
+// Watermark encodings relative to the FIFO depth, for use with the macros
+// above.
+#define SPI_TX_WATERMARK_HALF 6
+#define SPI_RX_WATERMARK_HALF 7
+
+#define SPI_INTR_RX_FULL 0x1
+#define SPI_INTR_RX_WATERMARK 0x2
+#define SPI_INTR_TX_EMPTY 0x4
+#define SPI_INTR_TX_WATERMARK 0x8
+#define SPI_INTR_COMPLETE 0x10
+
+// Largest byte count a single write to SPI_START can ask for.
+#define SPI_MAX_BYTE_COUNT 0x7ff
+
+#define SPI_STATUS_TX_LEVEL(status) ((status) & 0xff)
+#define SPI_STATUS_RX_LEVEL(status) (((status) >> 8) & 0xff)
+#define SPI_STATUS_IDLE 0x40000
+
+#define SPI_CS_HOLD (1u << 31)
+
+#define SPI_INFO_TX_FIFO_DEPTH(info) ((info) & 0xff)
+#define SPI_INFO_RX_FIFO_DEPTH(info) (((info) >> 8) & 0xff)
+
+// Number of times spi_sweep_speed runs the check at each rate.
+#define SPI_SWEEP_CHECKS 16
+
+// Each SPI block has five interrupts at the PLIC, in the order of the
+// SPI_INTR_* bits, starting with those of the block at SPI0_BASE.
+#define SPI_IRQ_BASE 73
+#define SPI_IRQS_PER_BLOCK 5
+#define SPI_IRQ(block, intr_bit) (SPI_IRQ_BASE + (block) * SPI_IRQS_PER_BLOCK + __builtin_ctz(intr_bit))
 
 #define SPI_FROM_BASE_ADDR(addr) ((spi_reg_t)(addr))
 
 typedef void *spi_reg_t;
 typedef struct spi {
   spi_reg_t reg;
+  // SPI clock rate in Hz.
   uint32_t speed;
+  // Size in bytes of the transmit and receive FIFOs, which differ between
+  // blocks. Read from the block by spi_init.
+  uint32_t tx_fifo_depth;
+  uint32_t rx_fifo_depth;
 } spi_t;
 
+// Returns true if the device on `spi` responds correctly at the current speed.
+typedef bool (*spi_check_t)(spi_t *spi, void *arg);
+
+// Sets up `spi` for SPI mode 0, MSB first, at the fastest clock rate no
+// higher than `speed`, or the fastest the block supports if `speed` is 0.
 void spi_init(spi_t *spi, spi_reg_t reg, uint32_t speed);
 
+// Sets the fastest clock rate no higher than `speed`, waiting for the block to
+// go idle first. The rate chosen is stored in `spi->speed`.
+void spi_set_speed(spi_t *spi, uint32_t speed);
+
+// Tries clock rates from `max_speed` down to `min_speed`, keeping the fastest
+// at which `check` passes SPI_SWEEP_CHECKS times in a row. Returns that rate,
+// or 0 if none passed, in which case the block is left at `min_speed`.
+uint32_t spi_sweep_speed(spi_t *spi, uint32_t max_speed, uint32_t min_speed, spi_check_t check, void *arg);
+
+// Has the block assert the chip select lines in `select`, one bit per line,
+// for each operation. While `hold` is set they stay asserted between
+// operations too, so several make up one transaction. Waits for the running
+// operation to finish first, so that it ends the transaction it was part of.
+// A `select` of 0 leaves chip select to GPIO, whose output must be high for
+// the block's chip select to work.
+void spi_set_cs(spi_t *spi, uint32_t select, bool hold);
+
 void spi_wait_idle(spi_t *spi);
 void spi_tx(spi_t *spi, const uint8_t* data, uint32_t len);
 void spi_rx(spi_t *spi, uint8_t* data, uint32_t len);
 
+// Sends `len` bytes from `tx_data` while receiving `len` bytes into `rx_data`.
+// Either may be NULL to only receive or only send. Returns once all bytes have
+// been pushed to the transmit FIFO and popped from the receive FIFO. `len` may
+// exceed SPI_MAX_BYTE_COUNT.
+void spi_transfer(spi_t *spi, const uint8_t *tx_data, uint8_t *rx_data, uint32_t len);
+
+// Pushes `len` bytes to the transmit FIFO, which must have space for them, and
+// returns a pointer past the last byte pushed.
+const uint8_t *spi_fifo_push(spi_t *spi, const uint8_t *data, uint32_t len);
+
+// Pops `len` bytes from the receive FIFO, which must hold at least that many,
+// and returns a pointer past the last byte popped.
+uint8_t *spi_fifo_pop(spi_t *spi, uint8_t *data, uint32_t len);
+
 #endif  // SPI_H__
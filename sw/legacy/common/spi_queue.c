@@ -0,0 +1,209 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "spi_queue.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dev_access.h"
+#include "rv_plic.h"
+#include "sonata_system.h"
+
+#define NUM_SPI_BLOCKS 7
+#define SPI_BLOCK_SIZE 0x1000
+
+// Refill the transmit FIFO once it is half empty, and empty the receive FIFO
+// once it is half full, whatever the depths of the block. The tail of a
+// received transaction is collected on completion.
+#define TX_WATERMARK SPI_TX_WATERMARK_HALF
+#define RX_WATERMARK SPI_RX_WATERMARK_HALF
+
+static spi_queue_t *queues[NUM_SPI_BLOCKS];
+
+static uint32_t spi_block(spi_t *spi) { return ((uintptr_t)spi->reg - SPI0_BASE) / SPI_BLOCK_SIZE; }
+
+static uint32_t min_u32(uint32_t a, uint32_t b) { return a < b ? a : b; }
+
+// Starts the next chunk of the transaction at the head of the queue. The SPI
+// block must be idle.
+static void spi_queue_start_chunk(spi_queue_t *queue) {
+  spi_txn_t *txn = queue->head;
+  uint32_t chunk = min_u32(txn->len - txn->started, SPI_MAX_BYTE_COUNT);
+  txn->started += chunk;
+
+  DEV_WRITE(queue->spi->reg + SPI_INTR_STATE, SPI_INTR_COMPLETE);
+  DEV_WRITE(queue->spi->reg + SPI_START, chunk);
+}
+
+// Starts the transaction at the head of the queue.
+static void spi_queue_start(spi_queue_t *queue) {
+  spi_txn_t *txn  = queue->head;
+  txn->to_send    = txn->tx_data ? txn->len : 0;
+  txn->to_receive = txn->rx_data ? txn->len : 0;
+  txn->started    = 0;
+
+  if (txn->cs != SPI_QUEUE_NO_CS) {
+    DEV_WRITE(queue->spi->reg + SPI_CS, txn->cs | SPI_CS_HOLD);
+  }
+
+  DEV_WRITE(queue->spi->reg + SPI_CONTROL, (txn->tx_data ? SPI_CONTROL_TX_ENABLE : 0) |
+                                               (txn->rx_data ? SPI_CONTROL_RX_ENABLE : 0) |
+                                               SPI_CONTROL_TX_WATERMARK(TX_WATERMARK) |
+                                               SPI_CONTROL_RX_WATERMARK(RX_WATERMARK));
+  spi_queue_start_chunk(queue);
+
+  // The transmit watermark interrupt fires straight away to fill the FIFO.
+  if (queue->polled) {
+    return;
+  }
+  DEV_WRITE(queue->spi->reg + SPI_INTR_ENABLE, SPI_INTR_COMPLETE | (txn->tx_data ? SPI_INTR_TX_WATERMARK : 0) |
+                                                   (txn->rx_data ? SPI_INTR_RX_WATERMARK : 0));
+}
+
+// Moves as many bytes as the FIFOs allow, then starts the next chunk or
+// completes the transaction if the block has gone idle. Runs with interrupts
+// disabled.
+static void spi_queue_service(spi_queue_t *queue) {
+  spi_t *spi     = queue->spi;
+  spi_txn_t *txn = queue->head;
+
+  // Acknowledge completion before reading the status, so that the block going
+  // idle after the read raises the interrupt again.
+  DEV_WRITE(spi->reg + SPI_INTR_STATE, SPI_INTR_COMPLETE);
+  if (txn == NULL) {
+    DEV_WRITE(spi->reg + SPI_INTR_ENABLE, 0);
+    return;
+  }
+
+  uint32_t status = DEV_READ(spi->reg + SPI_STATUS);
+
+  uint32_t batch = min_u32(txn->to_send, spi->tx_fifo_depth - SPI_STATUS_TX_LEVEL(status));
+  txn->tx_data   = spi_fifo_push(spi, txn->tx_data, batch);
+  txn->to_send -= batch;
+  if (txn->to_send == 0 && !queue->polled) {
+    // The watermark interrupt is a level, so stop it once there is nothing left to send.
+    DEV_WRITE(spi->reg + SPI_INTR_ENABLE, DEV_READ(spi->reg + SPI_INTR_ENABLE) & ~SPI_INTR_TX_WATERMARK);
+  }
+
+  batch        = min_u32(txn->to_receive, SPI_STATUS_RX_LEVEL(status));
+  txn->rx_data = spi_fifo_pop(spi, txn->rx_data, batch);
+  txn->to_receive -= batch;
+
+  if ((status & SPI_STATUS_IDLE) == 0) {
+    return;
+  }
+  if (txn->started < txn->len) {
+    spi_queue_start_chunk(queue);
+    return;
+  }
+
+  // Idle with every byte started, so everything received is in the FIFO and
+  // has now been popped.
+  DEV_WRITE(spi->reg + SPI_INTR_ENABLE, 0);
+  if (txn->cs != SPI_QUEUE_NO_CS) {
+    DEV_WRITE(spi->reg + SPI_CS, txn->cs);
+  }
+
+  queue->head = txn->next;
+  if (queue->head == NULL) {
+    queue->tail = NULL;
+  }
+  txn->done = true;
+  if (txn->callback) {
+    txn->callback(txn);
+  }
+
+  if (queue->head != NULL) {
+    spi_queue_start(queue);
+  }
+}
+
+static void spi_queue_irq_handler(irq_t irq) {
+  spi_queue_t *queue = queues[(irq - SPI_IRQ_BASE) / SPI_IRQS_PER_BLOCK];
+  if (queue != NULL) {
+    spi_queue_service(queue);
+  }
+}
+
+void spi_queue_init(spi_queue_t *queue, spi_t *spi) {
+  uint32_t block = spi_block(spi);
+
+  queue->spi    = spi;
+  queue->head   = NULL;
+  queue->tail   = NULL;
+  queue->polled = false;
+  DEV_WRITE(spi->reg + SPI_INTR_ENABLE, 0);
+  queues[block] = queue;
+
+  const uint32_t used_intrs[] = {SPI_INTR_RX_WATERMARK, SPI_INTR_TX_WATERMARK, SPI_INTR_COMPLETE};
+  for (size_t i = 0; i < sizeof(used_intrs) / sizeof(used_intrs[0]); i++) {
+    irq_t irq = SPI_IRQ(block, used_intrs[i]);
+    rv_plic_register_irq(irq, spi_queue_irq_handler);
+    rv_plic_enable(irq);
+  }
+}
+
+void spi_queue_init_polled(spi_queue_t *queue, spi_t *spi) {
+  queue->spi    = spi;
+  queue->head   = NULL;
+  queue->tail   = NULL;
+  queue->polled = true;
+  DEV_WRITE(spi->reg + SPI_INTR_ENABLE, 0);
+}
+
+bool spi_queue_poll(spi_queue_t *queue) {
+  if (queue->head == NULL) {
+    return false;
+  }
+  uint32_t irq_state = arch_local_irq_save();
+  spi_queue_service(queue);
+  arch_local_irq_restore(irq_state);
+  return queue->head != NULL;
+}
+
+void spi_queue_submit(spi_queue_t *queue, spi_txn_t *txn) {
+  txn->next = NULL;
+  txn->done = false;
+
+  if (txn->len == 0) {
+    txn->done = true;
+    if (txn->callback) {
+      txn->callback(txn);
+    }
+    return;
+  }
+
+  uint32_t irq_state = arch_local_irq_save();
+  bool was_idle      = queue->head == NULL;
+  if (was_idle) {
+    queue->head = txn;
+  } else {
+    queue->tail->next = txn;
+  }
+  queue->tail = txn;
+  arch_local_irq_restore(irq_state);
+
+  if (was_idle) {
+    // A transfer started with the blocking functions may still be running.
+    spi_wait_idle(queue->spi);
+    irq_state = arch_local_irq_save();
+    spi_queue_start(queue);
+    arch_local_irq_restore(irq_state);
+  }
+}
+
+void spi_queue_wait(spi_txn_t *txn) {
+  // Check and sleep with interrupts disabled so that completion cannot slip
+  // in between the two. A pending interrupt still wakes the core.
+  uint32_t irq_state = arch_local_irq_save();
+  while (!txn->done) {
+    asm volatile("wfi");
+    arch_local_irq_restore(irq_state);
+    irq_state = arch_local_irq_save();
+  }
+  arch_local_irq_restore(irq_state);
+}
+
+bool spi_queue_idle(spi_queue_t *queue) { return queue->head == NULL; }
@@ -0,0 +1,79 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SPI_QUEUE_H__
+#define SPI_QUEUE_H__
+
+#include "stdbool.h"
+#include "stdint.h"
+
+#include "spi.h"
+
+// Value of `cs` for transactions that leave chip select to the caller.
+#define SPI_QUEUE_NO_CS 0
+
+typedef struct spi_txn spi_txn_t;
+
+// Called from the SPI interrupt once a transaction has finished and its chip
+// select has been released.
+typedef void (*spi_txn_callback_t)(spi_txn_t *txn);
+
+// A transaction for `spi_queue_submit`. The descriptor and its buffers must
+// stay valid until the transaction has completed.
+struct spi_txn {
+  // SPI block chip select lines, as for `spi_set_cs`, held asserted for the
+  // duration of the transaction, or SPI_QUEUE_NO_CS.
+  uint32_t cs;
+  // Bytes to send, or NULL to only receive.
+  const uint8_t *tx_data;
+  // Buffer for received bytes, or NULL to only send.
+  uint8_t *rx_data;
+  uint32_t len;
+  // Optional completion callback, and a pointer for its use.
+  spi_txn_callback_t callback;
+  void *arg;
+
+  // Set once the transaction has completed.
+  volatile bool done;
+
+  // Driver state.
+  spi_txn_t *next;
+  uint32_t to_send;
+  uint32_t to_receive;
+  uint32_t started;
+};
+
+typedef struct spi_queue {
+  spi_t *spi;
+  spi_txn_t *head;
+  spi_txn_t *tail;
+  // Serviced by `spi_queue_poll` rather than the SPI interrupts.
+  bool polled;
+} spi_queue_t;
+
+// Sets up a queue for `spi`, which must have been set up with `spi_init`, and
+// registers its interrupts with the PLIC. `rv_plic_init` must have been called.
+void spi_queue_init(spi_queue_t *queue, spi_t *spi);
+
+// Sets up a queue for `spi` that is serviced by calling `spi_queue_poll`, and
+// uses no interrupts.
+void spi_queue_init_polled(spi_queue_t *queue, spi_t *spi);
+
+// Moves as much data as the FIFOs of a polled queue allow, and moves on to
+// the next chunk or transaction once the block is idle. Returns true while
+// transactions are queued or running.
+bool spi_queue_poll(spi_queue_t *queue);
+
+// Appends `txn` to the queue, starting it if the queue was idle. Returns
+// without waiting for the transaction to run. The chip select of transactions
+// without one is left as it is, so the caller can hold it across several.
+void spi_queue_submit(spi_queue_t *queue, spi_txn_t *txn);
+
+// Sleeps until `txn` has completed. Not for polled queues.
+void spi_queue_wait(spi_txn_t *txn);
+
+// Returns true if no transactions are queued or running.
+bool spi_queue_idle(spi_queue_t *queue);
+
+#endif  // SPI_QUEUE_H__
@@ -0,0 +1,52 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "spi_sched.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+void spi_sched_init(spi_sched_t *sched) {
+  sched->num_buses = 0;
+  sched->next      = 0;
+}
+
+spi_queue_t *spi_sched_add_bus(spi_sched_t *sched, spi_t *spi) {
+  if (sched->num_buses == SPI_SCHED_MAX_BUSES) {
+    return NULL;
+  }
+  spi_queue_t *bus = &sched->buses[sched->num_buses++];
+  spi_queue_init_polled(bus, spi);
+  return bus;
+}
+
+void spi_sched_submit(spi_queue_t *bus, spi_txn_t *txn) { spi_queue_submit(bus, txn); }
+
+bool spi_sched_poll(spi_sched_t *sched) {
+  uint32_t first = sched->next;
+  bool busy      = false;
+  for (uint32_t i = 0; i < sched->num_buses; ++i) {
+    uint32_t bus = first + i;
+    if (bus >= sched->num_buses) {
+      bus -= sched->num_buses;
+    }
+    busy |= spi_queue_poll(&sched->buses[bus]);
+  }
+
+  if (sched->num_buses != 0) {
+    sched->next = first + 1 == sched->num_buses ? 0 : first + 1;
+  }
+  return busy;
+}
+
+void spi_sched_wait(spi_sched_t *sched, spi_txn_t *txn) {
+  while (!txn->done) {
+    spi_sched_poll(sched);
+  }
+}
+
+void spi_sched_run(spi_sched_t *sched) {
+  while (spi_sched_poll(sched)) {
+  }
+}
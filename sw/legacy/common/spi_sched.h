@@ -0,0 +1,48 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SPI_SCHED_H__
+#define SPI_SCHED_H__
+
+#include "stdbool.h"
+#include "stdint.h"
+
+#include "spi.h"
+#include "spi_queue.h"
+
+// One bus for each SPI block.
+#define SPI_SCHED_MAX_BUSES 7
+
+// Services transactions on several SPI blocks from one loop, so that they all
+// run at the same time. Each bus has a polled `spi_queue_t`, and every call to
+// `spi_sched_poll` services each busy bus once, starting with a different bus
+// each time so that none is always served first.
+typedef struct spi_sched {
+  spi_queue_t buses[SPI_SCHED_MAX_BUSES];
+  uint32_t num_buses;
+  // Bus serviced first by the next poll.
+  uint32_t next;
+} spi_sched_t;
+
+void spi_sched_init(spi_sched_t *sched);
+
+// Adds a bus for `spi`, which must have been set up with `spi_init`, and
+// returns its queue for use with `spi_sched_submit`, or NULL if there is no
+// room.
+spi_queue_t *spi_sched_add_bus(spi_sched_t *sched, spi_t *spi);
+
+// Appends `txn` to the queue of `bus`. It runs as the scheduler is polled.
+void spi_sched_submit(spi_queue_t *bus, spi_txn_t *txn);
+
+// Services each busy bus once. Returns true while any bus has transactions
+// queued or running. Can be called from a loop or a timer interrupt.
+bool spi_sched_poll(spi_sched_t *sched);
+
+// Polls until `txn` has completed.
+void spi_sched_wait(spi_sched_t *sched, spi_txn_t *txn);
+
+// Polls until every bus is idle.
+void spi_sched_run(spi_sched_t *sched);
+
+#endif  // SPI_SCHED_H__
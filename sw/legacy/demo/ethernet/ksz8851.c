@@ -6,6 +6,7 @@
 #include <lwip/netif.h>
 #include <string.h>
 
+#include "dma.h"
 #include "ksz8851.h"
 #include "sonata_system.h"
 #include "spi.h"
@@ -19,10 +20,122 @@ enum {
   // GPIO Output
   EthCsPin  = 13,
   EthRstPin = 14,
+
+  // SPI block chip select line
+  EthSpiCs = 0x1,
+
+  // Slowest SPI clock tried when looking for one the chip works at.
+  EthMinSpiSpeedHz = 1000 * 1000,
+
+  // Shortest frame fragment worth handing to the DMA engine.
+  EthMinDmaLen = 64,
+
+  // Frames held by the driver while the chip has no room for them.
+  EthTxQueueLen = 8,
+
+  // Time a partial batch of received frames waits in the chip, in microseconds.
+  EthRxBurstTimeoutUs = 1000,
+
+  // Received frames that can be held by lwIP at once, and the space for each: the longest frame with its CRC,
+  // rounded up to the word the chip pads it to.
+  EthRxPoolFrames = 8,
+  EthRxFrameBufLen = 1520,
 };
 
 static struct netif *eth_netif;
 
+// Send frame data with the DMA engine rather than the CPU.
+static bool tx_use_dma;
+static dma_desc_t tx_descs[DMA_SPI_DESCS(1536)];
+
+void ksz8851_set_dma(bool enable) { tx_use_dma = enable; }
+
+// Frames waiting for room in the chip's transmit queue, oldest first.
+static struct pbuf *tx_queue[EthTxQueueLen];
+static uint32_t tx_head;
+static uint32_t tx_count;
+
+// Frames, and bytes in them, handed to the chip.
+static uint32_t tx_frames;
+static uint32_t tx_bytes;
+
+void ksz8851_tx_stats(uint32_t *frames, uint32_t *bytes) {
+  uint32_t flags = arch_local_irq_save();
+  *frames = tx_frames;
+  *bytes = tx_bytes;
+  arch_local_irq_restore(flags);
+}
+
+// A received frame, read into one buffer and handed to lwIP as a custom pbuf that returns it to the pool when freed.
+typedef struct ksz8851_rx_frame {
+  struct pbuf_custom pc;
+  struct ksz8851_rx_frame *next_free;
+  uint8_t data[EthRxFrameBufLen] __attribute__((aligned(4)));
+} ksz8851_rx_frame_t;
+
+static ksz8851_rx_frame_t rx_pool[EthRxPoolFrames];
+static ksz8851_rx_frame_t *rx_free;
+
+static void ksz8851_rx_pool_init(void) {
+  rx_free = NULL;
+  for (int i = 0; i < EthRxPoolFrames; i++) {
+    rx_pool[i].next_free = rx_free;
+    rx_free = &rx_pool[i];
+  }
+}
+
+// Called by lwIP, possibly from the receive interrupt, once it is done with a frame.
+static void ksz8851_rx_frame_free(struct pbuf *p) {
+  ksz8851_rx_frame_t *frame = (ksz8851_rx_frame_t *)p;
+
+  uint32_t flags = arch_local_irq_save();
+  frame->next_free = rx_free;
+  rx_free = frame;
+  arch_local_irq_restore(flags);
+}
+
+static ksz8851_rx_frame_t *ksz8851_rx_frame_alloc(void) {
+  uint32_t flags = arch_local_irq_save();
+  ksz8851_rx_frame_t *frame = rx_free;
+  if (frame != NULL) {
+    rx_free = frame->next_free;
+  }
+  arch_local_irq_restore(flags);
+
+  if (frame != NULL) {
+    frame->pc.custom_free_function = ksz8851_rx_frame_free;
+  }
+  return frame;
+}
+
+// Frames, and bytes in them, handed to lwIP, and the cycles spent reading and handling them.
+static uint32_t rx_frames;
+static uint32_t rx_bytes;
+static uint32_t rx_cycles;
+
+void ksz8851_rx_stats(uint32_t *frames, uint32_t *bytes, uint32_t *cycles) {
+  uint32_t flags = arch_local_irq_save();
+  *frames = rx_frames;
+  *bytes = rx_bytes;
+  *cycles = rx_cycles;
+  arch_local_irq_restore(flags);
+}
+
+// Sends a fragment of a frame, with the DMA engine moving the word aligned
+// part of it when enabled.
+static void ksz8851_tx_frag(spi_t *spi, const uint8_t *data, uint32_t len) {
+  if (!tx_use_dma || len < EthMinDmaLen) {
+    spi_tx(spi, data, len);
+    return;
+  }
+
+  uint32_t lead = (-(uintptr_t)data) & 0x3;
+  if (lead != 0) {
+    spi_tx(spi, data, lead);
+  }
+  dma_spi_tx(DEFAULT_DMA, spi, tx_descs, data + lead, len - lead);
+}
+
 static void timer_delay(uint32_t ms) {
   // Configure timer to trigger every 1 ms
   timer_enable(SYSCLK_FREQ / 1000);
@@ -33,40 +146,106 @@ static void timer_delay(uint32_t ms) {
   timer_disable();
 }
 
+// SPI bytes spent on register accesses.
+static uint32_t reg_bytes;
+
+uint32_t ksz8851_reg_bytes(void) { return reg_bytes; }
+
+typedef struct {
+  uint8_t reg;
+  // Bits that keep the value written. Commands the chip clears once done are left out, so that later writes do not
+  // repeat them.
+  uint16_t keep;
+  bool valid;
+  uint16_t val;
+} ksz8851_cached_reg_t;
+
+// Copies of the registers that only the driver changes, so that setting or clearing bits in them is a single write
+// rather than a read followed by a write. A copy is loaded by the first write after the chip is reset. Status
+// registers, and anything else the chip changes, are always read from the chip.
+static ksz8851_cached_reg_t reg_cache[] = {
+    {ETH_TXCR, 0xFFFF},
+    {ETH_RXCR1, 0xFFFF},
+    {ETH_RXCR2, 0xFFFF},
+    {ETH_TXQCR, (uint16_t)~ManualEnqueueTxQFrameEnable},
+    {ETH_RXQCR, (uint16_t)~(ReleaseRxErrorFrame | RxFrameCountThresholdStatus | RxDataByteCountThresholdstatus |
+                            RxDurationTimerThresholdStatus)},
+    // Restart auto-negotiation clears itself.
+    {ETH_P1CR, (uint16_t)~(1 << 13)},
+};
+
+static bool reg_cache_enabled = true;
+
+void ksz8851_set_reg_cache(bool enable) {
+  for (size_t i = 0; i < sizeof(reg_cache) / sizeof(reg_cache[0]); i++) {
+    reg_cache[i].valid = false;
+  }
+  reg_cache_enabled = enable;
+}
+
+static ksz8851_cached_reg_t *ksz8851_reg_cache_find(uint8_t reg) {
+  if (!reg_cache_enabled) {
+    return NULL;
+  }
+  for (size_t i = 0; i < sizeof(reg_cache) / sizeof(reg_cache[0]); i++) {
+    if (reg_cache[i].reg == reg) {
+      return &reg_cache[i];
+    }
+  }
+  return NULL;
+}
+
+// Register accesses are a single SPI operation each, so the SPI block frames
+// them with chip select on its own.
 static uint16_t ksz8851_reg_read(spi_t *spi, uint8_t reg) {
   uint8_t be = (reg & 0x2) == 0 ? 0b0011 : 0b1100;
-  uint8_t bytes[2];
+  uint8_t bytes[4] = {0};
   bytes[0] = (0b00 << 6) | (be << 2) | (reg >> 6);
   bytes[1] = (reg << 2) & 0b11110000;
 
-  set_output_bit(GPIO_OUT, EthCsPin, 0);
-  spi_tx(spi, bytes, 2);
-  uint16_t val;
-  spi_rx(spi, (uint8_t *)&val, 2);
-  set_output_bit(GPIO_OUT, EthCsPin, 1);
-  return val;
+  uint8_t rx[4];
+  spi_transfer(spi, bytes, rx, 4);
+  reg_bytes += 4;
+  return rx[2] | (rx[3] << 8);
 }
 
 static void ksz8851_reg_write(spi_t *spi, uint8_t reg, uint16_t val) {
   uint8_t be = (reg & 0x2) == 0 ? 0b0011 : 0b1100;
-  uint8_t bytes[2];
+  uint8_t bytes[4];
   bytes[0] = (0b01 << 6) | (be << 2) | (reg >> 6);
   bytes[1] = (reg << 2) & 0b11110000;
+  bytes[2] = val & 0xff;
+  bytes[3] = val >> 8;
 
-  set_output_bit(GPIO_OUT, EthCsPin, 0);
-  spi_tx(spi, bytes, 2);
-  spi_tx(spi, (uint8_t *)&val, 2);
-  spi_wait_idle(spi);
-  set_output_bit(GPIO_OUT, EthCsPin, 1);
+  spi_tx(spi, bytes, 4);
+  reg_bytes += 4;
+
+  ksz8851_cached_reg_t *cached = ksz8851_reg_cache_find(reg);
+  if (cached != NULL) {
+    cached->val = val & cached->keep;
+    cached->valid = true;
+  }
+}
+
+// Check the chip ID. The last nibble is revision ID and can be ignored.
+static bool ksz8851_check_id(spi_t *spi, void *arg) { return (ksz8851_reg_read(spi, ETH_CIDER) & 0xFFF0) == 0x8870; }
+
+// Returns the value of a register for changing some of its bits, from its copy if it has one.
+static uint16_t ksz8851_reg_old(spi_t *spi, uint8_t reg) {
+  ksz8851_cached_reg_t *cached = ksz8851_reg_cache_find(reg);
+  if (cached != NULL && cached->valid) {
+    return cached->val;
+  }
+  return ksz8851_reg_read(spi, reg);
 }
 
 static void ksz8851_reg_set(spi_t *spi, uint8_t reg, uint16_t mask) {
-  uint16_t old = ksz8851_reg_read(spi, reg);
+  uint16_t old = ksz8851_reg_old(spi, reg);
   ksz8851_reg_write(spi, reg, old | mask);
 }
 
 static void ksz8851_reg_clear(spi_t *spi, uint8_t reg, uint16_t mask) {
-  uint16_t old = ksz8851_reg_read(spi, reg);
+  uint16_t old = ksz8851_reg_old(spi, reg);
   ksz8851_reg_write(spi, reg, old & ~mask);
 }
 
@@ -110,36 +289,25 @@ static void ksz8851_dump(spi_t *spi) {
   puts("");
 }
 
-static err_t ksz8851_output(struct netif *netif, struct pbuf *buf) {
-  spi_t *spi = netif->state;
+static bool ksz8851_tx_room(spi_t *spi, struct pbuf *buf) {
+  uint16_t txmir = ksz8851_reg_read(spi, ETH_TXMIR) & 0x0FFF;
+  return txmir >= buf->tot_len + 4;
+}
 
+// Copies a frame into the chip's transmit queue and enqueues it. The chip must have room for it.
+static void ksz8851_send(spi_t *spi, struct pbuf *buf) {
 #ifdef DEBUG
   putstr("KSZ8851: Transmitting ");
   puthexn(buf->tot_len, 4);
   puts(" bytes");
 #endif
 
-  // Wait until transmit buffer is available.
-  while (1) {
-    uint16_t txmir = ksz8851_reg_read(spi, ETH_TXMIR) & 0x0FFF;
-    if (txmir < buf->tot_len + 4) {
-#ifdef DEBUG
-      puts("KSZ8851: Transmit buffer full");
-#endif
-      continue;
-    }
-    break;
-  }
-
-  // Disable IRQ to avoid interrupting DMA transfer.
-  uint32_t flags = arch_local_irq_save();
-
   // Start QMU DMA transfer operation
   ksz8851_reg_set(spi, ETH_RXQCR, StartDmaAccess);
 
   // Start transmission.
   uint8_t cmd = 0b11 << 6;
-  set_output_bit(GPIO_OUT, EthCsPin, 0);
+  spi_set_cs(spi, EthSpiCs, true);
   spi_tx(spi, &cmd, 1);
 
   uint32_t header = 0x8000 | (buf->tot_len << 16);
@@ -148,7 +316,7 @@ static err_t ksz8851_output(struct netif *netif, struct pbuf *buf) {
   uint32_t len = buf->tot_len;
   for (struct pbuf *p = buf; len != 0 && p != NULL; p = p->next) {
     uint32_t frag_len = p->len > len ? len : p->len;
-    spi_tx(spi, p->payload, frag_len);
+    ksz8851_tx_frag(spi, p->payload, frag_len);
     len -= frag_len;
   }
 
@@ -159,8 +327,7 @@ static err_t ksz8851_output(struct netif *netif, struct pbuf *buf) {
     spi_tx(spi, padding, pad);
   }
 
-  spi_wait_idle(spi);
-  set_output_bit(GPIO_OUT, EthCsPin, 1);
+  spi_set_cs(spi, EthSpiCs, false);
 
   // Stop QMU DMA transfer operation
   ksz8851_reg_clear(spi, ETH_RXQCR, StartDmaAccess);
@@ -168,45 +335,128 @@ static err_t ksz8851_output(struct netif *netif, struct pbuf *buf) {
   // TxQ Manual-Enqueue
   ksz8851_reg_set(spi, ETH_TXQCR, ManualEnqueueTxQFrameEnable);
 
-  arch_local_irq_restore(flags);
+  tx_frames++;
+  tx_bytes += buf->tot_len;
+}
+
+// Sends queued frames until the queue is empty or the chip has no room for the next one. Interrupts are only disabled
+// while a frame is copied, so that received frames can be read in between.
+static void ksz8851_tx_drain(spi_t *spi) {
+  while (1) {
+    uint32_t flags = arch_local_irq_save();
+    if (tx_count == 0 || !ksz8851_tx_room(spi, tx_queue[tx_head])) {
+      arch_local_irq_restore(flags);
+      return;
+    }
+
+    struct pbuf *buf = tx_queue[tx_head];
+    ksz8851_send(spi, buf);
+    tx_queue[tx_head] = NULL;
+    tx_head = (tx_head + 1) % EthTxQueueLen;
+    tx_count--;
+    pbuf_free(buf);
 
-  return 0;
+    arch_local_irq_restore(flags);
+  }
 }
 
-static void ksz8851_drop_error_frame(spi_t *spi) {
-  ksz8851_reg_set(spi, ETH_RXQCR, ReleaseRxErrorFrame);
+// Sends a frame if the chip has room for it and nothing is queued ahead of it, otherwise queues it to be sent from
+// the transmit interrupt. Never waits for the chip; a frame that does not fit in the queue is dropped with ERR_MEM.
+static err_t ksz8851_output(struct netif *netif, struct pbuf *buf) {
+  spi_t *spi = netif->state;
+  err_t err = ERR_OK;
+
+  // Disable IRQ to avoid interrupting DMA transfer, and to keep the queue consistent with the transmit interrupt.
+  uint32_t flags = arch_local_irq_save();
+
+  if (tx_count == 0 && ksz8851_tx_room(spi, buf)) {
+    ksz8851_send(spi, buf);
+  } else if (tx_count == EthTxQueueLen) {
+#ifdef DEBUG
+    puts("KSZ8851: Transmit queue full");
+#endif
+    err = ERR_MEM;
+  } else {
+    // lwIP may reuse the data of a volatile pbuf once this returns, so those frames are queued as a copy.
+    struct pbuf *held = buf;
+    for (struct pbuf *p = buf; p != NULL; p = p->next) {
+      if (PBUF_NEEDS_COPY(p)) {
+        held = pbuf_clone(PBUF_RAW, PBUF_RAM, buf);
+        break;
+      }
+    }
+
+    if (held == NULL) {
+      err = ERR_MEM;
+    } else {
+      if (held == buf) {
+        pbuf_ref(buf);
+      }
+      tx_queue[(tx_head + tx_count) % EthTxQueueLen] = held;
+      tx_count++;
+    }
+  }
+
+  arch_local_irq_restore(flags);
 
-  // Wait until the frame is dropped.
-  while (ksz8851_reg_read(spi, ETH_RXQCR) & ReleaseRxErrorFrame);
+  return err;
 }
 
+// Reads and throws away `len` bytes of the frame being received.
+static void ksz8851_rx_discard(spi_t *spi, uint32_t len) {
+  uint8_t discard[64];
+  while (len > 0) {
+    uint32_t chunk = len < sizeof(discard) ? len : sizeof(discard);
+    spi_rx(spi, discard, chunk);
+    len -= chunk;
+  }
+}
+
+// Reads every frame the chip has queued. The status and byte count of each frame are taken from the header at the
+// start of its data, rather than read from RXFHSR and RXFHBCR first. As the frame's DMA read has then already started,
+// a frame that is not wanted is read out and thrown away, so that auto-dequeue releases it as it does any other.
+// Releasing it with RRXEF instead is only meant for frames whose data has not been read.
 static void ksz8851_recv(struct netif *netif) {
   spi_t *spi = netif->state;
 
   uint16_t frames = ksz8851_reg_read(spi, ETH_RXFCTR) >> 8;
 
   for (; frames; frames--) {
-    uint16_t status = ksz8851_reg_read(spi, ETH_RXFHSR);
+    uint32_t start = get_mcycle();
+
+    // Reset QMU RXQ frame pointer to zero.
+    ksz8851_reg_write(spi, ETH_RXFDPR, 0x4000);
+
+    // Start QMU DMA transfer operation
+    ksz8851_reg_set(spi, ETH_RXQCR, StartDmaAccess);
+
+    // Start receiving.
+    uint8_t cmd = 0b10 << 6;
+    spi_set_cs(spi, EthSpiCs, true);
+    spi_tx(spi, &cmd, 1);
+
+    // A dummy word, then the frame status and byte count.
+    uint8_t header[8];
+    spi_rx(spi, header, 8);
+    uint16_t status = header[4] | (header[5] << 8);
+    uint16_t len = (header[6] | (header[7] << 8)) & 0xFFF;
+
     bool valid = (status & RxFrameValid) &&
                  !(status & (RxCrcError | RxRuntFrame | RxFrameTooLong | RxMiiError | RxUdpFrameChecksumStatus |
                              RxTcpFrameChecksumStatus | RxIpFrameChecksumStatus | RxIcmpFrameChecksumStatus));
-    if (!valid) {
+    ksz8851_rx_frame_t *frame = valid && len != 0 && len <= EthRxFrameBufLen ? ksz8851_rx_frame_alloc() : NULL;
+    if (frame == NULL) {
 #ifdef DEBUG
-      putstr("KSZ8851: Invalid frame, status = ");
+      putstr("KSZ8851: Dropping frame, status = ");
       puthexn(status, 4);
+      putstr(", len = ");
+      puthexn(len, 4);
       puts("");
 #endif
 
-      ksz8851_drop_error_frame(spi);
-      continue;
-    }
-
-    uint16_t len = ksz8851_reg_read(spi, ETH_RXFHBCR) & 0xFFF;
-    if (len == 0) {
-#ifdef DEBUG
-      puts("KSZ8851: Zero length frame");
-#endif
-      ksz8851_drop_error_frame(spi);
+      ksz8851_rx_discard(spi, (len + 3) & ~3);
+      spi_set_cs(spi, EthSpiCs, false);
+      ksz8851_reg_clear(spi, ETH_RXQCR, StartDmaAccess);
       continue;
     }
 
@@ -218,37 +468,10 @@ static void ksz8851_recv(struct netif *netif) {
     puts("");
 #endif
 
-    struct pbuf* buf = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
-
-    // Reset QMU RXQ frame pointer to zero.
-    ksz8851_reg_write(spi, ETH_RXFDPR, 0x4000);
-    
-    // Start QMU DMA transfer operation
-    ksz8851_reg_set(spi, ETH_RXQCR, StartDmaAccess);
-
-    // Start receiving.
-    uint8_t cmd = 0b10 << 6;
-    set_output_bit(GPIO_OUT, EthCsPin, 0);
-    spi_tx(spi, &cmd, 1);
-
-    uint8_t dummy[8];
-    // Read the dummy initial word and headers (which we have already know from RXFHSR and RXFHBCR).
-    spi_rx(spi, dummy, 8);
-
-    uint16_t rem_len = len;
-    for (struct pbuf *p = buf; rem_len != 0 && p != NULL; p = p->next) {
-      uint32_t frag_len = p->len > rem_len ? rem_len : p->len;
-      spi_rx(spi, p->payload, frag_len);
-      rem_len -= frag_len;
-    }
-
-    // The receiving needs to be dword-aligned, so we read the dummy paddings.
-    uint32_t pad = (-len) & 0x3;
-    if (pad != 0) {
-      spi_rx(spi, dummy, pad);
-    }
+    // The receiving needs to be dword-aligned, so the dummy paddings are read into the end of the buffer.
+    spi_rx(spi, frame->data, (len + 3) & ~3);
 
-    set_output_bit(GPIO_OUT, EthCsPin, 1);
+    spi_set_cs(spi, EthSpiCs, false);
 
     // Stop QMU DMA transfer operation
     ksz8851_reg_clear(spi, ETH_RXQCR, StartDmaAccess);
@@ -259,7 +482,14 @@ static void ksz8851_recv(struct netif *netif) {
     puts("");
 #endif
 
-    netif->input(buf, netif);
+    struct pbuf *buf = pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &frame->pc, frame->data, EthRxFrameBufLen);
+    if (netif->input(buf, netif) != ERR_OK) {
+      pbuf_free(buf);
+    }
+
+    rx_frames++;
+    rx_bytes += len;
+    rx_cycles += get_mcycle() - start;
   }
 }
 
@@ -276,6 +506,10 @@ err_t ksz8851_poll(struct netif *netif) {
 
     ksz8851_recv(netif);
   }
+  if (isr & (1 << 14)) {
+    ksz8851_reg_write(spi, ETH_ISR, 1 << 14);
+  }
+  ksz8851_tx_drain(spi);
 
   arch_local_irq_restore(flags);
 }
@@ -293,27 +527,54 @@ static void ksz8851_irq_handler(irq_t irq) {
   if (isr & (1 << 13)) {
     ksz8851_recv(eth_netif);
   }
+  // The chip has sent a frame, so may have room for queued ones.
+  if (isr & (1 << 14)) {
+    ksz8851_tx_drain(spi);
+  }
+}
+
+void ksz8851_set_rx_burst(struct netif *netif, uint8_t frames) {
+  spi_t *spi = netif->state;
+  if (frames == 0) frames = 1;
+
+  uint16_t rxqcr = RxFrameCountThresholdEnable | AutoDequeueRxQFrameEnable;
+  if (frames > 1) rxqcr |= RxDurationTimerThresholdEnable;
+
+  uint32_t flags = arch_local_irq_save();
+  ksz8851_reg_write(spi, ETH_RXFCTR, frames);
+  ksz8851_reg_write(spi, ETH_RXQCR, rxqcr);
+  arch_local_irq_restore(flags);
 }
 
 err_t ksz8851_init(struct netif *netif) {
   spi_t *spi = netif->state;
   if (!spi) return ERR_ARG;
 
+  // Leave chip select to the SPI block.
+  set_output_bit(GPIO_OUT, EthCsPin, 1);
+  spi_set_cs(spi, EthSpiCs, false);
+
   // Reset chip
   set_output_bit(GPIO_OUT, EthRstPin, 0);
   timer_delay(150);
   set_output_bit(GPIO_OUT, EthRstPin, 0x1);
+  ksz8851_set_reg_cache(reg_cache_enabled);
+
+  // Find the fastest SPI clock at which the chip ID reads back correctly.
+  uint32_t speed = spi_sweep_speed(spi, spi->speed, EthMinSpiSpeedHz, ksz8851_check_id, NULL);
 
   uint16_t cider = ksz8851_reg_read(spi, ETH_CIDER);
   putstr("KSZ8851: Chip ID is ");
   puthexn(cider, 4);
   puts("");
 
-  // Check the chip ID. The last nibble is revision ID and can be ignored.
-  if ((cider & 0xFFF0) != 0x8870) {
+  if (speed == 0) {
     puts("KSZ8851: Unexpected Chip ID");
     return ERR_ARG;
   }
+  putstr("KSZ8851: SPI clock is ");
+  putdec(speed);
+  puts(" Hz");
 
   // Write the MAC address and initialize MAC address in netif.
   struct eth_addr addr = ETH_ADDR(0x3a, 0x30, 0x25, 0x24, 0xfe, 0x7a);
@@ -328,6 +589,8 @@ err_t ksz8851_init(struct netif *netif) {
   memcpy(netif->hwaddr, &addr, ETH_HWADDR_LEN);
   netif->hwaddr_len = ETH_HWADDR_LEN;
 
+  ksz8851_rx_pool_init();
+
   // Enable QMU Transmit Frame Data Pointer Auto Increment
   ksz8851_reg_write(spi, ETH_TXFDPR, 0x4000);
   // Enable QMU Transmit flow control / Transmit padding / Transmit CRC, and IP/TCP/UDP checksum generation.
@@ -336,13 +599,16 @@ err_t ksz8851_init(struct netif *netif) {
   ksz8851_reg_write(spi, ETH_RXFDPR, 0x4000);
   // Configure Receive Frame Threshold for one frame.
   ksz8851_reg_write(spi, ETH_RXFCTR, 0x0001);
+  // Deliver partial batches of frames after a short wait when the threshold is raised.
+  ksz8851_reg_write(spi, ETH_RXDTTR, EthRxBurstTimeoutUs);
   // Enable QMU Receive flow control / Receive all broadcast frames /Receive unicast frames, and IP/TCP/UDP checksum
   // verification etc.
   ksz8851_reg_write(spi, ETH_RXCR1, 0x7CE0);
   // Enable QMU Receive UDP Lite frame checksum verification, UDP Lite frame checksum generation, IPv6 UDP fragment
   // frame pass, and IPv4/IPv6 UDP UDP checksum field is zero pass.
-  // In addition (not in the programmer's guide), enable single-frame data burst.
-  ksz8851_reg_write(spi, ETH_RXCR2, 0x009C);
+  // In addition (not in the programmer's guide), enable single-frame data burst, and ICMP frame checksum verification
+  // (bit 1) so that lwIP need not check ICMP checksums.
+  ksz8851_reg_write(spi, ETH_RXCR2, 0x009E);
   // Enable QMU Receive Frame Count Threshold / RXQ Auto-Dequeue frame.
   ksz8851_reg_write(spi, ETH_RXQCR, RxFrameCountThresholdEnable | AutoDequeueRxQFrameEnable);
 
@@ -10,6 +10,21 @@
 
 err_t ksz8851_init(struct netif *netif);
 err_t ksz8851_poll(struct netif *netif);
+// Selects whether frame data is sent with the DMA engine or the CPU.
+void ksz8851_set_dma(bool enable);
+// Sets how many received frames the chip queues before interrupting. Above one,
+// a partial batch is still delivered once the receive duration timer expires.
+void ksz8851_set_rx_burst(struct netif *netif, uint8_t frames);
+// Returns the number of frames, and bytes in them, handed to lwIP so far, and
+// the cycles spent reading and handling them.
+void ksz8851_rx_stats(uint32_t *frames, uint32_t *bytes, uint32_t *cycles);
+// Returns the number of frames, and bytes in them, handed to the chip so far.
+void ksz8851_tx_stats(uint32_t *frames, uint32_t *bytes);
+// Selects whether bits of the registers only the driver changes are set and
+// cleared from a copy of the register, rather than by reading it first.
+void ksz8851_set_reg_cache(bool enable);
+// Returns the number of SPI bytes spent on register accesses so far.
+uint32_t ksz8851_reg_bytes(void);
 
 #define ETH_MARL 0x10  // MAC address low
 #define ETH_MARM 0x12  // MAC address middle
@@ -29,6 +44,7 @@ err_t ksz8851_poll(struct netif *netif);
 #define ETH_RXFHBCR 0x7e  // Receive frame header byte count register
 #define ETH_RXQCR 0x82    // RXQ control register
 #define ETH_RXFDPR 0x86   // RX frame data pointer register
+#define ETH_RXDTTR 0x8c   // RX duration timer threshold register
 #define ETH_IER 0x90      // Interrupt enable register
 #define ETH_ISR 0x92      // Interrupt status register
 #define ETH_RXFCTR 0x9c   // RX frame count and threshold register
@@ -14,4 +14,28 @@ typedef uint32_t sys_prot_t;
 #define LWIP_DHCP 1
 #define LWIP_NETIF_EXT_STATUS_CALLBACK 1
 
+// The KSZ8851 driver hands received frames to lwIP in its own buffers.
+#define LWIP_SUPPORT_CUSTOM_PBUF 1
+
+// The KSZ8851 checks IP, TCP, UDP and ICMP checksums of received frames, and
+// the driver drops those that fail. It generates IP, TCP and UDP checksums
+// of transmitted frames, but not ICMP ones.
+#define CHECKSUM_CHECK_IP 0
+#define CHECKSUM_CHECK_TCP 0
+#define CHECKSUM_CHECK_UDP 0
+#define CHECKSUM_CHECK_ICMP 0
+#define CHECKSUM_GEN_IP 0
+#define CHECKSUM_GEN_TCP 0
+#define CHECKSUM_GEN_UDP 0
+
+// Full size TCP segments with a few in flight in each direction, and heap for
+// their headers and for frames the KSZ8851 driver queues, for the network
+// benchmark.
+#define TCP_MSS 1460
+#define TCP_WND (4 * TCP_MSS)
+#define TCP_SND_BUF (4 * TCP_MSS)
+#define TCP_SND_QUEUELEN (4 * TCP_SND_BUF / TCP_MSS)
+#define MEMP_NUM_TCP_SEG TCP_SND_QUEUELEN
+#define MEM_SIZE (16 * 1024)
+
 #endif
@@ -5,10 +5,14 @@
 #include <lwip/init.h>
 #include <lwip/netif.h>
 #include <lwip/dhcp.h>
+#include <lwip/pbuf.h>
 #include <lwip/timeouts.h>
+#include <lwip/udp.h>
 #include <netif/ethernet.h>
+#include <string.h>
 
 #include "ksz8851.h"
+#include "netbench.h"
 #include "sonata_system.h"
 #include "spi.h"
 #include "timer.h"
@@ -21,8 +25,178 @@ enum {
   // GPIO Output
   EthCsPin  = 13,
   EthRstPin = 14,
+
+  // Frames sent by the transmit benchmark in each mode.
+  TxBenchFrames = 16,
+  TxBenchFrameLen = 1500,
+
+  // Time the receive benchmark listens for in each mode, and the frames the
+  // chip batches before interrupting in burst mode.
+  RxBenchMs = 5000,
+  RxBurstFrames = 8,
+
+  // Time the UDP benchmark sends for, and the size of each datagram's data,
+  // which fills a 1500 byte IP packet.
+  UdpBenchMs = 5000,
+  UdpBenchLen = 1472,
+  UdpDiscardPort = 9,
 };
 
+#ifdef ETH_BENCH
+// Broadcast frame with the local experimental EtherType, so nothing on the
+// network acts on it.
+static uint8_t tx_bench_frame[TxBenchFrameLen] __attribute__((aligned(4)));
+
+// Returns the average cycles taken to hand a full size frame to the chip.
+static uint32_t tx_bench(struct netif *netif, bool use_dma) {
+  ksz8851_set_dma(use_dma);
+
+  uint32_t total = 0;
+  for (int i = 0; i < TxBenchFrames; ++i) {
+    struct pbuf *p = pbuf_alloc(PBUF_RAW, TxBenchFrameLen, PBUF_ROM);
+    p->payload     = tx_bench_frame;
+
+    uint32_t start = get_mcycle();
+    netif->linkoutput(netif, p);
+    total += get_mcycle() - start;
+
+    pbuf_free(p);
+  }
+
+  ksz8851_set_dma(false);
+  return total / TxBenchFrames;
+}
+
+// Returns the SPI bytes spent on register accesses for each frame sent, with
+// or without the driver's copies of its registers.
+static uint32_t reg_bench(struct netif *netif, bool cache) {
+  ksz8851_set_reg_cache(cache);
+
+  uint32_t start = ksz8851_reg_bytes();
+  tx_bench(netif, false);
+  uint32_t bytes = ksz8851_reg_bytes() - start;
+
+  ksz8851_set_reg_cache(true);
+  return bytes / TxBenchFrames;
+}
+
+static void tx_bench_report(struct netif *netif) {
+  memset(tx_bench_frame, 0xff, 6);
+  memcpy(tx_bench_frame + 6, netif->hwaddr, 6);
+  tx_bench_frame[12] = 0x88;
+  tx_bench_frame[13] = 0xb5;
+  for (int i = 14; i < TxBenchFrameLen; ++i) {
+    tx_bench_frame[i] = i;
+  }
+
+  uint32_t cpu_cycles = tx_bench(netif, false);
+  uint32_t dma_cycles = tx_bench(netif, true);
+
+  putstr("1500 byte frame transmit, CPU: ");
+  putdec(cpu_cycles);
+  putstr(" cycles, DMA: ");
+  putdec(dma_cycles);
+  puts(" cycles");
+
+  uint32_t uncached_bytes = reg_bench(netif, false);
+  uint32_t cached_bytes = reg_bench(netif, true);
+
+  putstr("Register SPI bytes per frame transmitted, read-modify-write: ");
+  putdec(uncached_bytes);
+  putstr(", cached: ");
+  putdec(cached_bytes);
+  puts("");
+}
+
+// Counts what arrives from the network for `RxBenchMs` with the chip
+// interrupting after each `burst` frames, and prints the rates.
+static void rx_bench(struct netif *netif, uint8_t burst) {
+  ksz8851_set_rx_burst(netif, burst);
+
+  uint32_t start_frames, start_bytes, start_cycles, frames, bytes, cycles;
+  ksz8851_rx_stats(&start_frames, &start_bytes, &start_cycles);
+  uint32_t start_reg_bytes = ksz8851_reg_bytes();
+  uint64_t start = timer_read();
+  uint64_t end = start + (uint64_t)RxBenchMs * (SYSCLK_FREQ / 1000);
+  while (timer_read() < end) {
+    // lwIP is also entered from the receive interrupt.
+    uint32_t flags = arch_local_irq_save();
+    sys_check_timeouts();
+    arch_local_irq_restore(flags);
+  }
+  ksz8851_rx_stats(&frames, &bytes, &cycles);
+  frames -= start_frames;
+  bytes -= start_bytes;
+  cycles -= start_cycles;
+  uint32_t reg_bytes = ksz8851_reg_bytes() - start_reg_bytes;
+
+  putstr("Receive, ");
+  putdec(burst);
+  putstr(" frame threshold: ");
+  netbench_put_rates(frames, "frames", bytes, RxBenchMs);
+  if (frames != 0) {
+    putstr("Register SPI bytes per frame received: ");
+    putdec(reg_bytes / frames);
+    putstr(", cycles per frame: ");
+    putdec(cycles / frames);
+    puts("");
+  }
+}
+
+// Measures receive throughput for whatever traffic is on the network, such as
+// broadcasts on a busy LAN, first handling frames one at a time, then in
+// bursts. Burst mode is left enabled.
+static void rx_bench_report(struct netif *netif) {
+  rx_bench(netif, 1);
+  rx_bench(netif, RxBurstFrames);
+}
+
+// Data of the UDP benchmark's datagrams, which lwIP sends without copying.
+static const uint8_t udp_bench_data[UdpBenchLen];
+
+// Broadcasts datagrams to the discard port as fast as the driver takes them
+// for `UdpBenchMs`, and prints the rate they were accepted at. Datagrams
+// refused because the driver's transmit queue is full are counted as dropped.
+static void udp_tx_bench(void) {
+  struct udp_pcb *pcb = udp_new();
+  if (pcb == NULL) {
+    puts("UDP transmit: no PCB");
+    return;
+  }
+
+  uint32_t sent = 0;
+  uint32_t dropped = 0;
+  uint64_t end = timer_read() + (uint64_t)UdpBenchMs * (SYSCLK_FREQ / 1000);
+  while (timer_read() < end) {
+    // lwIP is also entered from the receive interrupt.
+    uint32_t flags = arch_local_irq_save();
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, UdpBenchLen, PBUF_ROM);
+    if (p == NULL) {
+      dropped++;
+    } else {
+      p->payload = (void *)udp_bench_data;
+      if (udp_sendto(pcb, p, IP_ADDR_BROADCAST, UdpDiscardPort) == ERR_OK) {
+        sent++;
+      } else {
+        dropped++;
+      }
+      pbuf_free(p);
+    }
+    arch_local_irq_restore(flags);
+  }
+  udp_remove(pcb);
+
+  putstr("UDP transmit: ");
+  netbench_put_rates(sent, "datagrams", sent * UdpBenchLen, UdpBenchMs);
+  putstr("UDP transmit dropped: ");
+  putdec(dropped);
+  puts("");
+}
+#endif  // ETH_BENCH
+
+// Set once DHCP has given the interface an address.
+static volatile bool have_address;
+
 void eth_callback(struct netif* netif, netif_nsc_reason_t reason, const netif_ext_callback_args_t* args) {
   if (reason & LWIP_NSC_IPV4_ADDR_VALID) {
     putstr("IPv4 address available: ");
@@ -35,6 +209,8 @@ void eth_callback(struct netif* netif, netif_nsc_reason_t reason, const netif_ex
     putchar('.');
     putdec(ip4_addr4(addr));
     puts("");
+
+    have_address = true;
   }
 }
 
@@ -48,10 +224,22 @@ int main(void) {
   lwip_init();
 
   spi_t spi;
-  spi_init(&spi, ETH_SPI, 0 /* speed, currently unused */);
+  spi_init(&spi, ETH_SPI, ETH_SPI_SPEED_HZ);
+
+  netif_ext_callback_t callback;
+  netif_add_ext_callback(&callback, eth_callback);
 
   struct netif netif;
+#ifdef ETH_STATIC_IP
+  // A fixed address, for networks without a DHCP server such as a simulated
+  // link to the host.
+  ip4_addr_t addr, netmask;
+  ip4addr_aton(ETH_STATIC_IP, &addr);
+  IP4_ADDR(&netmask, 255, 255, 255, 0);
+  netif_add(&netif, &addr, &netmask, IP4_ADDR_ANY, &spi, ksz8851_init, ethernet_input);
+#else
   netif_add(&netif, IP4_ADDR_ANY, IP4_ADDR_ANY, IP4_ADDR_ANY, &spi, ksz8851_init, ethernet_input);
+#endif
   netif.name[0] = 'e';
   netif.name[1] = '0';
   netif_set_default(&netif);
@@ -59,14 +247,43 @@ int main(void) {
 
   netif_set_link_up(&netif);
 
-  dhcp_start(&netif);
+#ifdef ETH_BENCH
+  // Measure the driver on its own first, then serve the network benchmark.
+  tx_bench_report(&netif);
+  rx_bench_report(&netif);
 
-  netif_ext_callback_t callback;
-  netif_add_ext_callback(&callback, eth_callback);
+  netbench_init();
+  // Wake from idle every millisecond to run lwIP's timers.
+  timer_enable(SYSCLK_FREQ / 1000);
+#endif
+
+#ifdef ETH_STATIC_IP
+  have_address = true;
+#else
+  dhcp_start(&netif);
+#endif
 
+#ifdef ETH_BENCH
+  bool udp_bench_done = false;
+#endif
   while (1) {
     // ksz8851_poll(&netif);
+    // lwIP is also entered from the receive interrupt.
+    uint32_t flags = arch_local_irq_save();
     sys_check_timeouts();
+    arch_local_irq_restore(flags);
+
+#ifdef ETH_BENCH
+    // The callback can run from the receive interrupt, so the UDP benchmark
+    // is started from here once there is an address to send from.
+    if (have_address && !udp_bench_done) {
+      udp_tx_bench();
+      udp_bench_done = true;
+    }
+
+    netbench_poll();
+    netbench_idle();
+#endif
   }
 
   return 0;
@@ -0,0 +1,249 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwip/pbuf.h>
+#include <lwip/tcp.h>
+#include <lwip/timeouts.h>
+#include <lwip/udp.h>
+
+#include "ksz8851.h"
+#include "netbench.h"
+#include "sonata_system.h"
+
+enum {
+  DiscardPort = 9,
+  ChargenPort = 19,
+
+  // How long a UDP blast lasts after each datagram to the chargen port.
+  BlastMs = 10000,
+
+  // Data of each UDP datagram sent, which fills a 1500 byte IP packet. TCP
+  // segments take up to the MSS from the same data.
+  DatagramLen = 1472,
+
+  ReportMs = 1000,
+};
+
+// Printable characters in the rotating pattern of RFC 864, which lwIP sends
+// without copying.
+static uint8_t chargen_data[DatagramLen];
+
+static struct udp_pcb *blast_pcb;
+static ip_addr_t blast_addr;
+static u16_t blast_port;
+static uint32_t blast_until;
+static bool blasting;
+
+// Application data received and sent, not counting headers. TCP data is
+// counted as sent once the peer acknowledges it.
+static volatile uint32_t rx_bytes;
+static volatile uint32_t tx_bytes;
+
+static volatile uint32_t idle_cycles;
+
+static uint32_t report_time;
+static uint32_t report_cycles;
+static uint32_t report_idle;
+static uint32_t report_rx_bytes, report_tx_bytes;
+static uint32_t report_rx_frames, report_tx_frames;
+
+void netbench_put_rates(uint32_t count, const char *unit, uint32_t bytes, uint32_t ms) {
+  uint32_t kbits = (uint64_t)bytes * 8 / ms;
+  putdec((uint64_t)count * 1000 / ms);
+  putchar(' ');
+  putstr(unit);
+  putstr("/s, ");
+  putdec(kbits / 1000);
+  putchar('.');
+  putdec(kbits / 100 % 10);
+  putdec(kbits / 10 % 10);
+  puts(" Mbit/s");
+}
+
+static void udp_discard_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port) {
+  rx_bytes += p->tot_len;
+  pbuf_free(p);
+}
+
+static void udp_chargen_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port) {
+  pbuf_free(p);
+
+  ip_addr_copy(blast_addr, *addr);
+  blast_port  = port;
+  blast_until = sys_now() + BlastMs;
+  blasting    = true;
+}
+
+// Sends datagrams until the driver's transmit queue is full.
+static void udp_blast(void) {
+  while (blasting) {
+    if ((int32_t)(sys_now() - blast_until) >= 0) {
+      blasting = false;
+      break;
+    }
+
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, DatagramLen, PBUF_ROM);
+    if (p == NULL) {
+      break;
+    }
+    p->payload = chargen_data;
+
+    err_t err = udp_sendto(blast_pcb, p, &blast_addr, blast_port);
+    pbuf_free(p);
+    if (err != ERR_OK) {
+      break;
+    }
+    tx_bytes += DatagramLen;
+  }
+}
+
+static err_t tcp_discard_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
+  if (p == NULL) {
+    tcp_close(pcb);
+    return ERR_OK;
+  }
+
+  rx_bytes += p->tot_len;
+  tcp_recved(pcb, p->tot_len);
+  pbuf_free(p);
+  return ERR_OK;
+}
+
+static err_t tcp_discard_accept(void *arg, struct tcp_pcb *pcb, err_t err) {
+  if (err != ERR_OK || pcb == NULL) {
+    return ERR_VAL;
+  }
+  tcp_recv(pcb, tcp_discard_recv);
+  return ERR_OK;
+}
+
+// Queues as much data as the send buffer takes.
+static void tcp_chargen_fill(struct tcp_pcb *pcb) {
+  while (1) {
+    u16_t len = tcp_sndbuf(pcb);
+    if (len > tcp_mss(pcb)) len = tcp_mss(pcb);
+    if (len == 0 || tcp_write(pcb, chargen_data, len, 0) != ERR_OK) {
+      break;
+    }
+  }
+  tcp_output(pcb);
+}
+
+static err_t tcp_chargen_sent(void *arg, struct tcp_pcb *pcb, u16_t len) {
+  tx_bytes += len;
+  tcp_chargen_fill(pcb);
+  return ERR_OK;
+}
+
+static err_t tcp_chargen_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
+  if (p == NULL) {
+    tcp_sent(pcb, NULL);
+    tcp_close(pcb);
+    return ERR_OK;
+  }
+
+  // Anything the peer sends is ignored.
+  tcp_recved(pcb, p->tot_len);
+  pbuf_free(p);
+  return ERR_OK;
+}
+
+static err_t tcp_chargen_accept(void *arg, struct tcp_pcb *pcb, err_t err) {
+  if (err != ERR_OK || pcb == NULL) {
+    return ERR_VAL;
+  }
+  tcp_recv(pcb, tcp_chargen_recv);
+  tcp_sent(pcb, tcp_chargen_sent);
+  tcp_chargen_fill(pcb);
+  return ERR_OK;
+}
+
+static void tcp_listen_on(u16_t port, tcp_accept_fn accept) {
+  struct tcp_pcb *pcb = tcp_new();
+  if (pcb == NULL || tcp_bind(pcb, IP_ADDR_ANY, port) != ERR_OK) {
+    puts("Netbench: unable to bind TCP port");
+    return;
+  }
+  pcb = tcp_listen(pcb);
+  tcp_accept(pcb, accept);
+}
+
+void netbench_init(void) {
+  for (int i = 0; i < DatagramLen; i++) {
+    chargen_data[i] = (i % 74 == 72) ? '\r' : (i % 74 == 73) ? '\n' : ' ' + (i / 74 + i % 74) % 95;
+  }
+
+  struct udp_pcb *discard_pcb = udp_new();
+  udp_bind(discard_pcb, IP_ADDR_ANY, DiscardPort);
+  udp_recv(discard_pcb, udp_discard_recv, NULL);
+
+  blast_pcb = udp_new();
+  udp_bind(blast_pcb, IP_ADDR_ANY, ChargenPort);
+  udp_recv(blast_pcb, udp_chargen_recv, NULL);
+
+  tcp_listen_on(DiscardPort, tcp_discard_accept);
+  tcp_listen_on(ChargenPort, tcp_chargen_accept);
+
+  report_time   = sys_now();
+  report_cycles = get_mcycle();
+
+  puts("Netbench: discard and chargen servers on UDP and TCP ports 9 and 19");
+}
+
+// Prints the rates since the last report, if there was any traffic.
+static void netbench_report(void) {
+  uint32_t now = sys_now();
+  if (now - report_time < ReportMs) {
+    return;
+  }
+
+  uint32_t rx_frames, tx_frames, unused;
+  ksz8851_rx_stats(&rx_frames, &unused, &unused);
+  ksz8851_tx_stats(&tx_frames, &unused);
+  uint32_t cycles = get_mcycle();
+
+  uint32_t ms = now - report_time;
+  uint32_t rx = rx_bytes - report_rx_bytes;
+  uint32_t tx = tx_bytes - report_tx_bytes;
+  uint32_t rx_packets = rx_frames - report_rx_frames;
+  uint32_t tx_packets = tx_frames - report_tx_frames;
+  uint32_t idle = (uint64_t)(idle_cycles - report_idle) * 100 / (cycles - report_cycles);
+
+  if (rx != 0 || tx != 0) {
+    putstr("Receive: ");
+    netbench_put_rates(rx_packets, "packets", rx, ms);
+    putstr("Transmit: ");
+    netbench_put_rates(tx_packets, "packets", tx, ms);
+    putstr("CPU idle: ");
+    putdec(idle);
+    puts("%");
+  }
+
+  report_time      = now;
+  report_cycles    = cycles;
+  report_idle      = idle_cycles;
+  report_rx_bytes  = rx_bytes;
+  report_tx_bytes  = tx_bytes;
+  report_rx_frames = rx_frames;
+  report_tx_frames = tx_frames;
+}
+
+void netbench_poll(void) {
+  // lwIP is also entered from the receive interrupt.
+  uint32_t flags = arch_local_irq_save();
+  udp_blast();
+  arch_local_irq_restore(flags);
+
+  netbench_report();
+}
+
+void netbench_idle(void) {
+  // The interrupt is taken once they are enabled again, so its handler is
+  // not counted as idle time.
+  uint32_t flags = arch_local_irq_save();
+  uint32_t start = get_mcycle();
+  asm volatile("wfi");
+  idle_cycles += get_mcycle() - start;
+  arch_local_irq_restore(flags);
+}
@@ -0,0 +1,35 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef NETBENCH_H
+#define NETBENCH_H
+
+#include <stdint.h>
+
+// Network benchmark servers, for measuring what the KSZ8851 driver and lwIP
+// sustain against a peer such as util/netbench.py:
+// - UDP port 9 (discard) counts the datagrams sent to it.
+// - UDP port 19 (chargen) sends datagrams as fast as it can to whoever sent a
+//   datagram to it, for a few seconds.
+// - TCP port 9 (discard) reads and drops what connections send.
+// - TCP port 19 (chargen) sends to connections until they close.
+// Each second with traffic, the throughput in each direction and the share
+// of time the CPU spent idle are printed.
+
+// Starts the servers, which receive on any address of the default interface.
+void netbench_init(void);
+
+// Sends UDP datagrams while a blast is running and prints the rates once a
+// second. Call from the main loop.
+void netbench_poll(void);
+
+// Waits for an interrupt, counting the time as idle. Call from the main loop
+// when there is nothing else to do.
+void netbench_idle(void);
+
+// Prints `count` things of `bytes` in total over `ms` as a rate per second
+// and in Mbit/s.
+void netbench_put_rates(uint32_t count, const char *unit, uint32_t bytes, uint32_t ms);
+
+#endif
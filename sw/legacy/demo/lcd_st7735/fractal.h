@@ -5,9 +5,14 @@
 #define LCD_ST_7735_FRACTAL
 
 #include "lcd.h"
+#include "spi_queue.h"
 
 void fractal_mandelbrot_float(St7735Context *lcd);
 void fractal_mandelbrot_fixed(St7735Context *lcd);
+// Draws the same fractal as fractal_mandelbrot_float a row at a time. Each row
+// is sent with a blocking write when `queue` is NULL, otherwise through
+// `queue` while the next row is computed.
+void fractal_mandelbrot_float_rows(St7735Context *lcd, spi_queue_t *queue);
 extern uint16_t rgb_iters_palette[51];
 
 #endif
@@ -6,6 +6,7 @@
 
 #include "fractal.h"
 #include "lcd.h"
+#include "spi_queue.h"
 
 typedef struct {
   float real;
@@ -77,3 +78,58 @@ void fractal_mandelbrot_float(St7735Context *lcd) {
 
   lcd_st7735_rgb565_finish(lcd);
 }
+
+void fractal_mandelbrot_float_rows(St7735Context *lcd, spi_queue_t *queue) {
+  // Rows alternate between two buffers, so one can be sent while the next is
+  // computed.
+  static uint16_t rows[2][160];
+  spi_txn_t txns[2] = {0};
+  cmplx_float_t cur_p;
+  float real_inc;
+  float imag_inc;
+
+  LCD_rectangle rectangle = {.origin = {.x = 0, .y = 0}, .width = 160, .height = 128};
+  lcd_st7735_clean(lcd);
+  lcd_st7735_rgb565_start(lcd, rectangle);
+
+  cur_p.real = -1.75f;
+  cur_p.imag = 1.0f;
+
+  real_inc = 2.5f / 160.0f;
+  imag_inc = -2.0f / 128.0f;
+
+  for (int y = 0; y < 128; ++y) {
+    uint16_t *row  = rows[y & 1];
+    spi_txn_t *txn = &txns[y & 1];
+
+    if (queue && y >= 2) {
+      spi_queue_wait(txn);
+    }
+
+    for (int x = 0; x < 160; ++x) {
+      int iters = mandel_iters_float(cur_p, 50);
+
+      uint16_t rgb = rgb_iters_palette[iters];
+      row[x]       = LCD_rgb565_to_bgr565((uint8_t *)&rgb);
+
+      cur_p.real += real_inc;
+    }
+
+    if (queue) {
+      *txn = (spi_txn_t){.cs = SPI_QUEUE_NO_CS, .tx_data = (uint8_t *)row, .len = sizeof(rows[0])};
+      spi_queue_submit(queue, txn);
+    } else {
+      lcd->parent.interface->spi_write(lcd->parent.interface->handle, (uint8_t *)row, sizeof(rows[0]));
+    }
+
+    cur_p.imag += imag_inc;
+    cur_p.real = -1.75f;
+  }
+
+  if (queue) {
+    spi_queue_wait(&txns[0]);
+    spi_queue_wait(&txns[1]);
+  }
+
+  lcd_st7735_rgb565_finish(lcd);
+}
@@ -5,11 +5,14 @@
 #include "core/lucida_console_10pt.h"
 #include "core/m3x6_16pt.h"
 #include "sonata_system.h"
+#include "dma.h"
 #include "fractal.h"
 #include "gpio.h"
 #include "lcd.h"
 #include "lowrisc_logo.h"
+#include "rv_plic.h"
 #include "spi.h"
+#include "spi_queue.h"
 #include "st7735/lcd_st7735.h"
 #include "timer.h"
 #include "fbcon.h"
@@ -23,8 +26,9 @@ enum {
   LcdBlPin,
   LcdMosiPin,
   LcdSclkPin,
-  // Spi clock rate.
-  SpiSpeedHz = 5 * 100 * 1000,
+
+  // SPI block chip select line.
+  LcdSpiCs = 0x1,
 };
 
 // Buttons
@@ -41,7 +45,8 @@ typedef enum {
 static uint32_t spi_write(void *handle, uint8_t *data, size_t len);
 static uint32_t gpio_write(void *handle, bool cs, bool dc);
 static void timer_delay(uint32_t ms);
-static void fractal_test(St7735Context *lcd);
+static void fractal_test(St7735Context *lcd, spi_queue_t *queue);
+static void frame_refresh_test(St7735Context *lcd, spi_t *spi);
 static Buttons_t scan_buttons(uint32_t timeout);
 
 int main(void) {
@@ -50,11 +55,17 @@ int main(void) {
   // Set the initial state of the LCD control pins.
   set_output_bit(GPIO_OUT, LcdDcPin, 0x0);
   set_output_bit(GPIO_OUT, LcdBlPin, 0x1);
-  set_output_bit(GPIO_OUT, LcdCsPin, 0x0);
+  set_output_bit(GPIO_OUT, LcdCsPin, 0x1);
 
-  // Init spi driver.
+  // Init spi driver, which drives chip select.
   spi_t spi;
-  spi_init(&spi, LCD_SPI, SpiSpeedHz);
+  spi_init(&spi, LCD_SPI, LCD_SPI_SPEED_HZ);
+  spi_set_cs(&spi, LcdSpiCs, true);
+
+  // Queue for sending to the LCD in the background.
+  rv_plic_init();
+  spi_queue_t spi_queue;
+  spi_queue_init(&spi_queue, &spi);
 
   // Reset LCD.
   set_output_bit(GPIO_OUT, LcdRstPin, 0x0);
@@ -92,6 +103,7 @@ int main(void) {
   const char *items[] = {
       "0. Fractal",
       "1. CoreMark",
+      "2. Frame refresh",
   };
   Menu_t main_menu = {
       .title          = "Main menu",
@@ -168,7 +180,7 @@ menu:
 boot:
   switch (selected) {
     case 0:
-      fractal_test(&lcd);
+      fractal_test(&lcd, &spi_queue);
       break;
 
     case 1:
@@ -193,6 +205,10 @@ boot:
       int coremark_main();
       coremark_main();
       break;
+
+    case 2:
+      frame_refresh_test(&lcd, &spi);
+      break;
   }
 
   // Wait until navigation button is clicked.
@@ -239,11 +255,87 @@ static Buttons_t scan_buttons(uint32_t timeout) {
   }
 }
 
-static void fractal_test(St7735Context *lcd) {
+static void fractal_test(St7735Context *lcd, spi_queue_t *queue) {
   fractal_mandelbrot_float(lcd);
   timer_delay(5000);
   fractal_mandelbrot_fixed(lcd);
   timer_delay(5000);
+
+  // Compare sending each row of the fractal with a blocking write against
+  // sending it from the SPI interrupt while the next row is computed.
+  uint32_t start = get_mcycle();
+  fractal_mandelbrot_float_rows(lcd, NULL);
+  uint32_t blocking_cycles = get_mcycle() - start;
+  timer_delay(2000);
+
+  start = get_mcycle();
+  fractal_mandelbrot_float_rows(lcd, queue);
+  uint32_t queued_cycles = get_mcycle() - start;
+  timer_delay(2000);
+
+  putstr("Fractal rows, blocking SPI: ");
+  putdec(blocking_cycles);
+  putstr(" cycles\nFractal rows, queued SPI:   ");
+  putdec(queued_cycles);
+  puts(" cycles");
+
+  // Show the cycle counts in hex on the screen too.
+  char line_buffer[21] = "blocking ";
+  lcd_st7735_clean(lcd);
+  lcd_println(lcd, "Cycles per frame", alined_center, (LCD_Point){.x = 0, .y = 30});
+  line_buffer[9 + snputhexn(line_buffer + 9, 8, blocking_cycles, 8)] = '\0';
+  lcd_println(lcd, line_buffer, alined_center, (LCD_Point){.x = 0, .y = 50});
+  strcpy(line_buffer, "queued   ");
+  line_buffer[9 + snputhexn(line_buffer + 9, 8, queued_cycles, 8)] = '\0';
+  lcd_println(lcd, line_buffer, alined_center, (LCD_Point){.x = 0, .y = 65});
+}
+
+// Full screen of BGR565 pixels, word aligned for the DMA engine, and the
+// descriptors for sending it.
+static uint16_t frame[128][160] __attribute__((aligned(4)));
+static dma_desc_t frame_descs[DMA_SPI_DESCS(sizeof(frame))];
+
+static void frame_refresh_test(St7735Context *lcd, spi_t *spi) {
+  for (int y = 0; y < 128; ++y) {
+    for (int x = 0; x < 160; ++x) {
+      uint16_t rgb = ((x * 31 / 159) << 11) | ((y * 63 / 127) << 5) | ((x + y) & 31);
+      frame[y][x]  = LCD_rgb565_to_bgr565((uint8_t *)&rgb);
+    }
+  }
+
+  // Compare refreshing the whole screen with the CPU filling the SPI FIFO
+  // against the DMA engine doing it.
+  LCD_rectangle rectangle = {.origin = {.x = 0, .y = 0}, .width = 160, .height = 128};
+  lcd_st7735_rgb565_start(lcd, rectangle);
+  uint32_t start = get_mcycle();
+  spi_tx(spi, (uint8_t *)frame, sizeof(frame));
+  spi_wait_idle(spi);
+  uint32_t cpu_cycles = get_mcycle() - start;
+  lcd_st7735_rgb565_finish(lcd);
+  timer_delay(2000);
+
+  lcd_st7735_rgb565_start(lcd, rectangle);
+  start           = get_mcycle();
+  uint32_t errors = dma_spi_tx(DEFAULT_DMA, spi, frame_descs, (uint8_t *)frame, sizeof(frame));
+  uint32_t dma_cycles = get_mcycle() - start;
+  lcd_st7735_rgb565_finish(lcd);
+  timer_delay(2000);
+
+  putstr("Frame refresh, CPU: ");
+  putdec(cpu_cycles);
+  putstr(" cycles\nFrame refresh, DMA: ");
+  putdec(dma_cycles);
+  putstr(" cycles");
+  puts(errors ? ", DMA error" : "");
+
+  char line_buffer[21] = "cpu ";
+  lcd_st7735_clean(lcd);
+  lcd_println(lcd, "Cycles per frame", alined_center, (LCD_Point){.x = 0, .y = 30});
+  line_buffer[4 + snputhexn(line_buffer + 4, 8, cpu_cycles, 8)] = '\0';
+  lcd_println(lcd, line_buffer, alined_center, (LCD_Point){.x = 0, .y = 50});
+  strcpy(line_buffer, "dma ");
+  line_buffer[4 + snputhexn(line_buffer + 4, 8, dma_cycles, 8)] = '\0';
+  lcd_println(lcd, line_buffer, alined_center, (LCD_Point){.x = 0, .y = 65});
 }
 
 static uint32_t spi_write(void *handle, uint8_t *data, size_t len) {
@@ -254,7 +346,7 @@ static uint32_t spi_write(void *handle, uint8_t *data, size_t len) {
 
 static uint32_t gpio_write(void *handle, bool cs, bool dc) {
   set_output_bit(GPIO_OUT, LcdDcPin, dc);
-  set_output_bit(GPIO_OUT, LcdCsPin, cs);
+  spi_set_cs(handle, LcdSpiCs, !cs);
   return 0;
 }
 
@@ -4,18 +4,33 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "sonata_system.h"
 #include "dev_access.h"
 #include "spi.h"
+#include "spi_sched.h"
 
 #define GPIO_BASE 0x80000000
 
+// Chip select outputs of the GPIO block, all active low and each ANDed with
+// the select of its SPI block: LCD (0), flash (12), Ethernet (13), R-Pi SPI0
+// (15, 16) and SPI1 (17-19), Arduino (20) and mikroBUS (21).
+#define GPIO_FLASH_CS_BIT 12
+#define GPIO_OTHER_CS ((1u << 0) | (1u << 13) | (0x7fu << 15))
+
+// Sets the flash chip select output to `csn`, leaving the other chip select
+// outputs high so that their SPI blocks alone decide what is selected. The
+// other GPIO outputs are driven low.
 void spi_csn(uint32_t csn) {
-  DEV_WRITE(GPIO_BASE, (csn & 1) << 12);
+  DEV_WRITE(GPIO_BASE, GPIO_OTHER_CS | ((csn & 1) << GPIO_FLASH_CS_BIT));
 }
 
+// Flash chip select line of the SPI block. Single operations are framed by the
+// block; commands made of several hold it between them.
+#define FLASH_CS 0x1
+
 uint8_t CmdReadJEDECId = 0x9f;
 uint8_t CmdWriteEnable = 0x06;
 uint8_t CmdSectorErase = 0x20;
@@ -23,22 +38,22 @@ uint8_t CmdReadStatusRegister1 = 0x05;
 uint8_t CmdPageProgram = 0x02;
 uint8_t CmdReadData = 0x03;
 
+// Flash clock rate, set to the fastest that works by spi_test.
+#define FLASH_MIN_SPEED_HZ (1000 * 1000)
+uint32_t flash_speed = FLASH_MIN_SPEED_HZ;
+
 void flash_erase_sector(uint32_t sector_idx) {
   uint8_t erase_cmd[4] = {CmdSectorErase, (sector_idx >> 16) & 0xff,
     (sector_idx >> 8) & 0xff, sector_idx & 0xff};
 
   spi_t spi;
-  spi_init(&spi, FLASH_SPI, 0 /* speed, currently unused */);
+  spi_init(&spi, FLASH_SPI, flash_speed);
 
-  spi_csn(0);
+  spi_set_cs(&spi, FLASH_CS, false);
   spi_tx(&spi, &CmdWriteEnable, 1);
-  spi_csn(1);
-
-  spi_csn(0);
   spi_tx(&spi, erase_cmd, 4);
-  spi_csn(1);
 
-  spi_csn(0);
+  spi_set_cs(&spi, FLASH_CS, true);
   spi_tx(&spi, &CmdReadStatusRegister1, 1);
 
   uint8_t status;
@@ -46,7 +61,7 @@ void flash_erase_sector(uint32_t sector_idx) {
     spi_rx(&spi, &status, 1);
   } while ((status & 0x1) == 1);
 
-  spi_csn(1);
+  spi_set_cs(&spi, FLASH_CS, false);
 }
 
 void flash_write_page(uint32_t page_idx, uint8_t* data) {
@@ -54,18 +69,17 @@ void flash_write_page(uint32_t page_idx, uint8_t* data) {
     (page_idx >> 8) & 0xff, page_idx & 0xff};
 
   spi_t spi;
-  spi_init(&spi, FLASH_SPI, 0 /* speed, currently unused */);
+  spi_init(&spi, FLASH_SPI, flash_speed);
 
-  spi_csn(0);
+  spi_set_cs(&spi, FLASH_CS, false);
   spi_tx(&spi, &CmdWriteEnable, 1);
-  spi_csn(1);
 
-  spi_csn(0);
+  spi_set_cs(&spi, FLASH_CS, true);
   spi_tx(&spi, write_cmd, 4);
   spi_tx(&spi, data, 256);
-  spi_csn(1);
+  spi_set_cs(&spi, FLASH_CS, false);
 
-  spi_csn(0);
+  spi_set_cs(&spi, FLASH_CS, true);
   spi_tx(&spi, &CmdReadStatusRegister1, 1);
 
   uint8_t status;
@@ -73,7 +87,7 @@ void flash_write_page(uint32_t page_idx, uint8_t* data) {
     spi_rx(&spi, &status, 1);
   } while ((status & 0x1) == 1);
 
-  spi_csn(1);
+  spi_set_cs(&spi, FLASH_CS, false);
 }
 
 void flash_read(uint32_t address, uint8_t* data_out, uint32_t len) {
@@ -81,24 +95,38 @@ void flash_read(uint32_t address, uint8_t* data_out, uint32_t len) {
     (address >> 8) & 0xff, address & 0xff};
 
   spi_t spi;
-  spi_init(&spi, FLASH_SPI, 0 /* speed, currently unused */);
+  spi_init(&spi, FLASH_SPI, flash_speed);
 
-  spi_csn(0);
+  spi_set_cs(&spi, FLASH_CS, true);
   spi_tx(&spi, read_cmd, 4);
   spi_rx(&spi, data_out, len);
-  spi_csn(1);
+  spi_set_cs(&spi, FLASH_CS, false);
+}
+
+void flash_read_jedec_id(spi_t *spi, uint8_t *jedec_data) {
+  spi_set_cs(spi, FLASH_CS, true);
+  spi_tx(spi, &CmdReadJEDECId, 1);
+  spi_rx(spi, jedec_data, 3);
+  spi_set_cs(spi, FLASH_CS, false);
+}
+
+bool flash_check_jedec_id(spi_t *spi, void *expected) {
+  uint8_t jedec_data[3];
+  flash_read_jedec_id(spi, jedec_data);
+  for (int i = 0; i < 3; ++i) {
+    if (jedec_data[i] != ((uint8_t *)expected)[i]) {
+      return false;
+    }
+  }
+  return true;
 }
 
 void spi_test() {
   uint8_t jedec_data[3];
 
   spi_t spi;
-  spi_init(&spi, FLASH_SPI, 0 /* speed, currently unused */);
-
-  spi_csn(0);
-  spi_tx(&spi, &CmdReadJEDECId, 1);
-  spi_rx(&spi, jedec_data, 3);
-  spi_csn(1);
+  spi_init(&spi, FLASH_SPI, FLASH_MIN_SPEED_HZ);
+  flash_read_jedec_id(&spi, jedec_data);
 
   putstr("Got JEDEC data ");
   puthex(jedec_data[0]);
@@ -107,6 +135,81 @@ void spi_test() {
   putchar(' ');
   puthex(jedec_data[2]);
   putstr("\r\n");
+
+  // Find the fastest clock at which the ID read at the slowest one comes back.
+  flash_speed = spi_sweep_speed(&spi, FLASH_SPI_SPEED_HZ, FLASH_MIN_SPEED_HZ, flash_check_jedec_id, jedec_data);
+  if (flash_speed == 0) {
+    flash_speed = FLASH_MIN_SPEED_HZ;
+  }
+  putstr("Using SPI clock ");
+  putdec(flash_speed);
+  putstr(" Hz\r\n");
+}
+
+// Bytes moved on each bus by the multi-bus benchmark.
+#define BENCH_LEN 4096
+
+// Buses used by the benchmark besides the flash. They only send, with both
+// their SPI block's chip select and the matching GPIO output left high, so
+// none of the devices on them are selected.
+static const spi_reg_t bench_tx_buses[] = {LCD_SPI, RPI_SPI0, RPI_SPI1, ARDUINO_SPI, MIKRO_BUS_SPI};
+#define BENCH_TX_BUSES (sizeof(bench_tx_buses) / sizeof(bench_tx_buses[0]))
+
+static uint8_t bench_rx[BENCH_LEN];
+static uint8_t bench_tx[BENCH_LEN];
+
+static void bench_report(const char *name, uint32_t bytes, uint32_t cycles) {
+  putstr(name);
+  putdec(cycles);
+  putstr(" cycles, ");
+  putdec(bytes / (cycles / 1000));
+  putstr(" bytes/kcycle\r\n");
+}
+
+// Reads flash while sending on each of the other buses, first one bus after
+// another with the blocking functions, then all at once with the scheduler.
+void spi_multi_bus_bench(void) {
+  spi_t flash;
+  spi_t tx_spis[BENCH_TX_BUSES];
+  spi_csn(1);
+  spi_init(&flash, FLASH_SPI, flash_speed);
+  for (uint32_t i = 0; i < BENCH_TX_BUSES; ++i) {
+    spi_init(&tx_spis[i], bench_tx_buses[i], flash_speed);
+    spi_set_cs(&tx_spis[i], 0, false);
+  }
+  uint8_t read_cmd[4] = {CmdReadData, 0, 0, 0};
+  uint32_t bytes      = (1 + BENCH_TX_BUSES) * BENCH_LEN;
+
+  uint32_t start = get_mcycle();
+  spi_set_cs(&flash, FLASH_CS, true);
+  spi_tx(&flash, read_cmd, 4);
+  spi_rx(&flash, bench_rx, BENCH_LEN);
+  spi_set_cs(&flash, FLASH_CS, false);
+  for (uint32_t i = 0; i < BENCH_TX_BUSES; ++i) {
+    spi_tx(&tx_spis[i], bench_tx, BENCH_LEN);
+  }
+  for (uint32_t i = 0; i < BENCH_TX_BUSES; ++i) {
+    spi_wait_idle(&tx_spis[i]);
+  }
+  bench_report("One bus at a time:  ", bytes, get_mcycle() - start);
+
+  spi_sched_t sched;
+  spi_sched_init(&sched);
+  spi_queue_t *flash_bus = spi_sched_add_bus(&sched, &flash);
+  spi_txn_t txns[1 + BENCH_TX_BUSES] = {0};
+
+  start = get_mcycle();
+  spi_set_cs(&flash, FLASH_CS, true);
+  spi_tx(&flash, read_cmd, 4);
+  txns[0] = (spi_txn_t){.cs = SPI_QUEUE_NO_CS, .rx_data = bench_rx, .len = BENCH_LEN};
+  spi_sched_submit(flash_bus, &txns[0]);
+  for (uint32_t i = 0; i < BENCH_TX_BUSES; ++i) {
+    txns[1 + i] = (spi_txn_t){.cs = SPI_QUEUE_NO_CS, .tx_data = bench_tx, .len = BENCH_LEN};
+    spi_sched_submit(spi_sched_add_bus(&sched, &tx_spis[i]), &txns[1 + i]);
+  }
+  spi_sched_run(&sched);
+  spi_set_cs(&flash, FLASH_CS, false);
+  bench_report("All buses together: ", bytes, get_mcycle() - start);
 }
 
 uint8_t write_data[256];
@@ -117,6 +220,7 @@ int main(void) {
     write_data[i] = i;
   }
 
+  // Leave the flash chip select to the SPI block.
   spi_csn(1);
   uart_init(DEFAULT_UART);
   putstr("Hello world\r\n");
@@ -140,6 +244,8 @@ int main(void) {
     putstr("\r\n");
   }
 
+  spi_multi_bus_bench();
+
   return 0;
 }
 
@@ -0,0 +1,177 @@
+#!/usr/bin/env python
+# Copyright lowRISC Contributors.
+# SPDX-License-Identifier: Apache-2.0
+
+"""Sonata Boot Image Compressor
+
+Rewrites a 32-bit ELF executable so that the file data of each loadable
+segment is stored as a raw LZ4 block, which the Sonata boot loader
+decompresses while streaming it from flash. Compressed segments are marked
+with the PF_SONATA_LZ4 program header flag and their p_filesz becomes the
+compressed size. Segments that do not shrink are stored unchanged.
+
+Section headers are dropped from the output as the segment data moves, so
+run this on the image being flashed rather than the one used for debugging.
+"""
+
+import argparse
+import struct
+import sys
+from pathlib import Path
+
+PT_LOAD: int = 1
+PT_PHDR: int = 6
+PF_SONATA_LZ4: int = 0x0010_0000
+
+EHDR_FORMAT: str = "<16sHHIIIIIHHHHHH"
+PHDR_FORMAT: str = "<IIIIIIII"
+
+# Constraints from the LZ4 block format specification.
+MIN_MATCH: int = 4
+LAST_LITERALS: int = 5
+MF_LIMIT: int = 12
+MAX_OFFSET: int = 0xFFFF
+HASH_BITS: int = 16
+
+
+def _write_length(out: bytearray, length: int) -> None:
+    """Emit the extra bytes of a literal or match length above 14."""
+    length -= 15
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def _write_sequence(
+    out: bytearray, literals: bytes, offset: int, match_len: int
+) -> None:
+    lit_nibble = min(len(literals), 15)
+    if offset == 0:
+        match_nibble = 0
+    else:
+        match_nibble = min(match_len - MIN_MATCH, 15)
+    out.append((lit_nibble << 4) | match_nibble)
+    if lit_nibble == 15:
+        _write_length(out, len(literals))
+    out += literals
+    if offset == 0:
+        return
+    out += struct.pack("<H", offset)
+    if match_nibble == 15:
+        _write_length(out, match_len - MIN_MATCH)
+
+
+def lz4_compress(data: bytes) -> bytes:
+    """Compress `data` into a raw LZ4 block using greedy matching."""
+    out = bytearray()
+    table: dict[int, int] = {}
+    anchor = 0
+    pos = 0
+    match_limit = len(data) - MF_LIMIT
+    while pos < match_limit:
+        key = int.from_bytes(data[pos : pos + MIN_MATCH], "little")
+        key = (key * 2654435761 >> (32 - HASH_BITS)) & ((1 << HASH_BITS) - 1)
+        candidate = table.get(key)
+        table[key] = pos
+        if (
+            candidate is None
+            or pos - candidate > MAX_OFFSET
+            or data[candidate : candidate + MIN_MATCH]
+            != data[pos : pos + MIN_MATCH]
+        ):
+            pos += 1
+            continue
+
+        # Extend the match, leaving the final bytes of the block as literals.
+        match_end = pos + MIN_MATCH
+        end_limit = len(data) - LAST_LITERALS
+        while (
+            match_end < end_limit
+            and data[match_end] == data[candidate + match_end - pos]
+        ):
+            match_end += 1
+
+        _write_sequence(out, data[anchor:pos], pos - candidate, match_end - pos)
+        pos = match_end
+        anchor = pos
+
+    _write_sequence(out, data[anchor:], 0, 0)
+    return bytes(out)
+
+
+def compress_elf(image: bytes) -> tuple[bytes, int, int]:
+    """Compress the loadable segments of an ELF image.
+
+    Returns the new image and the total size of the segment data before and
+    after compression.
+    """
+    ehdr = list(struct.unpack_from(EHDR_FORMAT, image))
+    e_ident, e_phoff, e_phentsize, e_phnum = ehdr[0], ehdr[5], ehdr[9], ehdr[10]
+    if e_ident[:4] != b"\x7fELF" or e_ident[4] != 1:
+        raise ValueError("not a 32-bit ELF file")
+    if e_phentsize != struct.calcsize(PHDR_FORMAT):
+        raise ValueError("unexpected program header size")
+
+    phdrs = [
+        list(struct.unpack_from(PHDR_FORMAT, image, e_phoff + i * e_phentsize))
+        for i in range(e_phnum)
+    ]
+
+    # Lay the output out as ELF header, program headers, then segment data.
+    data_offset = struct.calcsize(EHDR_FORMAT) + e_phnum * e_phentsize
+    out_data = bytearray()
+    original_size = 0
+    for phdr in phdrs:
+        p_type, p_offset, p_filesz = phdr[0], phdr[1], phdr[4]
+        if p_type == PT_PHDR:
+            phdr[1] = struct.calcsize(EHDR_FORMAT)
+            continue
+        if p_filesz == 0:
+            phdr[1] = 0
+            continue
+        data = image[p_offset : p_offset + p_filesz]
+        if p_type == PT_LOAD:
+            original_size += p_filesz
+            compressed = lz4_compress(data)
+            if len(compressed) < p_filesz:
+                data = compressed
+                phdr[4] = len(compressed)
+                phdr[6] |= PF_SONATA_LZ4
+        phdr[1] = data_offset + len(out_data)
+        out_data += data
+
+    # Point at the new program header table and drop the section headers.
+    ehdr[5] = struct.calcsize(EHDR_FORMAT)
+    ehdr[6] = 0
+    ehdr[11] = 0
+    ehdr[12] = 0
+    ehdr[13] = 0
+
+    out = bytearray(struct.pack(EHDR_FORMAT, *ehdr))
+    for phdr in phdrs:
+        out += struct.pack(PHDR_FORMAT, *phdr)
+    out += out_data
+    compressed_size = sum(phdr[4] for phdr in phdrs if phdr[0] == PT_LOAD)
+    return bytes(out), original_size, compressed_size
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", type=Path, help="ELF file to compress")
+    parser.add_argument("output", type=Path, help="compressed ELF file")
+    args = parser.parse_args()
+
+    try:
+        image, original, compressed = compress_elf(args.input.read_bytes())
+    except (ValueError, struct.error) as err:
+        print(f"{args.input}: {err}", file=sys.stderr)
+        return 1
+
+    args.output.write_bytes(image)
+    print(f"Segment data compressed from {original} to {compressed} bytes")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
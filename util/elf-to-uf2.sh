@@ -1,6 +1,31 @@
 #!/bin/sh
 # Copyright lowRISC Contributors.
 # SPDX-License-Identifier: Apache-2.0
+#
+# Usage: elf-to-uf2.sh <elf> [--compress] [--image]
+# --compress LZ4 compresses the loadable segments for the boot loader.
+# --image converts the ELF into a Sonata boot image (load map) before packing.
 set -ue
-llvm-strip "$1" -o "$1.strip"
-uf2conv "$1.strip" -f0x6CE29E60 -co "$1.uf2"
+elf="$1"
+shift
+compress=""
+image=""
+for arg in "$@"; do
+  case "$arg" in
+    --compress) compress="--compress" ;;
+    --image) image="1" ;;
+    *) echo "Unknown option: $arg" >&2; exit 1 ;;
+  esac
+done
+
+util="$(dirname "$0")"
+llvm-strip "$elf" -o "$elf.strip"
+if [ -n "$image" ]; then
+  python3 "$util/make_boot_image.py" $compress "$elf.strip" "$elf.img"
+  uf2conv "$elf.img" -f0x6CE29E60 -co "$elf.uf2"
+else
+  if [ -n "$compress" ]; then
+    python3 "$util/compress_elf.py" "$elf.strip" "$elf.strip"
+  fi
+  uf2conv "$elf.strip" -f0x6CE29E60 -co "$elf.uf2"
+fi
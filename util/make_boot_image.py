@@ -0,0 +1,214 @@
+#!/usr/bin/env python
+# Copyright lowRISC Contributors.
+# SPDX-License-Identifier: Apache-2.0
+
+"""Sonata Boot Image Generator
+
+Converts a 32-bit ELF executable into a Sonata boot image: a fixed size header
+with the entry point and a table of loadable segments, followed by the segment
+data in table order. The boot loader reads the header with a single flash
+transfer and then streams all of the segments back to back, rather than
+walking the ELF program headers. Each segment carries a CRC-32 and the image a
+SHA-256 of the stored data, which the loader checks as it streams them.
+Large read-only HyperRAM segments can instead be marked lazy, leaving the
+loaded software to fetch them from flash as it uses them. See
+sw/cheri/boot/boot_image.h.
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+import zlib
+from pathlib import Path
+
+from compress_elf import (
+    EHDR_FORMAT,
+    PF_SONATA_LZ4,
+    PHDR_FORMAT,
+    PT_LOAD,
+    lz4_compress,
+)
+
+IMAGE_MAGIC: int = 0x4D494253  # "SBIM"
+IMAGE_VERSION: int = 4
+MAX_SEGMENTS: int = 8
+
+PF_W: int = 0x2
+PF_SONATA_LAZY: int = 0x00200000
+HYPERRAM_ADDRESS: int = 0x40000000
+HYPERRAM_BOUNDS: int = 0x00100000
+# Must match BootInfoBounds in sw/cheri/common/boot-info.hh. The boot loader
+# keeps the top of HyperRAM for the BootInfo it hands to the application.
+BOOT_INFO_BOUNDS: int = 0x400
+# Must match LazyMaxSegments and LazyChunkSize in sw/cheri/common/boot-info.hh.
+MAX_LAZY_SEGMENTS: int = 4
+LAZY_CHUNK_SIZE: int = 4096
+
+# The header CRC covers everything after the `magic` and `header_crc` fields.
+HEADER_FORMAT: str = "<II"
+TABLE_FORMAT: str = "<HHII32s"
+SEGMENT_FORMAT: str = "<IIIIII"
+HEADER_SIZE: int = (
+    struct.calcsize(HEADER_FORMAT)
+    + struct.calcsize(TABLE_FORMAT)
+    + MAX_SEGMENTS * struct.calcsize(SEGMENT_FORMAT)
+)
+
+
+def lazy_chunk_crcs(vaddr: int, contents: bytes) -> bytes:
+    """Return the CRC-32 of the part of `contents` in each chunk it overlaps.
+
+    The chunks are aligned in memory rather than to the segment, as that is
+    the unit in which the loaded software fills lazy segments in.
+    """
+    crcs = bytearray()
+    first = vaddr & ~(LAZY_CHUNK_SIZE - 1)
+    for chunk in range(first, vaddr + len(contents), LAZY_CHUNK_SIZE):
+        low = max(chunk, vaddr) - vaddr
+        high = min(chunk + LAZY_CHUNK_SIZE, vaddr + len(contents)) - vaddr
+        crcs += struct.pack("<I", zlib.crc32(contents[low:high]))
+    return bytes(crcs)
+
+
+def make_boot_image(
+    elf: bytes,
+    compress: bool,
+    generation: int | None = None,
+    lazy_min_size: int | None = None,
+) -> bytes:
+    """Build a boot image from the PT_LOAD segments of an ELF executable.
+
+    The generation defaults to the CRC-32 of the segment data, so that any
+    change to the image contents invalidates copies kept by a warm boot.
+
+    Read-only HyperRAM segments of at least `lazy_min_size` bytes are marked
+    lazy. Their data is stored uncompressed after that of the other segments,
+    so that the loader's stream is not broken up, and is left out of the
+    SHA-256 as the loader does not read it. Each is followed by the CRC-32s
+    of its chunks.
+    """
+    ehdr = struct.unpack_from(EHDR_FORMAT, elf)
+    e_ident, e_entry, e_phoff = ehdr[0], ehdr[4], ehdr[5]
+    e_phentsize, e_phnum = ehdr[9], ehdr[10]
+    if e_ident[:4] != b"\x7fELF" or e_ident[4] != 1:
+        raise ValueError("not a 32-bit ELF file")
+    if e_phentsize != struct.calcsize(PHDR_FORMAT):
+        raise ValueError("unexpected program header size")
+
+    segments: list[tuple[int, int, int, bytes]] = []
+    lazy_count = 0
+    for i in range(e_phnum):
+        phdr = struct.unpack_from(PHDR_FORMAT, elf, e_phoff + i * e_phentsize)
+        p_type, p_offset, p_vaddr = phdr[0], phdr[1], phdr[2]
+        p_filesz, p_memsz, p_flags = phdr[4], phdr[5], phdr[6]
+        if p_type != PT_LOAD:
+            continue
+        contents = elf[p_offset : p_offset + p_filesz]
+        if (
+            lazy_min_size is not None
+            and p_memsz >= lazy_min_size
+            and lazy_count < MAX_LAZY_SEGMENTS
+            and not p_flags & (PF_W | PF_SONATA_LZ4)
+            and HYPERRAM_ADDRESS <= p_vaddr
+            and p_vaddr + p_memsz
+            <= HYPERRAM_ADDRESS + HYPERRAM_BOUNDS - BOOT_INFO_BOUNDS
+        ):
+            p_flags |= PF_SONATA_LAZY
+            lazy_count += 1
+        elif compress and p_filesz != 0 and not p_flags & PF_SONATA_LZ4:
+            compressed = lz4_compress(contents)
+            if len(compressed) < len(contents):
+                contents = compressed
+                p_flags |= PF_SONATA_LZ4
+        segments.append((p_vaddr, p_memsz, p_flags, contents))
+
+    if len(segments) > MAX_SEGMENTS:
+        raise ValueError(f"more than {MAX_SEGMENTS} loadable segments")
+
+    # The loader streams the data of the other segments back to back, so the
+    # lazy segments go after it.
+    order = sorted(
+        range(len(segments)), key=lambda i: bool(segments[i][2] & PF_SONATA_LAZY)
+    )
+    offsets = [0] * len(segments)
+    data = bytearray()
+    streamed = 0
+    for i in order:
+        p_vaddr, _, p_flags, contents = segments[i]
+        offsets[i] = HEADER_SIZE + len(data)
+        data += contents
+        if p_flags & PF_SONATA_LAZY:
+            data += bytes(-len(data) % 4)
+            data += lazy_chunk_crcs(p_vaddr, contents)
+        else:
+            streamed = len(data)
+    digest = hashlib.sha256(data[:streamed]).digest()
+
+    table = bytearray()
+    for i, (p_vaddr, p_memsz, p_flags, contents) in enumerate(segments):
+        table += struct.pack(
+            SEGMENT_FORMAT,
+            offsets[i],
+            p_vaddr,
+            len(contents),
+            p_memsz,
+            p_flags,
+            zlib.crc32(contents),
+        )
+
+    if generation is None:
+        generation = zlib.crc32(data)
+    table[0:0] = struct.pack(
+        TABLE_FORMAT,
+        IMAGE_VERSION,
+        len(segments),
+        e_entry,
+        generation,
+        digest,
+    )
+    table += bytes(HEADER_SIZE - struct.calcsize(HEADER_FORMAT) - len(table))
+
+    header = struct.pack(HEADER_FORMAT, IMAGE_MAGIC, zlib.crc32(table))
+    return header + table + data
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", type=Path, help="ELF file to convert")
+    parser.add_argument("output", type=Path, help="boot image to write")
+    parser.add_argument(
+        "--compress",
+        action="store_true",
+        help="LZ4 compress segments that shrink",
+    )
+    parser.add_argument(
+        "--generation",
+        type=lambda x: int(x, 0),
+        help="image generation (default: CRC-32 of the segment data)",
+    )
+    parser.add_argument(
+        "--lazy-min-size",
+        type=lambda x: int(x, 0),
+        help="load read-only HyperRAM segments of at least this many bytes "
+        "on demand rather than at boot",
+    )
+    args = parser.parse_args()
+
+    try:
+        image = make_boot_image(
+            args.input.read_bytes(),
+            args.compress,
+            args.generation,
+            args.lazy_min_size,
+        )
+    except (ValueError, struct.error) as err:
+        print(f"{args.input}: {err}", file=sys.stderr)
+        return 1
+
+    args.output.write_bytes(image)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
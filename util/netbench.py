@@ -0,0 +1,142 @@
+#!/usr/bin/env python
+# Copyright lowRISC Contributors.
+# SPDX-License-Identifier: Apache-2.0
+
+"""Sonata Network Benchmark Peer
+
+Drives the benchmark servers of the Ethernet demo's `ethernet_bench` build
+from the host, over a board's network or the TAP device of the simulator, and
+prints the rate seen by the host once a second:
+
+- udp-sink: asks the UDP chargen port to send datagrams and counts them.
+- udp-blast: sends datagrams to the UDP discard port as fast as it can.
+- tcp-discard: sends to the TCP discard port.
+- tcp-chargen: receives from the TCP chargen port.
+
+The board prints its own receive and transmit rates and how idle its CPU was.
+"""
+
+import argparse
+import socket
+import sys
+import time
+
+DISCARD_PORT: int = 9
+CHARGEN_PORT: int = 19
+DATAGRAM_LEN: int = 1472
+# Matches how long the board keeps sending after each UDP chargen request.
+BLAST_SECONDS: float = 10.0
+REPORT_SECONDS: float = 1.0
+
+
+class RateReporter:
+    """Prints the data rate once a second and in total."""
+
+    def __init__(self) -> None:
+        self.start = self.last = time.monotonic()
+        self.total = self.since_last = 0
+        self.packets = 0
+
+    def add(self, length: int) -> None:
+        self.total += length
+        self.since_last += length
+        self.packets += 1
+        now = time.monotonic()
+        if now - self.last >= REPORT_SECONDS:
+            self._print("", self.since_last, now - self.last)
+            self.last = now
+            self.since_last = 0
+
+    def finish(self) -> None:
+        self._print("Total: ", self.total, time.monotonic() - self.start)
+
+    def _print(self, prefix: str, length: int, seconds: float) -> None:
+        print(f"{prefix}{length * 8 / seconds / 1e6:.2f} Mbit/s")
+
+
+def udp_sink(host: str, seconds: float) -> None:
+    rates = RateReporter()
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as sock:
+        sock.settimeout(1.0)
+        end = time.monotonic() + seconds
+        request = 0.0
+        while time.monotonic() < end:
+            # Renew the request before the board stops sending.
+            if time.monotonic() >= request:
+                sock.sendto(b"x", (host, CHARGEN_PORT))
+                request = time.monotonic() + BLAST_SECONDS / 2
+            try:
+                rates.add(len(sock.recv(2048)))
+            except socket.timeout:
+                pass
+    rates.finish()
+    print(f"{rates.packets} datagrams received")
+
+
+def udp_blast(host: str, seconds: float) -> None:
+    rates = RateReporter()
+    data = bytes(DATAGRAM_LEN)
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as sock:
+        sock.connect((host, DISCARD_PORT))
+        end = time.monotonic() + seconds
+        while time.monotonic() < end:
+            try:
+                rates.add(sock.send(data))
+            except ConnectionRefusedError:
+                # An ICMP error from an earlier datagram; keep sending.
+                pass
+    rates.finish()
+    print(f"{rates.packets} datagrams sent")
+
+
+def tcp_discard(host: str, seconds: float) -> None:
+    rates = RateReporter()
+    data = bytes(64 * 1024)
+    with socket.create_connection((host, DISCARD_PORT)) as sock:
+        end = time.monotonic() + seconds
+        while time.monotonic() < end:
+            rates.add(sock.send(data))
+    rates.finish()
+
+
+def tcp_chargen(host: str, seconds: float) -> None:
+    rates = RateReporter()
+    with socket.create_connection((host, CHARGEN_PORT)) as sock:
+        end = time.monotonic() + seconds
+        while time.monotonic() < end:
+            data = sock.recv(64 * 1024)
+            if not data:
+                break
+            rates.add(len(data))
+    rates.finish()
+
+
+MODES = {
+    "udp-sink": udp_sink,
+    "udp-blast": udp_blast,
+    "tcp-discard": tcp_discard,
+    "tcp-chargen": tcp_chargen,
+}
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("host", help="address of the board")
+    parser.add_argument("mode", choices=MODES.keys(), help="what to measure")
+    parser.add_argument(
+        "-t", "--time", type=float, default=10.0, help="seconds to run for"
+    )
+    args = parser.parse_args()
+
+    try:
+        MODES[args.mode](args.host, args.time)
+    except KeyboardInterrupt:
+        pass
+    except OSError as err:
+        print(f"{args.host}: {err}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())